@@ -0,0 +1,146 @@
+/*
+ * Minimal benchmark harness shared by the bench_*.c programs.
+ *
+ * Each measurement prints one JSON object per line so that results from
+ * different programs and versions can be concatenated and compared by scripts:
+ *
+ *   {"bench":"generate/counter_inc","build":"default","threads":1,
+ *    "ops":20480000,"ns_per_op":3.21,"ops_per_sec":311526479,
+ *    "cycles_per_op":10.5,"instructions_per_op":38.0,
+ *    "cache_misses_per_op":0.0001}
+ *
+ * On Linux, CPU cycles, retired instructions, and cache misses are counted in
+ * user space through perf_event_open(2); the counters are inherited by threads
+ * created after bench_begin(). The corresponding fields are null where the
+ * counters are unavailable, e.g., in virtual machines or when
+ * /proc/sys/kernel/perf_event_paranoid forbids them.
+ *
+ * The "build" field is the `BENCH_BUILD` macro, which the Makefile sets to the
+ * instruction set a SIMD variant is compiled for, e.g., "avx2".
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define BENCH_N_COUNTERS 3
+
+#ifndef BENCH_BUILD
+#define BENCH_BUILD "default"
+#endif
+
+typedef struct {
+  /** perf_event file descriptors, or -1 where unavailable. */
+  int fds[BENCH_N_COUNTERS];
+
+  /** CLOCK_MONOTONIC time when the measurement started in seconds. */
+  double t0;
+} bench_t;
+
+static inline double bench_now(void) {
+  struct timespec tp;
+  clock_gettime(CLOCK_MONOTONIC, &tp);
+  return (double)tp.tv_sec + (double)tp.tv_nsec * 1e-9;
+}
+
+/** Opens the performance counters and starts a measurement. */
+static inline void bench_begin(bench_t *b) {
+  for (int i = 0; i < BENCH_N_COUNTERS; i++) {
+    b->fds[i] = -1;
+  }
+#ifdef __linux__
+  static const uint64_t CONFIGS[BENCH_N_COUNTERS] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES};
+  for (int i = 0; i < BENCH_N_COUNTERS; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = CONFIGS[i];
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    b->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+  for (int i = 0; i < BENCH_N_COUNTERS; i++) {
+    if (b->fds[i] >= 0) {
+      ioctl(b->fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(b->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+  b->t0 = bench_now();
+}
+
+/**
+ * Prints a result.
+ *
+ * @param name       Benchmark name.
+ * @param n_threads  Number of threads that shared the `n_ops` operations.
+ * @param n_ops      Total number of operations performed.
+ * @param elapsed    Elapsed time in seconds.
+ * @param counters   Array of `BENCH_N_COUNTERS` counter values, negative for
+ *                   unavailable counters, or NULL if none is available.
+ */
+static inline void bench_report(const char *name, int n_threads, uint64_t n_ops,
+                                double elapsed, const int64_t *counters) {
+  char fields[BENCH_N_COUNTERS][32];
+  for (int i = 0; i < BENCH_N_COUNTERS; i++) {
+    if (counters == NULL || counters[i] < 0) {
+      strcpy(fields[i], "null");
+    } else {
+      snprintf(fields[i], sizeof(fields[i]), "%.4f",
+               (double)counters[i] / (double)n_ops);
+    }
+  }
+
+  printf("{\"bench\":\"%s\",\"build\":\"%s\",\"threads\":%d,\"ops\":%llu,"
+         "\"ns_per_op\":%.3f,\"ops_per_sec\":%.0f,\"cycles_per_op\":%s,"
+         "\"instructions_per_op\":%s,\"cache_misses_per_op\":%s}\n",
+         name, BENCH_BUILD, n_threads, (unsigned long long)n_ops,
+         elapsed / (double)n_ops * 1e9, (double)n_ops / elapsed, fields[0],
+         fields[1], fields[2]);
+  fflush(stdout);
+}
+
+/**
+ * Stops a measurement and prints the result.
+ *
+ * @param b          Measurement started by bench_begin().
+ * @param name       Benchmark name.
+ * @param n_threads  Number of threads that shared the `n_ops` operations.
+ * @param n_ops      Total number of operations performed.
+ */
+static inline void bench_end(bench_t *b, const char *name, int n_threads,
+                             uint64_t n_ops) {
+  double elapsed = bench_now() - b->t0;
+  int64_t counters[BENCH_N_COUNTERS];
+  for (int i = 0; i < BENCH_N_COUNTERS; i++) {
+    counters[i] = -1;
+#ifdef __linux__
+    if (b->fds[i] >= 0) {
+      uint64_t count;
+      ioctl(b->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+      if (read(b->fds[i], &count, sizeof(count)) == sizeof(count)) {
+        counters[i] = (int64_t)count;
+      }
+      close(b->fds[i]);
+    }
+#endif
+  }
+  bench_report(name, n_threads, n_ops, elapsed, counters);
+}
+
+#endif /* #ifndef BENCH_H */
@@ -0,0 +1,57 @@
+/*
+ * Compares the cost of reading each clock source of impl/uuidv7_clock.h and
+ * the resulting per-UUID latency of a clock read followed by
+ * uuidv7_generate().
+ */
+#include "uuidv7.h"
+#include "uuidv7_clock.h"
+
+#include "bench.h"
+
+#define N_CALLS 10000000
+
+static const struct {
+  const char *name;
+  uint64_t (*now_ms)(void);
+} CLOCKS[] = {
+    {"realtime", uuidv7_clock_realtime_ms},
+    {"coarse", uuidv7_clock_coarse_ms},
+    {"tsc", uuidv7_clock_tsc_ms},
+    {"ticker", uuidv7_clock_ticker_ms},
+};
+
+int main(void) {
+  static uint8_t rand_bytes[10 * 1024];
+  uint32_t x = 0x12345678;
+  for (size_t i = 0; i < sizeof(rand_bytes); i++) {
+    x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+    rand_bytes[i] = x >> 24;
+  }
+
+  for (size_t i = 0; i < sizeof(CLOCKS) / sizeof(CLOCKS[0]); i++) {
+    uint64_t (*now_ms)(void) = CLOCKS[i].now_ms;
+    volatile uint64_t sink = now_ms(); // warm up and start the ticker
+    char name[64];
+
+    bench_t b;
+    bench_begin(&b);
+    for (int j = 0; j < N_CALLS; j++) {
+      sink = now_ms();
+    }
+    snprintf(name, sizeof(name), "clock_%s/read", CLOCKS[i].name);
+    bench_end(&b, name, 1, N_CALLS);
+
+    uint8_t uuid[16], uuid_prev[16];
+    uuidv7_generate(uuid_prev, now_ms(), rand_bytes, NULL);
+    bench_begin(&b);
+    for (int j = 0; j < N_CALLS; j++) {
+      uuidv7_generate(uuid, now_ms(), &rand_bytes[10 * (j & 1023)], uuid_prev);
+      memcpy(uuid_prev, uuid, 16);
+    }
+    snprintf(name, sizeof(name), "clock_%s/generate", CLOCKS[i].name);
+    bench_end(&b, name, 1, N_CALLS);
+    sink = uuid_prev[15];
+    (void)sink;
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Measures uuidv7_codec.h on sequences of 1M UUIDs.
+ *
+ * "counter_inc" generates about 1000 UUIDs per millisecond, as a busy
+ * generator does, and "new_timestamp" advances the timestamp on every UUID. The
+ * encoded size per UUID is printed to stderr.
+ */
+#include "uuidv7.h"
+#include "uuidv7_codec.h"
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+#define N_UUIDS (1 << 20)
+#define N_ROUNDS 20
+
+static uint8_t uuids[16 * N_UUIDS];
+static uint8_t blocks[UUIDV7_CODEC_BLOCK_SIZE *
+                      UUIDV7_CODEC_MAX_BLOCKS(N_UUIDS)];
+static uint8_t decoded[16 * UUIDV7_CODEC_MAX_PER_BLOCK];
+
+static volatile uint8_t sink = 0;
+
+static void bench_codec(const char *label, int ts_step_every) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      rand_bytes[j] = (uint8_t)rand();
+    }
+    unix_ts_ms += i % ts_step_every == 0;
+    uuidv7_generate(&uuids[16 * i], unix_ts_ms, rand_bytes,
+                    i > 0 ? &uuids[16 * (i - 1)] : NULL);
+  }
+
+  char name[64];
+  size_t n_blocks = 0;
+  bench_t b;
+  snprintf(name, sizeof(name), "codec/encode/%s", label);
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    n_blocks = uuidv7_encode(uuids, N_UUIDS, blocks);
+    sink ^= blocks[UUIDV7_CODEC_BLOCK_SIZE * (n_blocks - 1) + 8];
+  }
+  bench_end(&b, name, 1, (uint64_t)N_UUIDS * N_ROUNDS);
+  fprintf(stderr, "%s: %.2f bytes/UUID\n", label,
+          (double)(n_blocks * UUIDV7_CODEC_BLOCK_SIZE) / N_UUIDS);
+
+  snprintf(name, sizeof(name), "codec/decode/%s", label);
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (size_t k = 0; k < n_blocks; k++) {
+      long n = uuidv7_decode_block(&blocks[UUIDV7_CODEC_BLOCK_SIZE * k],
+                                   decoded);
+      sink ^= decoded[16 * (n - 1) + 15];
+    }
+  }
+  bench_end(&b, name, 1, (uint64_t)N_UUIDS * N_ROUNDS);
+}
+
+int main(void) {
+  bench_codec("counter_inc", 1000);
+  bench_codec("new_timestamp", 1);
+  return 0;
+}
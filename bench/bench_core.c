@@ -0,0 +1,230 @@
+/*
+ * Measures the primitives of uuidv7.h in a single thread.
+ *
+ * The generator benchmarks run with two status mixes: "counter_inc" passes the
+ * same timestamp to every call so that almost all UUIDs increment the counter,
+ * while "new_timestamp" advances the timestamp on every call so that all UUIDs
+ * start a new counter and consume 10 random bytes.
+ */
+#include "uuidv7.h"
+
+#include "bench.h"
+
+#define N_UUIDS 1024
+#define N_ROUNDS 20000
+#define N_OPS ((uint64_t)N_UUIDS * N_ROUNDS)
+
+static uint8_t rand_bytes[10 * N_UUIDS];
+static uint8_t uuids[N_UUIDS][16];
+static char text[N_UUIDS * 37];
+static uuidv7_words_t words[N_UUIDS];
+
+static volatile uint8_t sink = 0;
+
+static void bench_generate(const char *name, uint64_t ts_step) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  uint8_t prev[16] = {0};
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    size_t n_rand_consumed = 0;
+    const uint8_t *p = prev;
+    for (int i = 0; i < N_UUIDS; i++) {
+      int8_t status = uuidv7_generate(uuids[i], unix_ts_ms,
+                                      &rand_bytes[n_rand_consumed], p);
+      n_rand_consumed += uuidv7_status_n_rand_consumed(status);
+      p = uuids[i];
+      unix_ts_ms += ts_step;
+    }
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, name, 1, N_OPS);
+}
+
+static void bench_gen_next(const char *name, uint64_t ts_step) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  uint8_t prev[16] = {0};
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    uuidv7_gen_t gen;
+    uuidv7_gen_init(&gen, prev);
+    uuidv7_gen_set_rand(&gen, rand_bytes, sizeof(rand_bytes));
+    for (int i = 0; i < N_UUIDS; i++) {
+      uuidv7_gen_next(&gen, unix_ts_ms, uuids[i]);
+      unix_ts_ms += ts_step;
+    }
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, name, 1, N_OPS);
+}
+
+static void bench_generate_batch(void) {
+  const uint64_t unix_ts_ms = 0x17f22e279b0;
+  uint8_t prev[16] = {0};
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    uuidv7_generate_batch(uuids[0], N_UUIDS, unix_ts_ms, rand_bytes,
+                          sizeof(rand_bytes), prev, NULL);
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, "generate_batch/counter_inc", 1, N_OPS);
+}
+
+static void bench_to_string(void) {
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (int i = 0; i < N_UUIDS; i++) {
+      uuidv7_to_string(uuids[i], &text[37 * i]);
+    }
+    sink ^= text[37 * N_UUIDS - 2];
+  }
+  bench_end(&b, "to_string", 1, N_OPS);
+
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    uuidv7_to_string_bulk(uuids[0], N_UUIDS, text, '\0');
+    sink ^= text[37 * N_UUIDS - 2];
+  }
+  bench_end(&b, "to_string_bulk", 1, N_OPS);
+}
+
+static void bench_from_string(void) {
+  uuidv7_to_string_bulk(uuids[0], N_UUIDS, text, '\0');
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (int i = 0; i < N_UUIDS; i++) {
+      uuidv7_from_string(&text[37 * i], uuids[i]);
+    }
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, "from_string", 1, N_OPS);
+
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    uuidv7_from_string_bulk(text, N_UUIDS, '\0', uuids[0], NULL);
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, "from_string_bulk", 1, N_OPS);
+}
+
+/** Measures the word representation against the byte-oriented functions. */
+static void bench_words(void) {
+  static const char *const GENERATE_NAMES[] = {
+      "words/generate/counter_inc", "words/generate/new_timestamp"};
+  for (uint64_t ts_step = 0; ts_step < 2; ts_step++) {
+    uint64_t unix_ts_ms = 0x17f22e279b0;
+    bench_t b;
+    bench_begin(&b);
+    for (int r = 0; r < N_ROUNDS; r++) {
+      size_t n_rand_consumed = 0;
+      const uuidv7_words_t *p = NULL;
+      for (int i = 0; i < N_UUIDS; i++) {
+        int8_t status = uuidv7_generate_words(
+            &words[i], unix_ts_ms, &rand_bytes[n_rand_consumed], p);
+        n_rand_consumed += uuidv7_status_n_rand_consumed(status);
+        p = &words[i];
+        unix_ts_ms += ts_step;
+      }
+      sink ^= (uint8_t)words[N_UUIDS - 1].lo;
+    }
+    bench_end(&b, GENERATE_NAMES[ts_step], 1, N_OPS);
+  }
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (int i = 0; i < N_UUIDS; i++) {
+      uuidv7_words_to_string(&words[i], &text[37 * i]);
+    }
+    sink ^= text[37 * N_UUIDS - 2];
+  }
+  bench_end(&b, "words/to_string", 1, N_OPS);
+
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (int i = 0; i < N_UUIDS; i++) {
+      uuidv7_words_from_string(&text[37 * i], &words[i]);
+    }
+    sink ^= (uint8_t)words[N_UUIDS - 1].lo;
+  }
+  bench_end(&b, "words/from_string", 1, N_OPS);
+
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (int i = 0; i < N_UUIDS; i++) {
+      uuidv7_words_from_bytes(uuids[i], &words[i]);
+    }
+    sink ^= (uint8_t)words[N_UUIDS - 1].lo;
+  }
+  bench_end(&b, "words/from_bytes", 1, N_OPS);
+}
+
+static void bench_validate(void) {
+  static uint8_t bitmap[N_UUIDS / 8];
+  const uint64_t min_timestamp = 0x17f22e279b0, max_timestamp = UINT64_MAX;
+  uuidv7_generate_batch(uuids[0], N_UUIDS, min_timestamp, rand_bytes,
+                        sizeof(rand_bytes), NULL, NULL);
+  uuidv7_to_string_bulk(uuids[0], N_UUIDS, text, '\n');
+
+  // one string at a time, as a caller would do without the bulk validator
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    size_t n_valid = 0;
+    for (int i = 0; i < N_UUIDS; i++) {
+      uint8_t uuid[16];
+      char string[37];
+      memcpy(string, &text[37 * i], 36);
+      string[36] = '\0';
+      n_valid += uuidv7_from_string(string, uuid) == 0 &&
+                 (uuid[6] & 0xf0) == 0x70 && (uuid[8] & 0xc0) == 0x80 &&
+                 uuidv7_get_timestamp(uuid) >= min_timestamp &&
+                 (i == 0 || memcmp(uuids[i - 1], uuid, 16) < 0);
+      memcpy(uuids[i], uuid, 16);
+    }
+    sink ^= (uint8_t)n_valid;
+  }
+  bench_end(&b, "validate_string/one_by_one", 1, N_OPS);
+
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    sink ^= (uint8_t)uuidv7_validate_string_bulk(
+        text, N_UUIDS, '\n', min_timestamp, max_timestamp, 1, NULL, uuids[0],
+        bitmap);
+  }
+  bench_end(&b, "validate_string_bulk", 1, N_OPS);
+
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    sink ^= (uint8_t)uuidv7_validate_bulk(uuids[0], N_UUIDS, min_timestamp,
+                                          max_timestamp, 1, NULL, bitmap);
+  }
+  bench_end(&b, "validate_bulk", 1, N_OPS);
+}
+
+int main(void) {
+  uint32_t x = 0x12345678;
+  for (size_t i = 0; i < sizeof(rand_bytes); i++) {
+    x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+    rand_bytes[i] = x >> 24;
+  }
+
+  bench_generate("generate/counter_inc", 0);
+  bench_generate("generate/new_timestamp", 1);
+  bench_gen_next("gen_next/counter_inc", 0);
+  bench_gen_next("gen_next/new_timestamp", 1);
+  bench_generate_batch();
+  bench_to_string();
+  bench_from_string();
+  bench_words();
+  bench_validate();
+  return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Compares instances of uuidv7::basic_generator with the C generators.
+ *
+ * Each generator runs with the two status mixes of bench_core.c: "counter_inc"
+ * passes the same timestamp to every call, and "new_timestamp" advances it on
+ * every call. "template/default" has the layout of uuidv7_generate(),
+ * "template/counter16" a 16-bit counter followed by 58 random bits, and
+ * "template/no_rollback" a rollback window of zero.
+ */
+#include "uuidv7.hpp"
+
+#include "bench.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#define N_UUIDS 1024
+#define N_ROUNDS 20000
+#define N_OPS ((uint64_t)N_UUIDS * N_ROUNDS)
+
+static uint8_t rand_bytes[10 * N_UUIDS];
+static uint8_t uuids[N_UUIDS][16];
+
+static volatile uint8_t sink = 0;
+
+/** Clock policy whose time the benchmark loop sets. */
+struct manual_clock {
+  uint64_t now_ms() const noexcept { return 0; }
+};
+
+static void bench_generate(const char *name, uint64_t ts_step) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    size_t n_rand_consumed = 0;
+    const uint8_t *p = NULL;
+    for (int i = 0; i < N_UUIDS; i++) {
+      int8_t status = uuidv7_generate(uuids[i], unix_ts_ms,
+                                      &rand_bytes[n_rand_consumed], p);
+      n_rand_consumed += uuidv7_status_n_rand_consumed(status);
+      p = uuids[i];
+      unix_ts_ms += ts_step;
+    }
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, name, 1, N_OPS);
+}
+
+static void bench_gen_next(const char *name, uint64_t ts_step) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    uuidv7_gen_t gen;
+    uuidv7_gen_init(&gen, NULL);
+    uuidv7_gen_set_rand(&gen, rand_bytes, sizeof(rand_bytes));
+    for (int i = 0; i < N_UUIDS; i++) {
+      uuidv7_gen_next(&gen, unix_ts_ms, uuids[i]);
+      unix_ts_ms += ts_step;
+    }
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, name, 1, N_OPS);
+}
+
+template <class Generator>
+static void bench_template(const char *name, uint64_t ts_step) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+
+  bench_t b;
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    Generator gen(manual_clock(),
+                  uuidv7::buffer_rand(rand_bytes, sizeof(rand_bytes)));
+    for (int i = 0; i < N_UUIDS; i++) {
+      gen.generate(unix_ts_ms, uuids[i]);
+      unix_ts_ms += ts_step;
+    }
+    sink ^= uuids[N_UUIDS - 1][15];
+  }
+  bench_end(&b, name, 1, N_OPS);
+}
+
+using default_generator =
+    uuidv7::basic_generator<manual_clock, uuidv7::buffer_rand>;
+using counter16_generator =
+    uuidv7::basic_generator<manual_clock, uuidv7::buffer_rand, 16>;
+using no_rollback_generator =
+    uuidv7::basic_generator<manual_clock, uuidv7::buffer_rand, 42, 0>;
+
+int main(void) {
+  uint32_t x = 0x12345678;
+  for (size_t i = 0; i < sizeof(rand_bytes); i++) {
+    x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+    rand_bytes[i] = x >> 24;
+  }
+
+  bench_generate("generator/generate/counter_inc", 0);
+  bench_generate("generator/generate/new_timestamp", 1);
+  bench_gen_next("generator/gen_next/counter_inc", 0);
+  bench_gen_next("generator/gen_next/new_timestamp", 1);
+  bench_template<default_generator>("generator/template/default/counter_inc",
+                                    0);
+  bench_template<default_generator>(
+      "generator/template/default/new_timestamp", 1);
+  bench_template<counter16_generator>(
+      "generator/template/counter16/counter_inc", 0);
+  bench_template<counter16_generator>(
+      "generator/template/counter16/new_timestamp", 1);
+  bench_template<no_rollback_generator>(
+      "generator/template/no_rollback/counter_inc", 0);
+  bench_template<no_rollback_generator>(
+      "generator/template/no_rollback/new_timestamp", 1);
+  return 0;
+}
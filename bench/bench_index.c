@@ -0,0 +1,104 @@
+/*
+ * Compares uuidv7_index.h with binary searches over 4M sorted UUIDs (64 MiB).
+ *
+ * "lower_bound" finds the first UUID of a random millisecond: "binary" runs a
+ * memcmp() binary search for uuidv7_min_for_timestamp(), and "index" uses the
+ * Eytzinger directory. "bsearch" looks up existing UUIDs with libc bsearch()
+ * for reference, which needs the whole UUID rather than a time range.
+ */
+#include "uuidv7.h"
+#include "uuidv7_index.h"
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+#define N_UUIDS (1 << 22)
+#define N_QUERIES (1 << 22)
+
+static uint8_t uuids[16 * N_UUIDS];
+static uint64_t queries[N_QUERIES];
+
+static volatile size_t sink = 0;
+
+static uint64_t next_rand(void) {
+  static uint64_t x = 0x2545f4914f6cdd1d;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  return x * 0x2545f4914f6cdd1d;
+}
+
+static int compare(const void *a, const void *b) { return memcmp(a, b, 16); }
+
+static size_t binary_lower_bound(const uint8_t *key) {
+  size_t lo = 0, hi = N_UUIDS;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (memcmp(&uuids[16 * mid], key, 16) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+int main(void) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      rand_bytes[j] = (uint8_t)next_rand();
+    }
+    unix_ts_ms += next_rand() % 64 == 0;
+    uuidv7_generate(&uuids[16 * i], unix_ts_ms, rand_bytes,
+                    i > 0 ? &uuids[16 * (i - 1)] : NULL);
+  }
+  uint64_t first = uuidv7_get_timestamp(uuids);
+  for (size_t i = 0; i < N_QUERIES; i++) {
+    queries[i] = first + next_rand() % (unix_ts_ms - first + 1);
+  }
+
+  bench_t b;
+  bench_begin(&b);
+  for (size_t i = 0; i < N_QUERIES; i++) {
+    uint8_t key[16];
+    uuidv7_min_for_timestamp(queries[i], key);
+    sink += binary_lower_bound(key);
+  }
+  bench_end(&b, "index/lower_bound/binary", 1, N_QUERIES);
+
+  size_t n_keys = uuidv7_index_n_keys(N_UUIDS);
+  uint64_t *keys = (uint64_t *)aligned_alloc(64, sizeof(uint64_t) * n_keys);
+  uuidv7_index_t index;
+  bench_begin(&b);
+  uuidv7_index_build(&index, uuids, N_UUIDS, keys);
+  bench_end(&b, "index/build", 1, N_UUIDS);
+
+  bench_begin(&b);
+  for (size_t i = 0; i < N_QUERIES; i++) {
+    sink += uuidv7_index_lower_bound(&index, queries[i]);
+  }
+  bench_end(&b, "index/lower_bound/index", 1, N_QUERIES);
+
+  for (size_t i = 0; i < N_QUERIES; i++) {
+    uint8_t key[16];
+    uuidv7_min_for_timestamp(queries[i], key);
+    if (uuidv7_index_lower_bound(&index, queries[i]) !=
+        binary_lower_bound(key)) {
+      fprintf(stderr, "error: index and binary search disagree\n");
+      return 1;
+    }
+  }
+
+  bench_begin(&b);
+  for (size_t i = 0; i < N_QUERIES; i++) {
+    const uint8_t *key = &uuids[16 * (queries[i] % N_UUIDS)];
+    sink += (size_t)bsearch(key, uuids, N_UUIDS, 16, compare);
+  }
+  bench_end(&b, "index/exact/bsearch", 1, N_QUERIES);
+
+  free(keys);
+  return 0;
+}
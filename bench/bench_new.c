@@ -0,0 +1,75 @@
+/*
+ * Measures a uuidv7_new() implementation linked with this file.
+ *
+ * "warm" runs spread a fixed number of calls over 1 to 8 threads, so the cost
+ * of seeding the per-thread random pool is amortized. "cold" runs start one
+ * fresh thread after another and time only their first few calls, which seed
+ * the pool and fill it for the first time.
+ */
+#include "uuidv7.h"
+
+#include "bench.h"
+
+#include <pthread.h>
+
+#ifndef BENCH_IMPL
+#define BENCH_IMPL "new"
+#endif
+
+#define N_OPS ((uint64_t)1 << 22)
+#define N_COLD_THREADS 1000
+#define N_COLD_OPS 16
+
+static volatile uint8_t sink = 0;
+
+static void *run_warm(void *arg) {
+  uint64_t n = *(const uint64_t *)arg;
+  uint8_t uuid[16];
+  for (uint64_t i = 0; i < n; i++) {
+    uuidv7_new(uuid);
+  }
+  sink ^= uuid[15];
+  return NULL;
+}
+
+static void *run_cold(void *arg) {
+  uint8_t uuid[16];
+  double t0 = bench_now();
+  for (int i = 0; i < N_COLD_OPS; i++) {
+    uuidv7_new(uuid);
+  }
+  *(double *)arg = bench_now() - t0;
+  sink ^= uuid[15];
+  return NULL;
+}
+
+int main(void) {
+  char name[64];
+  for (int n_threads = 1; n_threads <= 8; n_threads *= 2) {
+    pthread_t threads[8];
+    uint64_t n_per_thread = N_OPS / n_threads;
+
+    bench_t b;
+    bench_begin(&b);
+    for (int i = 0; i < n_threads; i++) {
+      pthread_create(&threads[i], NULL, run_warm, &n_per_thread);
+    }
+    for (int i = 0; i < n_threads; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    snprintf(name, sizeof(name), "new_%s/warm", BENCH_IMPL);
+    bench_end(&b, name, n_threads, n_per_thread * n_threads);
+  }
+
+  double elapsed = 0.0;
+  for (int i = 0; i < N_COLD_THREADS; i++) {
+    pthread_t thread;
+    double t;
+    pthread_create(&thread, NULL, run_cold, &t);
+    pthread_join(thread, NULL);
+    elapsed += t;
+  }
+  snprintf(name, sizeof(name), "new_%s/cold", BENCH_IMPL);
+  bench_report(name, 1, (uint64_t)N_COLD_THREADS * N_COLD_OPS, elapsed, NULL);
+  return 0;
+}
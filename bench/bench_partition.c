@@ -0,0 +1,152 @@
+/*
+ * Partitions 16M UUIDs (256 MiB) spanning three days by hour and by day.
+ *
+ * "naive" decodes each UUID with uuidv7_get_timestamp(), divides the timestamp
+ * by the bucket width, and appends the UUID to a growing array per bucket, as a
+ * loader that routes IDs one at a time does. "partition" runs the counting sort
+ * of uuidv7_partition.h, and "parallel" splits it over 1 to 8 threads. The
+ * "ordered" input is a monotonic sequence, and the "shuffled" one has random
+ * timestamps, as a batch merged from many producers does. "mmap" writes the
+ * shuffled input to a temporary file and partitions it from a read-only
+ * mapping, so the time includes the page faults of the mapping (but not disk
+ * reads, since the file stays in the page cache). The output array of the
+ * counting sort is reused across runs, whereas the naive arrays are allocated
+ * anew each time, as they would be for each batch.
+ */
+#define UUIDV7_PARTITION_PTHREAD
+#include "uuidv7.h"
+#include "uuidv7_partition.h"
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#define N_UUIDS (1 << 24)
+#define RANGE_MS (3 * 86400000)
+#define MAX_BUCKETS 128
+
+static uint8_t ordered[16 * N_UUIDS];
+static uint8_t shuffled[16 * N_UUIDS];
+static uint8_t output[16 * N_UUIDS];
+static size_t counts[UUIDV7_PARTITION_MAX_THREADS * MAX_BUCKETS];
+
+static volatile size_t sink = 0;
+
+static uint64_t next_rand(void) {
+  static uint64_t x = 0x2545f4914f6cdd1d;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  return x * 0x2545f4914f6cdd1d;
+}
+
+static void bench_naive(const char *name, const uint8_t *uuids,
+                        uint64_t width_ms) {
+  uint8_t *buckets[MAX_BUCKETS] = {NULL};
+  size_t lens[MAX_BUCKETS] = {0}, caps[MAX_BUCKETS] = {0};
+  bench_t b;
+  bench_begin(&b);
+  uint64_t base_ms = uuidv7_get_timestamp(ordered);
+  base_ms -= base_ms % width_ms;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    size_t k = (size_t)((uuidv7_get_timestamp(&uuids[16 * i]) - base_ms) /
+                        width_ms);
+    if (lens[k] == caps[k]) {
+      caps[k] = caps[k] > 0 ? caps[k] * 2 : 1024;
+      buckets[k] = (uint8_t *)realloc(buckets[k], 16 * caps[k]);
+    }
+    memcpy(&buckets[k][16 * lens[k]++], &uuids[16 * i], 16);
+  }
+  bench_end(&b, name, 1, N_UUIDS);
+  for (size_t k = 0; k < MAX_BUCKETS; k++) {
+    sink += lens[k];
+    free(buckets[k]);
+  }
+}
+
+static void bench_partition(const char *name, const uint8_t *uuids,
+                            uint64_t width_ms, size_t n_threads) {
+  size_t bucket_starts[MAX_BUCKETS + 2];
+  uuidv7_partition_t p;
+  bench_t b;
+  bench_begin(&b);
+  if (uuidv7_partition_init_range(&p, uuids, N_UUIDS, width_ms) != 0 ||
+      p.n_buckets + 2 > MAX_BUCKETS) {
+    fprintf(stderr, "error: too many buckets\n");
+    exit(1);
+  }
+  if (n_threads == 0) {
+    uuidv7_partition(&p, uuids, N_UUIDS, bucket_starts, output);
+  } else {
+    uuidv7_partition_parallel(&p, uuids, N_UUIDS, n_threads, counts,
+                              bucket_starts, output);
+  }
+  bench_end(&b, name, n_threads > 0 ? (int)n_threads : 1, N_UUIDS);
+  sink += bucket_starts[1];
+}
+
+static void bench_mmap(void) {
+  char path[] = "/tmp/bench_partition_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0 || write(fd, shuffled, sizeof(shuffled)) != sizeof(shuffled)) {
+    fprintf(stderr, "error: failed to write %s\n", path);
+    exit(1);
+  }
+  close(fd);
+
+  bench_t b;
+  bench_begin(&b);
+  fd = open(path, O_RDONLY);
+  void *map = mmap(NULL, sizeof(shuffled), PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "error: failed to map %s\n", path);
+    exit(1);
+  }
+  madvise(map, sizeof(shuffled), MADV_SEQUENTIAL);
+  size_t bucket_starts[MAX_BUCKETS + 2];
+  uuidv7_partition_t p;
+  if (uuidv7_partition_init_range(&p, (const uint8_t *)map, N_UUIDS,
+                                  3600000) != 0 ||
+      p.n_buckets + 2 > MAX_BUCKETS) {
+    fprintf(stderr, "error: too many buckets\n");
+    exit(1);
+  }
+  uuidv7_partition(&p, (const uint8_t *)map, N_UUIDS, bucket_starts, output);
+  munmap(map, sizeof(shuffled));
+  close(fd);
+  bench_end(&b, "partition/mmap/hourly/shuffled", 1, N_UUIDS);
+  sink += bucket_starts[1];
+  unlink(path);
+}
+
+int main(void) {
+  uint64_t first_ms = 0x17f22e279b0;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      rand_bytes[j] = (uint8_t)next_rand();
+    }
+    uuidv7_generate(&ordered[16 * i],
+                    first_ms + (uint64_t)RANGE_MS * i / N_UUIDS, rand_bytes,
+                    i > 0 ? &ordered[16 * (i - 1)] : NULL);
+    uuidv7_generate(&shuffled[16 * i], first_ms + next_rand() % RANGE_MS,
+                    rand_bytes, NULL);
+  }
+  memset(output, 0, sizeof(output)); // fault in the pages up front
+
+  bench_naive("partition/naive/hourly/ordered", ordered, 3600000);
+  bench_naive("partition/naive/hourly/shuffled", shuffled, 3600000);
+  bench_naive("partition/naive/daily/shuffled", shuffled, 86400000);
+  bench_partition("partition/single/hourly/ordered", ordered, 3600000, 0);
+  bench_partition("partition/single/hourly/shuffled", shuffled, 3600000, 0);
+  bench_partition("partition/single/daily/shuffled", shuffled, 86400000, 0);
+  for (size_t n_threads = 1; n_threads <= 8; n_threads *= 2) {
+    bench_partition("partition/parallel/hourly/shuffled", shuffled, 3600000,
+                    n_threads);
+  }
+  bench_mmap();
+  return 0;
+}
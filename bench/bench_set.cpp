@@ -0,0 +1,184 @@
+/*
+ * Compares uuidv7_set.h with std::unordered_set on 4M UUIDs.
+ *
+ * "insert" deduplicates a stream of 4M UUIDs drawn from 1.8M distinct ones,
+ * "find_hit" looks up UUIDs in the set, and "find_miss" looks up UUIDs that
+ * are not in it. The `_bulk` variants use the prefetching bulk functions. The
+ * std::unordered_set hashes all 16 bytes with std::hash<std::string_view>, as a
+ * generic container does, and its memory is counted by its allocator. The
+ * memory per UUID is printed to stderr.
+ */
+#include "uuidv7.h"
+#include "uuidv7_set.h"
+
+#include "bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+
+#define N_DISTINCT (7 << 18)
+#define N_STREAM (1 << 22)
+
+struct record {
+  uint8_t bytes[16];
+  bool operator==(const record &other) const {
+    return std::memcmp(bytes, other.bytes, 16) == 0;
+  }
+};
+
+struct record_hash {
+  std::size_t operator()(const record &r) const {
+    return std::hash<std::string_view>()(
+        std::string_view(reinterpret_cast<const char *>(r.bytes), 16));
+  }
+};
+
+static std::size_t n_allocated = 0;
+
+/** Allocator that counts the bytes held by the container. */
+template <class T> struct counting_allocator {
+  typedef T value_type;
+  counting_allocator() {}
+  template <class U> counting_allocator(const counting_allocator<U> &) {}
+  T *allocate(std::size_t n) {
+    n_allocated += n * sizeof(T);
+    return static_cast<T *>(std::malloc(n * sizeof(T)));
+  }
+  void deallocate(T *p, std::size_t n) {
+    n_allocated -= n * sizeof(T);
+    std::free(p);
+  }
+  template <class U> bool operator==(const counting_allocator<U> &) const {
+    return true;
+  }
+  template <class U> bool operator!=(const counting_allocator<U> &) const {
+    return false;
+  }
+};
+
+typedef std::unordered_set<record, record_hash, std::equal_to<record>,
+                           counting_allocator<record> >
+    std_set;
+
+static uint8_t distinct[16 * 2 * N_DISTINCT]; // second half never inserted
+static uint8_t stream[16 * N_STREAM];
+static uint8_t queries[16 * N_STREAM];
+static uint8_t misses[16 * N_STREAM];
+
+static volatile std::size_t sink = 0;
+
+static uint64_t next_rand(void) {
+  static uint64_t x = 0x2545f4914f6cdd1d;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  return x * 0x2545f4914f6cdd1d;
+}
+
+int main(void) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (std::size_t i = 0; i < 2 * N_DISTINCT; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      rand_bytes[j] = (uint8_t)next_rand();
+    }
+    unix_ts_ms += next_rand() % 1000 == 0;
+    uuidv7_generate(&distinct[16 * i], unix_ts_ms, rand_bytes,
+                    i > 0 ? &distinct[16 * (i - 1)] : NULL);
+  }
+  // recent UUIDs recur more often than old ones, as retries do
+  for (std::size_t i = 0; i < N_STREAM; i++) {
+    std::size_t k = i / 2 + next_rand() % 64;
+    k = k < N_DISTINCT ? k : N_DISTINCT - 1;
+    std::memcpy(&stream[16 * i], &distinct[16 * k], 16);
+    k = next_rand() % N_DISTINCT;
+    std::memcpy(&queries[16 * i], &distinct[16 * k], 16);
+    k = N_DISTINCT + next_rand() % N_DISTINCT;
+    std::memcpy(&misses[16 * i], &distinct[16 * k], 16);
+  }
+
+  bench_t b;
+  {
+    std_set set;
+    bench_begin(&b);
+    for (std::size_t i = 0; i < N_STREAM; i++) {
+      record r;
+      std::memcpy(r.bytes, &stream[16 * i], 16);
+      sink += set.insert(r).second;
+    }
+    bench_end(&b, "set/insert/unordered_set", 1, N_STREAM);
+    std::fprintf(stderr, "unordered_set: %.1f bytes/UUID\n",
+                 (double)n_allocated / set.size());
+
+    bench_begin(&b);
+    for (std::size_t i = 0; i < N_STREAM; i++) {
+      record r;
+      std::memcpy(r.bytes, &queries[16 * i], 16);
+      sink += set.count(r);
+    }
+    bench_end(&b, "set/find_hit/unordered_set", 1, N_STREAM);
+
+    bench_begin(&b);
+    for (std::size_t i = 0; i < N_STREAM; i++) {
+      record r;
+      std::memcpy(r.bytes, &misses[16 * i], 16);
+      sink += set.count(r);
+    }
+    bench_end(&b, "set/find_miss/unordered_set", 1, N_STREAM);
+  }
+
+  std::size_t n_slots = uuidv7_set_n_slots(N_DISTINCT);
+  std::size_t memory_size = uuidv7_set_memory_size(n_slots, 0);
+  void *memory = std::aligned_alloc(64, memory_size);
+  uuidv7_set_t set;
+  uuidv7_set_init(&set, n_slots, memory, 0);
+
+  bench_begin(&b);
+  for (std::size_t i = 0; i < N_STREAM; i++) {
+    sink += uuidv7_set_insert(&set, &stream[16 * i], NULL);
+  }
+  bench_end(&b, "set/insert/uuidv7_set", 1, N_STREAM);
+  std::fprintf(stderr, "uuidv7_set: %.1f bytes/UUID\n",
+               (double)memory_size / set.size);
+
+  uuidv7_set_clear(&set);
+  bench_begin(&b);
+  sink += uuidv7_set_insert_bulk(&set, stream, N_STREAM, NULL, NULL);
+  bench_end(&b, "set/insert_bulk/uuidv7_set", 1, N_STREAM);
+
+  bench_begin(&b);
+  for (std::size_t i = 0; i < N_STREAM; i++) {
+    sink += uuidv7_set_find(&set, &queries[16 * i]);
+  }
+  bench_end(&b, "set/find_hit/uuidv7_set", 1, N_STREAM);
+
+  bench_begin(&b);
+  sink += uuidv7_set_find_bulk(&set, queries, N_STREAM, NULL);
+  bench_end(&b, "set/find_hit_bulk/uuidv7_set", 1, N_STREAM);
+
+  bench_begin(&b);
+  for (std::size_t i = 0; i < N_STREAM; i++) {
+    sink += uuidv7_set_find(&set, &misses[16 * i]);
+  }
+  bench_end(&b, "set/find_miss/uuidv7_set", 1, N_STREAM);
+
+  bench_begin(&b);
+  sink += uuidv7_set_find_bulk(&set, misses, N_STREAM, NULL);
+  bench_end(&b, "set/find_miss_bulk/uuidv7_set", 1, N_STREAM);
+
+  // slide a window of 1/4 of the set by 1/64 of it at a time
+  uint64_t first = uuidv7_get_timestamp(distinct);
+  uint64_t last = uuidv7_get_timestamp(&distinct[16 * (N_DISTINCT - 1)]);
+  bench_begin(&b);
+  for (int k = 0; k < 16; k++) {
+    sink += uuidv7_set_evict_before(&set, first + (last - first) * k / 64);
+  }
+  bench_end(&b, "set/evict_before/uuidv7_set", 1, 16);
+
+  std::free(memory);
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Compares uuidv7_sort.h with qsort() and std::sort() on 4M UUIDs.
+ *
+ * Inputs: "shuffled" is a UUIDv7 sequence in random order, "runs4" is the
+ * concatenated outputs of 4 generators, and "nearly_sorted" is a sorted
+ * sequence in which 1% of UUIDs are displaced by up to 64 positions. Each
+ * operation is one UUID sorted or merged.
+ */
+#include "uuidv7.h"
+#include "uuidv7_sort.h"
+
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#define N_UUIDS (1 << 22)
+#define N_RUNS 4
+
+struct record {
+  uint8_t bytes[16];
+};
+
+static bool operator<(const record &a, const record &b) {
+  return std::memcmp(a.bytes, b.bytes, 16) < 0;
+}
+
+static int compare(const void *a, const void *b) {
+  return std::memcmp(a, b, 16);
+}
+
+static uint64_t next_rand(void) {
+  static uint64_t x = 0x2545f4914f6cdd1d;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  return x * 0x2545f4914f6cdd1d;
+}
+
+/** Fills `out` with a monotonic sequence of about 1000 UUIDs per ms. */
+static void generate_sequence(uint8_t *out, size_t n, uint64_t unix_ts_ms) {
+  const uint8_t *prev = NULL;
+  for (size_t i = 0; i < n; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      rand_bytes[j] = (uint8_t)next_rand();
+    }
+    unix_ts_ms += next_rand() % 1000 == 0;
+    uuidv7_generate(&out[16 * i], unix_ts_ms, rand_bytes, prev);
+    prev = &out[16 * i];
+  }
+}
+
+static void swap16(uint8_t *a, uint8_t *b) {
+  uint8_t tmp[16];
+  std::memcpy(tmp, a, 16);
+  std::memcpy(a, b, 16);
+  std::memcpy(b, tmp, 16);
+}
+
+static void make_input(const char *kind, uint8_t *out) {
+  if (std::strcmp(kind, "runs4") == 0) {
+    for (int r = 0; r < N_RUNS; r++) {
+      generate_sequence(&out[16 * (N_UUIDS / N_RUNS) * r], N_UUIDS / N_RUNS,
+                        0x17f22e279b0);
+    }
+    return;
+  }
+
+  generate_sequence(out, N_UUIDS, 0x17f22e279b0);
+  if (std::strcmp(kind, "shuffled") == 0) {
+    for (size_t i = N_UUIDS; i > 1; i--) {
+      swap16(&out[16 * (i - 1)], &out[16 * (next_rand() % i)]);
+    }
+  } else {
+    for (size_t k = 0; k < N_UUIDS / 100; k++) {
+      size_t i = next_rand() % (N_UUIDS - 64);
+      swap16(&out[16 * i], &out[16 * (i + 1 + next_rand() % 63)]);
+    }
+  }
+}
+
+int main(void) {
+  static const char *const KINDS[] = {"shuffled", "runs4", "nearly_sorted"};
+  std::vector<uint8_t> input(16 * N_UUIDS), work(16 * N_UUIDS),
+      scratch(16 * N_UUIDS), expected(16 * N_UUIDS);
+  char name[64];
+
+  for (size_t k = 0; k < sizeof(KINDS) / sizeof(KINDS[0]); k++) {
+    make_input(KINDS[k], input.data());
+    expected = input;
+    std::qsort(expected.data(), N_UUIDS, 16, compare);
+
+    bench_t b;
+    work = input;
+    std::snprintf(name, sizeof(name), "sort/%s/qsort", KINDS[k]);
+    bench_begin(&b);
+    std::qsort(work.data(), N_UUIDS, 16, compare);
+    bench_end(&b, name, 1, N_UUIDS);
+
+    work = input;
+    std::snprintf(name, sizeof(name), "sort/%s/std_sort", KINDS[k]);
+    record *records = reinterpret_cast<record *>(work.data());
+    bench_begin(&b);
+    std::sort(records, records + N_UUIDS);
+    bench_end(&b, name, 1, N_UUIDS);
+
+    work = input;
+    std::snprintf(name, sizeof(name), "sort/%s/radix", KINDS[k]);
+    bench_begin(&b);
+    uuidv7_sort_radix(work.data(), N_UUIDS, scratch.data());
+    bench_end(&b, name, 1, N_UUIDS);
+    if (work != expected) {
+      std::fprintf(stderr, "error: %s produced a wrong order\n", name);
+      return 1;
+    }
+
+    work = input;
+    std::snprintf(name, sizeof(name), "sort/%s/adaptive", KINDS[k]);
+    bench_begin(&b);
+    uuidv7_sort(work.data(), N_UUIDS, scratch.data());
+    bench_end(&b, name, 1, N_UUIDS);
+    if (work != expected) {
+      std::fprintf(stderr, "error: %s produced a wrong order\n", name);
+      return 1;
+    }
+  }
+
+  // k-way merge of the 4 generator outputs into a separate array
+  make_input("runs4", input.data());
+  uuidv7_merge_run_t runs[N_RUNS];
+  size_t heap[N_RUNS];
+  for (int r = 0; r < N_RUNS; r++) {
+    runs[r].uuids = &input[16 * (N_UUIDS / N_RUNS) * r];
+    runs[r].n_uuids = N_UUIDS / N_RUNS;
+    runs[r].finished = 1;
+  }
+  uuidv7_merger_t m;
+  bench_t b;
+  bench_begin(&b);
+  uuidv7_merger_init(&m, runs, N_RUNS, heap);
+  size_t n_merged = 0;
+  while (size_t n = uuidv7_merger_next(&m, &work[16 * n_merged], 4096)) {
+    n_merged += n;
+  }
+  bench_end(&b, "merge/runs4/merger", 1, N_UUIDS);
+  if (n_merged != N_UUIDS) {
+    std::fprintf(stderr, "error: merger stopped early\n");
+    return 1;
+  }
+
+  return 0;
+}
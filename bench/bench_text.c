@@ -0,0 +1,104 @@
+/*
+ * Compares the text encodings of uuidv7.h and uuidv7_text.h.
+ *
+ * Each encoding is measured one UUID at a time and in bulk with line breaks,
+ * in both directions. The bytes per UUID of each bulk form, including the line
+ * break, are printed to stderr. Build with `-mssse3` or `-march=native` to
+ * measure the SIMD paths.
+ */
+#include "uuidv7.h"
+#include "uuidv7_text.h"
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+#define N_UUIDS 1024
+#define N_ROUNDS 20000
+#define N_OPS ((uint64_t)N_UUIDS * N_ROUNDS)
+
+static uint8_t uuids[16 * N_UUIDS];
+static char text[37 * N_UUIDS];
+
+static volatile uint8_t sink = 0;
+
+typedef struct {
+  const char *label;
+  size_t len;
+  void (*encode)(const uint8_t *, char *);
+  int (*decode)(const char *, uint8_t *);
+  size_t (*encode_bulk)(const uint8_t *, size_t, char *, int);
+  size_t (*decode_bulk)(const char *, size_t, int, uint8_t *, uint8_t *);
+} encoding_t;
+
+static void bench_encoding(const encoding_t *e) {
+  const size_t stride = e->len + 1;
+  char name[64];
+  bench_t b;
+
+  snprintf(name, sizeof(name), "text/%s/encode", e->label);
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      e->encode(&uuids[16 * i], &text[stride * i]);
+    }
+    sink ^= text[stride * N_UUIDS - 2];
+  }
+  bench_end(&b, name, 1, N_OPS);
+
+  snprintf(name, sizeof(name), "text/%s/decode", e->label);
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      e->decode(&text[stride * i], &uuids[16 * i]);
+    }
+    sink ^= uuids[16 * N_UUIDS - 1];
+  }
+  bench_end(&b, name, 1, N_OPS);
+
+  size_t n_bytes = 0;
+  snprintf(name, sizeof(name), "text/%s/encode_bulk", e->label);
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    n_bytes = e->encode_bulk(uuids, N_UUIDS, text, '\n');
+    sink ^= text[stride * N_UUIDS - 2];
+  }
+  bench_end(&b, name, 1, N_OPS);
+
+  snprintf(name, sizeof(name), "text/%s/decode_bulk", e->label);
+  bench_begin(&b);
+  for (int r = 0; r < N_ROUNDS; r++) {
+    if (e->decode_bulk(text, N_UUIDS, '\n', uuids, NULL) != 0) {
+      fprintf(stderr, "error: %s failed to decode\n", e->label);
+      exit(1);
+    }
+    sink ^= uuids[16 * N_UUIDS - 1];
+  }
+  bench_end(&b, name, 1, N_OPS);
+  fprintf(stderr, "%s: %.0f bytes/UUID\n", e->label,
+          (double)n_bytes / N_UUIDS);
+}
+
+int main(void) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      rand_bytes[j] = (uint8_t)rand();
+    }
+    uuidv7_generate(&uuids[16 * i], unix_ts_ms++, rand_bytes, NULL);
+  }
+
+  const encoding_t encodings[] = {
+      {"hex", 36, uuidv7_to_string, uuidv7_from_string, uuidv7_to_string_bulk,
+       uuidv7_from_string_bulk},
+      {"base32", 26, uuidv7_to_base32, uuidv7_from_base32,
+       uuidv7_to_base32_bulk, uuidv7_from_base32_bulk},
+      {"base64url", 22, uuidv7_to_base64url, uuidv7_from_base64url,
+       uuidv7_to_base64url_bulk, uuidv7_from_base64url_bulk},
+  };
+  for (size_t k = 0; k < sizeof(encodings) / sizeof(encodings[0]); k++) {
+    bench_encoding(&encodings[k]);
+  }
+  return 0;
+}
@@ -0,0 +1,332 @@
+/*
+ * uuidv7 - Command-line generator and converter built on uuidv7.h
+ *
+ *   uuidv7 gen [-n COUNT] [-b]   generate COUNT (default: 1) UUIDv7s
+ *   uuidv7 encode [FILE]         convert text lines to 16-byte records
+ *   uuidv7 decode [FILE]         convert 16-byte records to text lines
+ *   uuidv7 inspect [-b] [FILE]   print the timestamp and counter of each UUID
+ *
+ * Text is one 8-4-4-4-12 string per line, and binary is a stream of 16-byte
+ * records; `-b` selects binary output for `gen` and binary input for `inspect`.
+ * FILE defaults to the standard input.
+ *
+ * Every mode works on chunks of thousands of UUIDs with the bulk functions of
+ * uuidv7.h and writes the output in 1 MiB write(2) calls, so the throughput is
+ * bound by memory bandwidth rather than per-UUID system calls. Regular files
+ * are read through mmap(2); other inputs, such as pipes, through large read(2)
+ * calls. `gen` draws random bytes from the buffered ChaCha20 generator of
+ * impl/uuidv7_rand.h and reads the clock once per chunk.
+ */
+#include "uuidv7.h"
+
+#include "uuidv7_clock.h"
+#include "uuidv7_rand.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/** Number of UUIDs processed at a time. */
+#define CHUNK_SIZE 4096
+
+/** Size of the output buffer, which holds several chunks. */
+#define OUTPUT_SIZE (1 << 20)
+
+/** Size of the input buffer used when the input cannot be mapped. */
+#define INPUT_SIZE (1 << 20)
+
+static char output[OUTPUT_SIZE];
+static size_t output_len = 0;
+
+static void die(const char *message) {
+  fprintf(stderr, "uuidv7: %s\n", message);
+  exit(1);
+}
+
+static void flush_output(void) {
+  size_t n_written = 0;
+  while (n_written < output_len) {
+    ssize_t n = write(STDOUT_FILENO, &output[n_written],
+                      output_len - n_written);
+    if (n < 0 && errno != EINTR) {
+      die(strerror(errno));
+    }
+    n_written += n > 0 ? (size_t)n : 0;
+  }
+  output_len = 0;
+}
+
+/** Returns a pointer to `n` free bytes in the output buffer. */
+static char *reserve_output(size_t n) {
+  if (output_len + n > sizeof(output)) {
+    flush_output();
+  }
+  return &output[output_len];
+}
+
+/** Input read through either a memory mapping or a buffer. */
+typedef struct {
+  int fd;
+
+  /** Mapped file, or NULL if the input is read into `buffer`. */
+  const char *map;
+
+  /** Length of the mapped file or of the valid part of `buffer`. */
+  size_t len;
+
+  /** Position of the first unconsumed byte. */
+  size_t pos;
+
+  /** Non-zero if the input is exhausted. */
+  int eof;
+
+  char buffer[INPUT_SIZE];
+} input_t;
+
+static input_t input;
+
+static void open_input(const char *path) {
+  input.fd = STDIN_FILENO;
+  if (path != NULL && strcmp(path, "-") != 0) {
+    input.fd = open(path, O_RDONLY);
+    if (input.fd < 0) {
+      die(strerror(errno));
+    }
+  }
+
+  struct stat st;
+  if (fstat(input.fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                     input.fd, 0);
+    if (map != MAP_FAILED) {
+      madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+      input.map = (const char *)map;
+      input.len = (size_t)st.st_size;
+      input.eof = 1;
+    }
+  }
+}
+
+/**
+ * Makes at least `n` unconsumed bytes available unless the input ends first.
+ *
+ * @return  Pointer to the unconsumed bytes, whose number is stored in
+ *          `*n_avail`.
+ */
+static const char *peek_input(size_t n, size_t *n_avail) {
+  if (input.map == NULL && input.len - input.pos < n && !input.eof) {
+    memmove(input.buffer, &input.buffer[input.pos], input.len - input.pos);
+    input.len -= input.pos;
+    input.pos = 0;
+    while (input.len < sizeof(input.buffer)) {
+      ssize_t r = read(input.fd, &input.buffer[input.len],
+                       sizeof(input.buffer) - input.len);
+      if (r < 0 && errno != EINTR) {
+        die(strerror(errno));
+      } else if (r == 0) {
+        input.eof = 1;
+        break;
+      }
+      input.len += r > 0 ? (size_t)r : 0;
+    }
+  }
+  *n_avail = input.len - input.pos;
+  return input.map != NULL ? &input.map[input.pos] : &input.buffer[input.pos];
+}
+
+/**
+ * Reads up to `CHUNK_SIZE` UUIDs in text or binary form.
+ *
+ * @param binary     Non-zero to read 16-byte records instead of text lines.
+ * @param uuids_out  Byte array of `16 * CHUNK_SIZE` bytes where the UUIDs are
+ *                   stored.
+ * @return           Number of UUIDs read, or zero at the end of the input.
+ */
+static size_t read_uuids(int binary, uint8_t *uuids_out) {
+  static uint64_t line = 0;
+  const size_t stride = binary ? 16 : 37;
+  size_t n_avail;
+  const char *in = peek_input(stride * CHUNK_SIZE, &n_avail);
+  size_t n = n_avail / stride < CHUNK_SIZE ? n_avail / stride : CHUNK_SIZE;
+
+  if (binary) {
+    if (n == 0 && n_avail > 0) {
+      die("input is not a sequence of 16-byte records");
+    }
+    memcpy(uuids_out, in, 16 * n);
+  } else if (n > 0) {
+    uint8_t failed[CHUNK_SIZE];
+    if (uuidv7_from_string_bulk(in, n, '\n', uuids_out, failed) > 0) {
+      size_t i = 0;
+      while (!failed[i]) {
+        i++;
+      }
+      fprintf(stderr, "uuidv7: line %llu: invalid UUID string\n",
+              (unsigned long long)(line + i + 1));
+      exit(1);
+    }
+  } else if (n_avail > 0) {
+    // last line without a line break
+    char string[37];
+    memcpy(string, in, n_avail < 36 ? n_avail : 36);
+    string[n_avail < 36 ? n_avail : 36] = '\0';
+    if (n_avail != 36 || uuidv7_from_string(string, uuids_out) != 0) {
+      fprintf(stderr, "uuidv7: line %llu: invalid UUID string\n",
+              (unsigned long long)(line + 1));
+      exit(1);
+    }
+    input.pos += 36;
+    line++;
+    return 1;
+  }
+
+  input.pos += stride * n;
+  line += n;
+  return n;
+}
+
+static void run_gen(uint64_t n_uuids, int binary) {
+  static uint8_t uuids[16 * CHUNK_SIZE];
+  uint8_t uuid_prev[16];
+  uuidv7_rand_t rng;
+  if (uuidv7_rand_init(&rng) != 0) {
+    die("failed to obtain random bytes");
+  }
+
+  for (uint64_t n_done = 0; n_done < n_uuids;) {
+    size_t n = n_uuids - n_done < CHUNK_SIZE ? (size_t)(n_uuids - n_done)
+                                             : CHUNK_SIZE;
+    const uint8_t *rand_bytes = uuidv7_rand_peek(&rng, UUIDV7_RAND_BUFFER_SIZE);
+    if (rand_bytes == NULL) {
+      die("failed to obtain random bytes");
+    }
+
+    // the buffer covers at least 409 UUIDs, so the batch may stop early
+    uuidv7_batch_t result;
+    int8_t status = uuidv7_generate_batch(
+        uuids, n, uuidv7_clock_now_ms(), rand_bytes, UUIDV7_RAND_BUFFER_SIZE,
+        n_done > 0 ? uuid_prev : NULL, &result);
+    if (status < 0) {
+      die("failed to generate UUIDs");
+    }
+    uuidv7_rand_consume(&rng, result.n_rand_consumed);
+    n = result.n_generated;
+    memcpy(uuid_prev, &uuids[16 * (n - 1)], 16);
+
+    if (binary) {
+      memcpy(reserve_output(16 * n), uuids, 16 * n);
+      output_len += 16 * n;
+    } else {
+      output_len += uuidv7_to_string_bulk(uuids, n, reserve_output(37 * n),
+                                          '\n');
+    }
+    n_done += n;
+  }
+  flush_output();
+}
+
+static void run_convert(int to_binary) {
+  static uint8_t uuids[16 * CHUNK_SIZE];
+  size_t n;
+  while ((n = read_uuids(!to_binary, uuids)) > 0) {
+    if (to_binary) {
+      memcpy(reserve_output(16 * n), uuids, 16 * n);
+      output_len += 16 * n;
+    } else {
+      output_len += uuidv7_to_string_bulk(uuids, n, reserve_output(37 * n),
+                                          '\n');
+    }
+  }
+  flush_output();
+}
+
+static void run_inspect(int binary) {
+  static uint8_t uuids[16 * CHUNK_SIZE];
+  size_t n;
+  while ((n = read_uuids(binary, uuids)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      const uint8_t *uuid = &uuids[16 * i];
+      char *out = reserve_output(128);
+      uuidv7_to_string(uuid, out);
+      size_t len = 36;
+      if ((uuid[6] & 0xf0) == 0x70 && (uuid[8] & 0xc0) == 0x80) {
+        uint64_t unix_ts_ms = uuidv7_get_timestamp(uuid);
+        time_t seconds = (time_t)(unix_ts_ms / 1000);
+        struct tm tm;
+        char date[32];
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                 gmtime_r(&seconds, &tm));
+        len += (size_t)snprintf(&out[len], 128 - len,
+                                "\t%llu\t%s.%03uZ\t%llu\n",
+                                (unsigned long long)unix_ts_ms, date,
+                                (unsigned)(unix_ts_ms % 1000),
+                                (unsigned long long)uuidv7_get_counter(uuid));
+      } else {
+        // timestamp and counter are meaningful only for UUIDv7s
+        len += (size_t)snprintf(&out[len], 128 - len, "\t-\t-\t-\n");
+      }
+      output_len += len;
+    }
+  }
+  flush_output();
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: uuidv7 gen [-n COUNT] [-b]\n"
+                  "       uuidv7 encode [FILE]\n"
+                  "       uuidv7 decode [FILE]\n"
+                  "       uuidv7 inspect [-b] [FILE]\n");
+  exit(2);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    usage();
+  }
+  const char *mode = argv[1];
+  uint64_t n_uuids = 1;
+  int has_n = 0, binary = 0;
+  const char *path = NULL;
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0) {
+      binary = 1;
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      char *end;
+      errno = 0;
+      n_uuids = strtoull(argv[++i], &end, 10);
+      has_n = 1;
+      if (errno != 0 || *end != '\0' || argv[i][0] == '-') {
+        usage();
+      }
+    } else if (path == NULL && (argv[i][0] != '-' || argv[i][1] == '\0')) {
+      path = argv[i];
+    } else {
+      usage();
+    }
+  }
+
+  if (strcmp(mode, "gen") == 0 && path == NULL) {
+    run_gen(n_uuids, binary);
+  } else if (has_n) {
+    usage();
+  } else if (strcmp(mode, "encode") == 0 && !binary) {
+    open_input(path);
+    run_convert(1);
+  } else if (strcmp(mode, "decode") == 0 && !binary) {
+    open_input(path);
+    run_convert(0);
+  } else if (strcmp(mode, "inspect") == 0) {
+    open_input(path);
+    run_inspect(binary);
+  } else {
+    usage();
+  }
+  return 0;
+}
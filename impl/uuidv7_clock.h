@@ -0,0 +1,219 @@
+/**
+ * @file
+ *
+ * Millisecond clock sources for `uuidv7_new()` implementations.
+ *
+ * The Unix time in milliseconds changes only once per millisecond, so reading
+ * `CLOCK_REALTIME` and dividing it for every UUID does mostly redundant work.
+ * This header provides cheaper alternatives and selects one at compile time by
+ * `UUIDV7_CLOCK`:
+ *
+ * - `UUIDV7_CLOCK_REALTIME`: `clock_gettime(CLOCK_REALTIME)` (default).
+ * - `UUIDV7_CLOCK_COARSE`: `CLOCK_REALTIME_COARSE` if its resolution is one
+ *   millisecond or finer, or `CLOCK_REALTIME` otherwise.
+ * - `UUIDV7_CLOCK_TSC`: x86 time-stamp counter calibrated against and re-synced
+ *   to `CLOCK_REALTIME` every `UUIDV7_CLOCK_TSC_RESYNC_MS` milliseconds.
+ * - `UUIDV7_CLOCK_TICKER`: value published by a background thread that wakes
+ *   up every millisecond.
+ *
+ * The alternatives may lag behind or run ahead of `CLOCK_REALTIME` by a few
+ * milliseconds and may step back slightly when they are re-synced.
+ * `uuidv7_generate()` absorbs such small rollbacks by incrementing the counter
+ * of the previous timestamp, and the error of each source is bounded well
+ * below the ten-second rollback window.
+ */
+#ifndef UUIDV7_CLOCK_H_BAEDKYFQ
+#define UUIDV7_CLOCK_H_BAEDKYFQ
+
+#include <stdint.h>
+#include <time.h>
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/** @name Clock sources selectable by `UUIDV7_CLOCK` @{ */
+#define UUIDV7_CLOCK_REALTIME (0)
+#define UUIDV7_CLOCK_COARSE (1)
+#define UUIDV7_CLOCK_TSC (2)
+#define UUIDV7_CLOCK_TICKER (3)
+/** @} */
+
+#ifndef UUIDV7_CLOCK
+/** Clock source used by `uuidv7_clock_now_ms()`. */
+#define UUIDV7_CLOCK UUIDV7_CLOCK_REALTIME
+#endif
+
+#ifndef UUIDV7_CLOCK_TSC_RESYNC_MS
+/** Interval at which the TSC clock is re-synced to `CLOCK_REALTIME`. */
+#define UUIDV7_CLOCK_TSC_RESYNC_MS (100)
+#endif
+
+/** Reads `CLOCK_REALTIME` in nanoseconds. */
+static inline uint64_t uuidv7_clock_realtime_ns(void) {
+  struct timespec tp;
+  clock_gettime(CLOCK_REALTIME, &tp);
+  return (uint64_t)tp.tv_sec * 1000000000 + tp.tv_nsec;
+}
+
+/** Reads `CLOCK_REALTIME` in milliseconds. */
+static inline uint64_t uuidv7_clock_realtime_ms(void) {
+  struct timespec tp;
+  clock_gettime(CLOCK_REALTIME, &tp);
+  return (uint64_t)tp.tv_sec * 1000 + tp.tv_nsec / 1000000;
+}
+
+/**
+ * Reads `CLOCK_REALTIME_COARSE` in milliseconds, or `CLOCK_REALTIME` if the
+ * coarse clock is unavailable or its resolution is coarser than a millisecond.
+ */
+static inline uint64_t uuidv7_clock_coarse_ms(void) {
+#ifdef CLOCK_REALTIME_COARSE
+  // -1: unknown, 0: unusable, 1: usable; racing threads store the same value
+  static int usable = -1;
+  int u = __atomic_load_n(&usable, __ATOMIC_RELAXED);
+  if (u < 0) {
+    struct timespec res;
+    u = clock_getres(CLOCK_REALTIME_COARSE, &res) == 0 && res.tv_sec == 0 &&
+        res.tv_nsec <= 1000000;
+    __atomic_store_n(&usable, u, __ATOMIC_RELAXED);
+  }
+  if (u) {
+    struct timespec tp;
+    clock_gettime(CLOCK_REALTIME_COARSE, &tp);
+    return (uint64_t)tp.tv_sec * 1000 + tp.tv_nsec / 1000000;
+  }
+#endif
+  return uuidv7_clock_realtime_ms();
+}
+
+/**
+ * Computes the current time in milliseconds from the x86 time-stamp counter,
+ * or reads `CLOCK_REALTIME` on other architectures.
+ *
+ * Each thread keeps its own calibration: it reads `CLOCK_REALTIME` on every
+ * call until a millisecond has passed since the first call, estimates the
+ * counter frequency, and then re-syncs to `CLOCK_REALTIME` and refines the
+ * estimate every `UUIDV7_CLOCK_TSC_RESYNC_MS` milliseconds. The counter must
+ * be invariant and synchronized across cores, as it is on modern x86 CPUs.
+ */
+static inline uint64_t uuidv7_clock_tsc_ms(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  static __thread uint64_t base_tsc = 0, base_ns = 0;
+  static __thread uint64_t mult = 0; // nanoseconds per tick as 32.32 fixed
+  static __thread uint64_t resync_ticks = 0;
+
+  uint64_t tsc = __rdtsc();
+  if (mult != 0 && tsc - base_tsc < resync_ticks) {
+    return (base_ns + (((tsc - base_tsc) * mult) >> 32)) / 1000000;
+  }
+
+  uint64_t ns = uuidv7_clock_realtime_ns();
+  if (base_tsc == 0 || tsc <= base_tsc || ns < base_ns ||
+      ns - base_ns > (uint64_t)10 * UUIDV7_CLOCK_TSC_RESYNC_MS * 1000000) {
+    // start over after a clock step or a long gap since the last call
+    base_tsc = tsc;
+    base_ns = ns;
+    mult = 0;
+  } else if (ns - base_ns >= 1000000) {
+    mult = ((ns - base_ns) << 32) / (tsc - base_tsc);
+    resync_ticks = mult == 0 ? 0
+                             : ((uint64_t)UUIDV7_CLOCK_TSC_RESYNC_MS * 1000000
+                                << 32) / mult;
+    base_tsc = tsc;
+    base_ns = ns;
+  }
+  return ns / 1000000;
+#else
+  return uuidv7_clock_realtime_ms();
+#endif
+}
+
+/** Latest time in milliseconds published by the ticker thread. */
+static uint64_t uuidv7_clock_ticker_value = 0;
+
+/** Non-zero while the ticker thread is running in this process. */
+static int uuidv7_clock_ticker_running = 0;
+
+static inline void *uuidv7_clock_ticker_main(void *arg) {
+  (void)arg;
+  for (;;) {
+    uint64_t ns = uuidv7_clock_realtime_ns();
+    __atomic_store_n(&uuidv7_clock_ticker_value, ns / 1000000,
+                     __ATOMIC_RELAXED);
+
+    // sleep until the next millisecond boundary
+    struct timespec tp;
+    tp.tv_sec = 0;
+    tp.tv_nsec = 1000000 - ns % 1000000;
+    nanosleep(&tp, NULL);
+  }
+  return NULL;
+}
+
+static inline void uuidv7_clock_ticker_on_fork(void) {
+  // the ticker thread does not survive fork(), so restart it in the child
+  __atomic_store_n(&uuidv7_clock_ticker_running, 0, __ATOMIC_RELAXED);
+}
+
+static inline void uuidv7_clock_ticker_register_fork_handler(void) {
+  pthread_atfork(NULL, NULL, uuidv7_clock_ticker_on_fork);
+}
+
+/**
+ * Reads the time in milliseconds published by a background ticker thread,
+ * starting the thread on the first call in the process.
+ *
+ * The ticker thread is detached and runs until the process exits. If the
+ * thread cannot be started, this function reads `CLOCK_REALTIME` instead. The
+ * published value may lag behind `CLOCK_REALTIME` while the ticker thread is
+ * not scheduled.
+ */
+static inline uint64_t uuidv7_clock_ticker_ms(void) {
+  if (!__atomic_load_n(&uuidv7_clock_ticker_running, __ATOMIC_ACQUIRE)) {
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, uuidv7_clock_ticker_register_fork_handler);
+
+    int expected = 0;
+    if (__atomic_compare_exchange_n(&uuidv7_clock_ticker_running, &expected,
+                                    -1, 0, __ATOMIC_ACQUIRE,
+                                    __ATOMIC_RELAXED)) {
+      // publish the current time before other threads may read it
+      __atomic_store_n(&uuidv7_clock_ticker_value, uuidv7_clock_realtime_ms(),
+                       __ATOMIC_RELAXED);
+
+      pthread_t thread;
+      pthread_attr_t attr;
+      pthread_attr_init(&attr);
+      pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+      int err = pthread_create(&thread, &attr, uuidv7_clock_ticker_main, NULL);
+      pthread_attr_destroy(&attr);
+      __atomic_store_n(&uuidv7_clock_ticker_running, err == 0 ? 1 : 0,
+                       __ATOMIC_RELEASE);
+      if (err != 0) {
+        return uuidv7_clock_realtime_ms();
+      }
+    } else if (expected != 1) {
+      // another thread is starting the ticker
+      return uuidv7_clock_realtime_ms();
+    }
+  }
+  return __atomic_load_n(&uuidv7_clock_ticker_value, __ATOMIC_RELAXED);
+}
+
+/** Reads the current Unix time in milliseconds from the selected source. */
+static inline uint64_t uuidv7_clock_now_ms(void) {
+#if UUIDV7_CLOCK == UUIDV7_CLOCK_COARSE
+  return uuidv7_clock_coarse_ms();
+#elif UUIDV7_CLOCK == UUIDV7_CLOCK_TSC
+  return uuidv7_clock_tsc_ms();
+#elif UUIDV7_CLOCK == UUIDV7_CLOCK_TICKER
+  return uuidv7_clock_ticker_ms();
+#else
+  return uuidv7_clock_realtime_ms();
+#endif
+}
+
+#endif /* #ifndef UUIDV7_CLOCK_H_BAEDKYFQ */
@@ -0,0 +1,80 @@
+/**
+ * @file
+ *
+ * Thread-safe, lock-free `uuidv7_new()` implementation for POSIX platforms.
+ *
+ * The previous timestamp and counter are shared by all threads in a single
+ * 64-bit word that is updated with compare-and-swap, next to the full timestamp
+ * that restores the upper timestamp bits the word lacks, so UUIDs generated by
+ * different threads are unique and ordered as the updates are. Each thread
+ * keeps its own pool of random bytes so that only the state word is shared.
+ */
+#include "uuidv7.h"
+#include "uuidv7_clock.h"
+#include "uuidv7_rand.h"
+#include "uuidv7_state64.h"
+
+#define UUIDV7_STATS_IMPLEMENTATION
+#include "uuidv7_stats.h"
+
+/**
+ * Shared generator state: the state word, which is zero until the first UUID is
+ * generated, and the full timestamp of its latest update.
+ */
+static struct {
+  uint64_t word;
+  uint64_t timestamp;
+} state = {0, 0};
+
+/** Generates a UUID from the given time; the body of `uuidv7_new()`. */
+static int generate_at(uint8_t *uuid_out, uint64_t unix_ts_ms) {
+  static __thread uuidv7_rand_t rng;
+  static __thread int rng_ready = 0;
+
+  if (!rng_ready) {
+    if (uuidv7_rand_init(&rng) != 0) {
+      return UUIDV7_RAND_ERR_ENTROPY;
+    }
+    rng_ready = 1;
+  }
+  uuidv7_stats_record_refill(sizeof(rng.buffer) - rng.pos < 10);
+  const uint8_t *rand_bytes = uuidv7_rand_peek(&rng, 10);
+  if (rand_bytes == NULL) {
+    return UUIDV7_RAND_ERR_ENTROPY;
+  }
+
+  uint64_t prev = __atomic_load_n(&state.word, __ATOMIC_ACQUIRE);
+  for (;;) {
+    uint8_t uuid_prev[16];
+    uint64_t timestamp = __atomic_load_n(&state.timestamp, __ATOMIC_RELAXED);
+    int8_t status = uuidv7_generate(
+        uuid_out, unix_ts_ms, rand_bytes,
+        uuidv7_state64_unpack(prev, timestamp, uuid_prev));
+    if (status < 0) {
+      return status;
+    }
+
+    // publish the new state; on failure, retry with the state updated by
+    // another thread, reusing the same random bytes. The release ordering makes
+    // the timestamp stored first visible to threads that read the new state.
+    uint64_t next = uuidv7_state64_pack(uuid_out);
+    __atomic_store_n(&state.timestamp, uuidv7_get_timestamp(uuid_out),
+                     __ATOMIC_RELAXED);
+    if (__atomic_compare_exchange_n(&state.word, &prev, next, 1,
+                                    __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+      uuidv7_rand_consume(&rng, uuidv7_status_n_rand_consumed(status));
+      return status;
+    }
+  }
+}
+
+int uuidv7_new(uint8_t *uuid_out) {
+  uint64_t t0 = uuidv7_stats_begin();
+  uint64_t unix_ts_ms = uuidv7_clock_now_ms();
+  int status = generate_at(uuid_out, unix_ts_ms);
+  if (status >= 0) {
+    uuidv7_stats_record_skew(unix_ts_ms, uuid_out);
+  }
+  uuidv7_stats_record(t0, status);
+  return status;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file
+ *
+ * Thread-safe `uuidv7_new()` implementation for POSIX platforms that leases
+ * blocks of counter values to threads.
+ *
+ * Each thread reserves a contiguous block of counter values for the current
+ * timestamp from the shared state word and then generates UUIDs from the block
+ * without touching shared memory. A thread returns to the shared state only
+ * when its block is exhausted or the clock advances past the timestamp of the
+ * block, so the shared cache line is written once per block rather than once
+ * per UUID.
+ *
+ * UUIDs are unique across threads and monotonically increasing within each
+ * thread, but UUIDs generated by different threads are ordered only per block:
+ * a thread may hand out a UUID from an older block after another thread has
+ * leased a newer one.
+ */
+#include "uuidv7.h"
+#include "uuidv7_clock.h"
+#include "uuidv7_rand.h"
+#include "uuidv7_state64.h"
+
+#define UUIDV7_STATS_IMPLEMENTATION
+#include "uuidv7_stats.h"
+
+#include <string.h>
+
+#ifndef UUIDV7_LEASE_SIZE
+/** Number of counter values leased to a thread at once. */
+#define UUIDV7_LEASE_SIZE (1024)
+#endif
+
+/**
+ * Shared generator state: the state word, which is zero until the first UUID is
+ * generated, and the full timestamp of its latest update.
+ */
+static struct {
+  uint64_t word;
+  uint64_t timestamp;
+} state = {0, 0};
+
+/** Generates a UUID from the given time; the body of `uuidv7_new()`. */
+static int generate_at(uint8_t *uuid_out, uint64_t unix_ts_ms) {
+  static __thread uuidv7_rand_t rng;
+  static __thread int rng_ready = 0;
+
+  // last UUID generated by this thread and the remaining counter values of the
+  // block leased for its timestamp
+  static __thread uint8_t lease_prev[16] = {0};
+  static __thread uint64_t lease_timestamp = 0;
+  static __thread uint64_t lease_remaining = 0;
+
+  if (!rng_ready) {
+    if (uuidv7_rand_init(&rng) != 0) {
+      return UUIDV7_RAND_ERR_ENTROPY;
+    }
+    rng_ready = 1;
+  }
+  uuidv7_stats_record_refill(sizeof(rng.buffer) - rng.pos < 10);
+  const uint8_t *rand_bytes = uuidv7_rand_peek(&rng, 10);
+  if (rand_bytes == NULL) {
+    return UUIDV7_RAND_ERR_ENTROPY;
+  }
+
+  int8_t status;
+  if (lease_remaining > 0 && unix_ts_ms <= lease_timestamp &&
+      unix_ts_ms + 10000 >= lease_timestamp) {
+    // the leased block is still usable, so this always increments the counter
+    status = uuidv7_generate(lease_prev, unix_ts_ms, rand_bytes, lease_prev);
+    lease_remaining--;
+  } else {
+    uint64_t prev = __atomic_load_n(&state.word, __ATOMIC_ACQUIRE);
+    for (;;) {
+      uint8_t uuid_prev[16];
+      uint64_t timestamp =
+          __atomic_load_n(&state.timestamp, __ATOMIC_RELAXED);
+      status = uuidv7_generate(
+          lease_prev, unix_ts_ms, rand_bytes,
+          uuidv7_state64_unpack(prev, timestamp, uuid_prev));
+      if (status < 0) {
+        lease_remaining = 0;
+        return status;
+      }
+
+      // reserve the counter values following the one just generated
+      uint64_t next = uuidv7_state64_pack(lease_prev);
+      uint64_t counter = next & UUIDV7_STATE64_COUNTER_MASK;
+      uint64_t n_reserved = UUIDV7_STATE64_COUNTER_MASK - counter;
+      if (n_reserved > UUIDV7_LEASE_SIZE - 1) {
+        n_reserved = UUIDV7_LEASE_SIZE - 1;
+      }
+
+      // publish the timestamp first, as in `uuidv7_new_atomic.c`
+      __atomic_store_n(&state.timestamp, uuidv7_get_timestamp(lease_prev),
+                       __ATOMIC_RELAXED);
+      if (__atomic_compare_exchange_n(&state.word, &prev, next + n_reserved, 1,
+                                      __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+        lease_timestamp = 0;
+        for (int i = 0; i < 6; i++) {
+          lease_timestamp = (lease_timestamp << 8) | lease_prev[i];
+        }
+        lease_remaining = n_reserved;
+        break;
+      }
+    }
+  }
+
+  uuidv7_rand_consume(&rng, uuidv7_status_n_rand_consumed(status));
+  memcpy(uuid_out, lease_prev, 16);
+  return status;
+}
+
+int uuidv7_new(uint8_t *uuid_out) {
+  uint64_t t0 = uuidv7_stats_begin();
+  uint64_t unix_ts_ms = uuidv7_clock_now_ms();
+  int status = generate_at(uuid_out, unix_ts_ms);
+  if (status >= 0) {
+    uuidv7_stats_record_skew(unix_ts_ms, uuid_out);
+  }
+  uuidv7_stats_record(t0, status);
+  return status;
+}
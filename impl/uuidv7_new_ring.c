@@ -0,0 +1,345 @@
+/**
+ * @file
+ *
+ * Thread-safe `uuidv7_new()` implementation for POSIX platforms that hands out
+ * UUIDs pre-generated by a background producer thread.
+ *
+ * The producer keeps a bounded ring of `UUIDV7_RING_SIZE` ready-made UUIDs,
+ * stored both as bytes and as preformatted strings, and tops it up whenever it
+ * falls to `UUIDV7_RING_LOW_WATERMARK`. Consumers take a UUID with a single
+ * compare-and-swap, so clock reads, random refills, and lock waits happen on
+ * the producer thread rather than on the caller's path.
+ *
+ * All UUIDs are generated in one sequence under the producer lock and pushed to
+ * the ring in that order, and consumers take ring slots in order, so a UUID is
+ * greater than every UUID handed out before the call began. If a consumer finds
+ * the ring empty, it takes the producer lock, which guarantees that no pushed
+ * UUID is left behind, and generates a UUID itself. `uuidv7_ring_get_stats()`
+ * reports how often that happens.
+ *
+ * A UUID carries the time at which it was pre-generated, which precedes the
+ * time it is handed out while the ring is consumed slowly. Each slot therefore
+ * records the clock reading it was generated from, and a UUID older than
+ * `UUIDV7_RING_MAX_AGE_MS` is discarded rather than handed out: the producer
+ * drops such UUIDs from the head of the ring whenever it wakes up and refills
+ * the ring with fresh ones, and a consumer that takes one skips to the next
+ * slot, generating a UUID itself if none is fresh. Discarding never reorders
+ * the UUIDs handed out, but the check costs consumers a read of the
+ * `UUIDV7_CLOCK` source per call.
+ */
+#include "uuidv7_new_ring.h"
+
+#include "uuidv7.h"
+#include "uuidv7_clock.h"
+#include "uuidv7_rand.h"
+
+#define UUIDV7_STATS_IMPLEMENTATION
+#include "uuidv7_stats.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef UUIDV7_RING_SIZE
+/** Capacity of the ring, which must be a power of two. */
+#define UUIDV7_RING_SIZE (1024)
+#endif
+
+#ifndef UUIDV7_RING_LOW_WATERMARK
+/** Number of UUIDs left in the ring at or below which it is refilled. */
+#define UUIDV7_RING_LOW_WATERMARK (UUIDV7_RING_SIZE / 2)
+#endif
+
+#ifndef UUIDV7_RING_MAX_AGE_MS
+/** Age in milliseconds beyond which a pre-generated UUID is discarded. */
+#define UUIDV7_RING_MAX_AGE_MS (1000)
+#endif
+
+/** Slot of the ring; `seq` tells whether the slot is filled or free. */
+struct slot {
+  uint64_t seq;
+  uint64_t unix_ts_ms; // clock reading the UUID was generated from
+  uint8_t uuid[16];
+  char string[37];
+  int8_t status;
+};
+
+static struct {
+  struct slot slots[UUIDV7_RING_SIZE];
+
+  // positions of the next slot to fill and to take, kept on separate lines
+  uint64_t push_pos;
+  char pad0[64 - sizeof(uint64_t)];
+  uint64_t pop_pos;
+  char pad1[64 - sizeof(uint64_t)];
+
+  uint64_t n_empty;
+  uint64_t n_expired;
+  int producer_waiting;
+  int producer_state; // 0: not started, 1: running, 2: shut down
+
+  // protects everything below and serializes generation and pushes
+  pthread_mutex_t lock;
+  pthread_cond_t wakeup;
+  pthread_t producer;
+  uint8_t uuid_prev[16];
+  int has_prev;
+} ring;
+
+/** Random bytes used by whichever thread generates under the lock. */
+static uuidv7_rand_t rng;
+static int rng_ready = 0;
+
+/**
+ * Generates the next UUID in the sequence and stores the clock reading it is
+ * generated from in `unix_ts_ms_out`; the lock must be held.
+ */
+static int generate_locked(uint8_t *uuid_out, uint64_t *unix_ts_ms_out) {
+  if (!rng_ready) {
+    if (uuidv7_rand_init(&rng) != 0) {
+      return UUIDV7_RAND_ERR_ENTROPY;
+    }
+    rng_ready = 1;
+  }
+  uuidv7_stats_record_refill(sizeof(rng.buffer) - rng.pos < 10);
+  const uint8_t *rand_bytes = uuidv7_rand_peek(&rng, 10);
+  if (rand_bytes == NULL) {
+    return UUIDV7_RAND_ERR_ENTROPY;
+  }
+
+  uint64_t unix_ts_ms = *unix_ts_ms_out = uuidv7_clock_now_ms();
+  int8_t status = uuidv7_generate(uuid_out, unix_ts_ms, rand_bytes,
+                                  ring.has_prev ? ring.uuid_prev : NULL);
+  if (status >= 0) {
+    uuidv7_stats_record_skew(unix_ts_ms, uuid_out);
+    uuidv7_rand_consume(&rng, uuidv7_status_n_rand_consumed(status));
+    memcpy(ring.uuid_prev, uuid_out, 16);
+    ring.has_prev = 1;
+  }
+  return status;
+}
+
+/** Tells whether a filled slot is too old to be handed out. */
+static int expired(const struct slot *s, uint64_t now_ms) {
+  return now_ms > s->unix_ts_ms + UUIDV7_RING_MAX_AGE_MS;
+}
+
+/** Number of UUIDs in the ring; sequentially consistent for the handshake. */
+static uint64_t level(void) {
+  return __atomic_load_n(&ring.push_pos, __ATOMIC_SEQ_CST) -
+         __atomic_load_n(&ring.pop_pos, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Fills free slots until the ring is full; the lock must be held.
+ *
+ * @return Zero on success or non-zero integer if generation failed.
+ */
+static int fill_locked(void) {
+  for (;;) {
+    uint64_t pos = ring.push_pos;
+    struct slot *s = &ring.slots[pos & (UUIDV7_RING_SIZE - 1)];
+    if (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != pos) {
+      return 0; // full
+    }
+    int status = generate_locked(s->uuid, &s->unix_ts_ms);
+    if (status < 0) {
+      return -1; // leave the error to consumers that generate directly
+    }
+    s->status = (int8_t)status;
+    uuidv7_to_string(s->uuid, s->string);
+    __atomic_store_n(&s->seq, pos + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring.push_pos, pos + 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+/**
+ * Discards expired UUIDs from the head of the ring; the lock must be held, so
+ * that the slots being examined are not refilled meanwhile.
+ */
+static void expire_locked(void) {
+  uint64_t now_ms = uuidv7_clock_now_ms();
+  for (;;) {
+    uint64_t pos = __atomic_load_n(&ring.pop_pos, __ATOMIC_RELAXED);
+    struct slot *s = &ring.slots[pos & (UUIDV7_RING_SIZE - 1)];
+    if (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != pos + 1 ||
+        !expired(s, now_ms)) {
+      return; // empty or fresh
+    }
+    if (__atomic_compare_exchange_n(&ring.pop_pos, &pos, pos + 1, 0,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+      __atomic_add_fetch(&ring.n_expired, 1, __ATOMIC_RELAXED);
+      __atomic_store_n(&s->seq, pos + UUIDV7_RING_SIZE, __ATOMIC_RELEASE);
+    }
+  }
+}
+
+static void *producer_main(void *arg) {
+  (void)arg;
+  pthread_mutex_lock(&ring.lock);
+  while (ring.producer_state == 1) {
+    expire_locked();
+    int failed = fill_locked() != 0;
+
+    // announce the wait before checking the level, while consumers take a slot
+    // before checking the flag, so that either side sees the other. A wakeup
+    // can still be lost just before the wait starts, hence the timeout.
+    __atomic_store_n(&ring.producer_waiting, 1, __ATOMIC_SEQ_CST);
+    if (failed || level() > UUIDV7_RING_LOW_WATERMARK) {
+      struct timespec deadline;
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_nsec += 10000000;
+      if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+      }
+      pthread_cond_timedwait(&ring.wakeup, &ring.lock, &deadline);
+    }
+    __atomic_store_n(&ring.producer_waiting, 0, __ATOMIC_RELAXED);
+  }
+  pthread_mutex_unlock(&ring.lock);
+  return NULL;
+}
+
+static void init_ring(void) {
+  for (uint64_t i = 0; i < UUIDV7_RING_SIZE; i++) {
+    ring.slots[i].seq = i;
+  }
+  ring.push_pos = ring.pop_pos = 0;
+  ring.n_expired = 0; // n_popped is derived from pop_pos
+  ring.producer_waiting = 0;
+  ring.producer_state = 0;
+  pthread_mutex_init(&ring.lock, NULL);
+  pthread_cond_init(&ring.wakeup, NULL);
+}
+
+static void on_fork_prepare(void) { pthread_mutex_lock(&ring.lock); }
+
+static void on_fork_parent(void) { pthread_mutex_unlock(&ring.lock); }
+
+static void on_fork_child(void) {
+  // the producer thread is gone and the UUIDs in the ring are shared with the
+  // parent, so start over with an empty ring but keep the sequence
+  init_ring();
+}
+
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+static void init(void) {
+  init_ring();
+  pthread_atfork(on_fork_prepare, on_fork_parent, on_fork_child);
+}
+
+/**
+ * Takes a slot from the ring, or generates a UUID directly if the ring is
+ * empty, and copies it to the given locations, each of which may be NULL.
+ */
+static int take(uint8_t *uuid_out, char *string_out) {
+  uint64_t t0 = uuidv7_stats_begin();
+  pthread_once(&init_once, init);
+
+  if (__atomic_load_n(&ring.producer_state, __ATOMIC_ACQUIRE) == 0) {
+    pthread_mutex_lock(&ring.lock);
+    if (ring.producer_state == 0) {
+      ring.producer_state = 1;
+      if (pthread_create(&ring.producer, NULL, producer_main, NULL) != 0) {
+        ring.producer_state = 2; // serve every call directly
+      }
+    }
+    pthread_mutex_unlock(&ring.lock);
+  }
+
+  uint64_t now_ms = uuidv7_clock_now_ms();
+  int locked = 0;
+  uint64_t pos = __atomic_load_n(&ring.pop_pos, __ATOMIC_RELAXED);
+  for (;;) {
+    struct slot *s = &ring.slots[pos & (UUIDV7_RING_SIZE - 1)];
+    uint64_t seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+    if (seq == pos + 1) {
+      if (__atomic_compare_exchange_n(&ring.pop_pos, &pos, pos + 1, 1,
+                                      __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        if (expired(s, now_ms)) {
+          // skipping it keeps the order, as the following slots are newer
+          __atomic_add_fetch(&ring.n_expired, 1, __ATOMIC_RELAXED);
+          __atomic_store_n(&s->seq, pos + UUIDV7_RING_SIZE, __ATOMIC_RELEASE);
+          pos++;
+          continue;
+        }
+        if (uuid_out != NULL) {
+          memcpy(uuid_out, s->uuid, 16);
+        }
+        if (string_out != NULL) {
+          memcpy(string_out, s->string, 37);
+        }
+        int status = s->status;
+        __atomic_store_n(&s->seq, pos + UUIDV7_RING_SIZE, __ATOMIC_RELEASE);
+        if (locked) {
+          pthread_mutex_unlock(&ring.lock);
+        } else if (level() <= UUIDV7_RING_LOW_WATERMARK &&
+                   __atomic_exchange_n(&ring.producer_waiting, 0,
+                                       __ATOMIC_SEQ_CST)) {
+          pthread_cond_signal(&ring.wakeup);
+        }
+        uuidv7_stats_record(t0, status);
+        return status;
+      }
+    } else if (seq < pos + 1) {
+      if (locked) {
+        break; // empty with pushes excluded
+      }
+      // the ring looks empty; take the lock so that no push is in flight
+      pthread_mutex_lock(&ring.lock);
+      locked = 1;
+      pos = __atomic_load_n(&ring.pop_pos, __ATOMIC_RELAXED);
+    } else {
+      pos = __atomic_load_n(&ring.pop_pos, __ATOMIC_RELAXED);
+    }
+  }
+
+  // every pushed UUID has been taken, so one generated now is greater than
+  // all of them and less than every UUID pushed later
+  __atomic_add_fetch(&ring.n_empty, 1, __ATOMIC_RELAXED);
+  uint8_t uuid[16];
+  uint64_t unix_ts_ms;
+  int status = generate_locked(uuid, &unix_ts_ms);
+  if (ring.producer_state == 1) {
+    pthread_cond_signal(&ring.wakeup);
+  }
+  pthread_mutex_unlock(&ring.lock);
+  if (status >= 0) {
+    if (uuid_out != NULL) {
+      memcpy(uuid_out, uuid, 16);
+    }
+    if (string_out != NULL) {
+      uuidv7_to_string(uuid, string_out);
+    }
+  }
+  uuidv7_stats_record(t0, status);
+  return status;
+}
+
+int uuidv7_new(uint8_t *uuid_out) { return take(uuid_out, NULL); }
+
+int uuidv7_ring_new_string(char *string_out) {
+  return take(NULL, string_out);
+}
+
+void uuidv7_ring_shutdown(void) {
+  pthread_once(&init_once, init);
+
+  pthread_mutex_lock(&ring.lock);
+  int was_running = ring.producer_state == 1;
+  __atomic_store_n(&ring.producer_state, 2, __ATOMIC_RELEASE);
+  pthread_cond_signal(&ring.wakeup);
+  pthread_mutex_unlock(&ring.lock);
+  if (was_running) {
+    pthread_join(ring.producer, NULL);
+  }
+}
+
+void uuidv7_ring_get_stats(uuidv7_ring_stats_t *stats_out) {
+  stats_out->n_expired = __atomic_load_n(&ring.n_expired, __ATOMIC_RELAXED);
+  stats_out->n_popped = __atomic_load_n(&ring.pop_pos, __ATOMIC_RELAXED) -
+                        stats_out->n_expired;
+  stats_out->n_empty = __atomic_load_n(&ring.n_empty, __ATOMIC_RELAXED);
+}
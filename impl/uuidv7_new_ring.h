@@ -0,0 +1,60 @@
+/**
+ * @file
+ *
+ * Additional functions provided by `uuidv7_new_ring.c`.
+ */
+#ifndef UUIDV7_NEW_RING_H_BAEDKYFQ
+#define UUIDV7_NEW_RING_H_BAEDKYFQ
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Counters reported by `uuidv7_ring_get_stats()`. */
+typedef struct {
+  /** Number of UUIDs taken from the ring and handed out. */
+  uint64_t n_popped;
+
+  /**
+   * Number of calls that found the ring empty and generated a UUID while
+   * holding the producer lock.
+   */
+  uint64_t n_empty;
+
+  /**
+   * Number of UUIDs discarded because they were older than
+   * `UUIDV7_RING_MAX_AGE_MS` when taken from the ring.
+   */
+  uint64_t n_expired;
+} uuidv7_ring_stats_t;
+
+/**
+ * Takes a pre-generated UUID from the ring in the 8-4-4-4-12 hexadecimal
+ * string representation, which the producer thread has already formatted.
+ *
+ * @param string_out  Character array where the encoded string is stored. Its
+ *                    length must be 37 (36 digits + NUL) or longer.
+ * @return            Return value of `uuidv7_new()`.
+ */
+int uuidv7_ring_new_string(char *string_out);
+
+/**
+ * Stops and joins the producer thread. UUIDs left in the ring are still handed
+ * out, after which every call generates a UUID directly.
+ */
+void uuidv7_ring_shutdown(void);
+
+/**
+ * Reads the counters of the ring.
+ *
+ * @param stats_out  Location where the counters are stored.
+ */
+void uuidv7_ring_get_stats(uuidv7_ring_stats_t *stats_out);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* #ifndef UUIDV7_NEW_RING_H_BAEDKYFQ */
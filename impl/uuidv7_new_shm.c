@@ -0,0 +1,149 @@
+/**
+ * @file
+ *
+ * Process-shared, lock-free `uuidv7_new()` implementation for POSIX platforms.
+ *
+ * The shared state of `uuidv7_new_atomic.c` is placed in a POSIX shared memory
+ * object so that all processes on a host that open the same object, such as
+ * pre-forked workers, share a single monotonic sequence. The object is named by
+ * the `UUIDV7_SHM_NAME` environment variable or, if unset, the
+ * `UUIDV7_SHM_NAME` macro. It is created zero-filled on first use, and the zero
+ * state means that no UUID has been generated yet, so no process has to
+ * initialize it.
+ *
+ * The object holds the state word and the full timestamp of its latest update,
+ * from which the upper timestamp bits of the state word are restored, so a
+ * state left by processes that ran long ago is restored exactly, however long
+ * the object has been idle. The state word is replaced by a single
+ * compare-and-swap, so a process that dies at any point leaves either the old
+ * or the new state behind and never blocks the others.
+ *
+ * This implementation returns `UUIDV7_SHM_ERR_MAP` (-257) if the shared memory
+ * object cannot be opened or mapped.
+ */
+#include "uuidv7.h"
+#include "uuidv7_clock.h"
+#include "uuidv7_rand.h"
+#include "uuidv7_state64.h"
+
+#define UUIDV7_STATS_IMPLEMENTATION
+#include "uuidv7_stats.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef UUIDV7_SHM_NAME
+/** Default name of the shared memory object. */
+#define UUIDV7_SHM_NAME "/uuidv7_h_state"
+#endif
+
+#ifndef UUIDV7_SHM_MODE
+/** Permission bits of the shared memory object when it is created. */
+#define UUIDV7_SHM_MODE (0600)
+#endif
+
+/**
+ * Implementation-dependent code returned when the shared memory object cannot
+ * be opened or mapped.
+ */
+#define UUIDV7_SHM_ERR_MAP (-257)
+
+/**
+ * Layout of the shared memory object: the state word and the full timestamp of
+ * its latest update, as in `uuidv7_new_atomic.c`.
+ */
+struct uuidv7_shm_state {
+  uint64_t word;
+  uint64_t timestamp;
+};
+
+/** Shared generator state mapped from the shared memory object. */
+static struct uuidv7_shm_state *state = NULL;
+
+static void map_state(void) {
+  const char *name = getenv("UUIDV7_SHM_NAME");
+  if (name == NULL || name[0] == '\0') {
+    name = UUIDV7_SHM_NAME;
+  }
+
+  int fd = shm_open(name, O_RDWR | O_CREAT, UUIDV7_SHM_MODE);
+  if (fd < 0) {
+    return;
+  }
+
+  // extend a new object; racing processes set the same size, and the bytes
+  // added are zero, so no other initialization is necessary
+  struct stat st;
+  if (fstat(fd, &st) == 0 &&
+      (st.st_size >= (off_t)sizeof(struct uuidv7_shm_state) ||
+       ftruncate(fd, sizeof(struct uuidv7_shm_state)) == 0)) {
+    void *p = mmap(NULL, sizeof(struct uuidv7_shm_state),
+                   PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p != MAP_FAILED) {
+      state = (struct uuidv7_shm_state *)p;
+    }
+  }
+  close(fd);
+}
+
+/** Generates a UUID from the given time; the body of `uuidv7_new()`. */
+static int generate_at(uint8_t *uuid_out, uint64_t unix_ts_ms) {
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  static __thread uuidv7_rand_t rng;
+  static __thread int rng_ready = 0;
+
+  // the mapping is inherited across fork() and keeps pointing to the object
+  pthread_once(&once, map_state);
+  if (state == NULL) {
+    return UUIDV7_SHM_ERR_MAP;
+  }
+
+  if (!rng_ready) {
+    if (uuidv7_rand_init(&rng) != 0) {
+      return UUIDV7_RAND_ERR_ENTROPY;
+    }
+    rng_ready = 1;
+  }
+  uuidv7_stats_record_refill(sizeof(rng.buffer) - rng.pos < 10);
+  const uint8_t *rand_bytes = uuidv7_rand_peek(&rng, 10);
+  if (rand_bytes == NULL) {
+    return UUIDV7_RAND_ERR_ENTROPY;
+  }
+
+  uint64_t prev = __atomic_load_n(&state->word, __ATOMIC_ACQUIRE);
+  for (;;) {
+    uint8_t uuid_prev[16];
+    uint64_t timestamp = __atomic_load_n(&state->timestamp, __ATOMIC_RELAXED);
+    int8_t status = uuidv7_generate(
+        uuid_out, unix_ts_ms, rand_bytes,
+        uuidv7_state64_unpack(prev, timestamp, uuid_prev));
+    if (status < 0) {
+      return status;
+    }
+
+    // lock-free atomics on the same address are coherent across processes
+    uint64_t next = uuidv7_state64_pack(uuid_out);
+    __atomic_store_n(&state->timestamp, uuidv7_get_timestamp(uuid_out),
+                     __ATOMIC_RELAXED);
+    if (__atomic_compare_exchange_n(&state->word, &prev, next, 1,
+                                    __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+      uuidv7_rand_consume(&rng, uuidv7_status_n_rand_consumed(status));
+      return status;
+    }
+  }
+}
+
+int uuidv7_new(uint8_t *uuid_out) {
+  uint64_t t0 = uuidv7_stats_begin();
+  uint64_t unix_ts_ms = uuidv7_clock_now_ms();
+  int status = generate_at(uuid_out, unix_ts_ms);
+  if (status >= 0) {
+    uuidv7_stats_record_skew(unix_ts_ms, uuid_out);
+  }
+  uuidv7_stats_record(t0, status);
+  return status;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file
+ *
+ * Buffered ChaCha20-based random byte generator for `uuidv7_new()`
+ * implementations.
+ *
+ * Each generator object is meant to be owned by a single thread. It expands a
+ * 256-bit key obtained from `getentropy()` into a large buffer of ChaCha20
+ * keystream, so the kernel is called only when the generator is seeded. The
+ * first 32 bytes of every refill replace the key so that earlier outputs cannot
+ * be recovered from the current state, and the key is reseeded from the kernel
+ * after every `UUIDV7_RAND_RESEED_INTERVAL` bytes.
+ *
+ * `pthread_atfork()` handlers detect forks, and the child discards the buffer
+ * inherited from its parent and reseeds before producing any byte, so parent
+ * and child never share a stream.
+ */
+#ifndef UUIDV7_RAND_H_BAEDKYFQ
+#define UUIDV7_RAND_H_BAEDKYFQ
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <sys/random.h> // for macOS getentropy()
+
+#ifndef UUIDV7_RAND_BUFFER_SIZE
+/** Size of the buffer of random bytes held by each generator. */
+#define UUIDV7_RAND_BUFFER_SIZE (4096)
+#endif
+
+#ifndef UUIDV7_RAND_RESEED_INTERVAL
+/** Number of bytes generated between reseeds from the kernel. */
+#define UUIDV7_RAND_RESEED_INTERVAL ((uint64_t)1 << 20)
+#endif
+
+/**
+ * Implementation-dependent code that `uuidv7_new()` implementations return
+ * when the kernel entropy source fails.
+ */
+#define UUIDV7_RAND_ERR_ENTROPY (-256)
+
+/** Buffered random byte generator. */
+typedef struct {
+  /** Current ChaCha20 key. */
+  uint32_t key[8];
+
+  /** Number of bytes that can be generated before the next reseed. */
+  uint64_t n_until_reseed;
+
+  /** Value of the fork counter when the generator was last seeded. */
+  unsigned fork_count;
+
+  /** Position of the first unconsumed byte in `buffer`. */
+  size_t pos;
+
+  /** Random bytes; those after `pos` are not consumed yet. */
+  uint8_t buffer[UUIDV7_RAND_BUFFER_SIZE];
+} uuidv7_rand_t;
+
+/**
+ * Computes a ChaCha20 block.
+ *
+ * @param input  16-word ChaCha20 input state.
+ * @param out    64-byte byte array where the keystream block is stored.
+ */
+static inline void uuidv7_chacha20_block(const uint32_t *input, uint8_t *out) {
+#define UUIDV7_ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define UUIDV7_QUARTER_ROUND(a, b, c, d)                                       \
+  x[a] += x[b], x[d] ^= x[a], x[d] = UUIDV7_ROTL32(x[d], 16);                  \
+  x[c] += x[d], x[b] ^= x[c], x[b] = UUIDV7_ROTL32(x[b], 12);                  \
+  x[a] += x[b], x[d] ^= x[a], x[d] = UUIDV7_ROTL32(x[d], 8);                   \
+  x[c] += x[d], x[b] ^= x[c], x[b] = UUIDV7_ROTL32(x[b], 7)
+
+  uint32_t x[16];
+  memcpy(x, input, sizeof(x));
+  for (int i = 0; i < 10; i++) {
+    UUIDV7_QUARTER_ROUND(0, 4, 8, 12);
+    UUIDV7_QUARTER_ROUND(1, 5, 9, 13);
+    UUIDV7_QUARTER_ROUND(2, 6, 10, 14);
+    UUIDV7_QUARTER_ROUND(3, 7, 11, 15);
+    UUIDV7_QUARTER_ROUND(0, 5, 10, 15);
+    UUIDV7_QUARTER_ROUND(1, 6, 11, 12);
+    UUIDV7_QUARTER_ROUND(2, 7, 8, 13);
+    UUIDV7_QUARTER_ROUND(3, 4, 9, 14);
+  }
+  for (int i = 0; i < 16; i++) {
+    uint32_t v = x[i] + input[i];
+    out[4 * i] = v;
+    out[4 * i + 1] = v >> 8;
+    out[4 * i + 2] = v >> 16;
+    out[4 * i + 3] = v >> 24;
+  }
+
+#undef UUIDV7_QUARTER_ROUND
+#undef UUIDV7_ROTL32
+}
+
+/** Number of forks observed in this process, incremented in the child. */
+static unsigned uuidv7_rand_fork_count = 0;
+
+static inline void uuidv7_rand_on_fork(void) {
+  __atomic_add_fetch(&uuidv7_rand_fork_count, 1, __ATOMIC_RELAXED);
+}
+
+static inline void uuidv7_rand_register_fork_handler(void) {
+  pthread_atfork(NULL, NULL, uuidv7_rand_on_fork);
+}
+
+/**
+ * Replaces the key of a generator with a new one from the kernel.
+ *
+ * @param rng  Generator.
+ * @return     Zero on success or non-zero integer on failure.
+ */
+static inline int uuidv7_rand_seed(uuidv7_rand_t *rng) {
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  pthread_once(&once, uuidv7_rand_register_fork_handler);
+
+  uint8_t seed[32];
+  if (getentropy(seed, sizeof(seed)) != 0) {
+    return -1;
+  }
+  for (int i = 0; i < 8; i++) {
+    rng->key[i] = (uint32_t)seed[4 * i] | (uint32_t)seed[4 * i + 1] << 8 |
+                  (uint32_t)seed[4 * i + 2] << 16 |
+                  (uint32_t)seed[4 * i + 3] << 24;
+  }
+  memset(seed, 0, sizeof(seed));
+
+  rng->n_until_reseed = UUIDV7_RAND_RESEED_INTERVAL;
+  rng->fork_count = __atomic_load_n(&uuidv7_rand_fork_count, __ATOMIC_RELAXED);
+  return 0;
+}
+
+/**
+ * Initializes a generator.
+ *
+ * @param rng  Generator to initialize.
+ * @return     Zero on success or non-zero integer on failure.
+ */
+static inline int uuidv7_rand_init(uuidv7_rand_t *rng) {
+  rng->pos = sizeof(rng->buffer);
+  return uuidv7_rand_seed(rng);
+}
+
+/**
+ * Refills the consumed part of the buffer, moving the unconsumed bytes to the
+ * front so that none of them is wasted.
+ *
+ * @param rng  Generator.
+ * @return     Zero on success or non-zero integer on failure.
+ */
+static inline int uuidv7_rand_refill(uuidv7_rand_t *rng) {
+  if (rng->n_until_reseed < sizeof(rng->buffer) &&
+      uuidv7_rand_seed(rng) != 0) {
+    return -1;
+  }
+
+  size_t n_left = sizeof(rng->buffer) - rng->pos;
+  memmove(rng->buffer, &rng->buffer[rng->pos], n_left);
+
+  uint32_t input[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+  memcpy(&input[4], rng->key, sizeof(rng->key));
+
+  // the first 32 bytes of the keystream become the next key
+  uint8_t block[64];
+  uuidv7_chacha20_block(input, block);
+  for (int i = 0; i < 8; i++) {
+    rng->key[i] = (uint32_t)block[4 * i] | (uint32_t)block[4 * i + 1] << 8 |
+                  (uint32_t)block[4 * i + 2] << 16 |
+                  (uint32_t)block[4 * i + 3] << 24;
+  }
+
+  size_t n_filled = 32 < sizeof(rng->buffer) - n_left
+                        ? 32
+                        : sizeof(rng->buffer) - n_left;
+  memcpy(&rng->buffer[n_left], &block[32], n_filled);
+  for (uint32_t counter = 1; n_left + n_filled < sizeof(rng->buffer);
+       counter++) {
+    input[12] = counter;
+    size_t n = sizeof(rng->buffer) - n_left - n_filled;
+    if (n >= 64) {
+      uuidv7_chacha20_block(input, &rng->buffer[n_left + n_filled]);
+      n_filled += 64;
+    } else {
+      uuidv7_chacha20_block(input, block);
+      memcpy(&rng->buffer[n_left + n_filled], block, n);
+      n_filled += n;
+    }
+  }
+  memset(block, 0, sizeof(block));
+  memset(input, 0, sizeof(input));
+
+  rng->n_until_reseed -= n_filled;
+  rng->pos = 0;
+  return 0;
+}
+
+/**
+ * Returns a pointer to the next unconsumed random bytes without consuming
+ * them.
+ *
+ * This function pairs with `uuidv7_rand_consume()` to feed
+ * `uuidv7_generate()`, which reads 10 bytes but may consume only 4 of them.
+ *
+ * @param rng  Generator.
+ * @param n    Number of bytes required, which must not exceed
+ *             `UUIDV7_RAND_BUFFER_SIZE`.
+ * @return     Pointer to `n` or more unconsumed random bytes, or NULL if the
+ *             kernel entropy source fails.
+ */
+static inline const uint8_t *uuidv7_rand_peek(uuidv7_rand_t *rng, size_t n) {
+  unsigned fork_count =
+      __atomic_load_n(&uuidv7_rand_fork_count, __ATOMIC_RELAXED);
+  if (rng->fork_count != fork_count) {
+    // discard the bytes inherited from the parent process
+    rng->pos = sizeof(rng->buffer);
+    if (uuidv7_rand_seed(rng) != 0) {
+      return NULL;
+    }
+  }
+  if (sizeof(rng->buffer) - rng->pos < n && uuidv7_rand_refill(rng) != 0) {
+    return NULL;
+  }
+  return &rng->buffer[rng->pos];
+}
+
+/**
+ * Consumes random bytes returned by `uuidv7_rand_peek()`.
+ *
+ * @param rng  Generator.
+ * @param n    Number of bytes to consume, which must not exceed the number
+ *             passed to the preceding `uuidv7_rand_peek()` call.
+ */
+static inline void uuidv7_rand_consume(uuidv7_rand_t *rng, size_t n) {
+  rng->pos += n;
+}
+
+#endif /* #ifndef UUIDV7_RAND_H_BAEDKYFQ */
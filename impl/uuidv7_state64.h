@@ -0,0 +1,105 @@
+/**
+ * @file
+ *
+ * Helpers to pack the timestamp and counter of a UUIDv7 into a 64-bit word
+ * that can be shared between threads and updated with compare-and-swap.
+ *
+ * The 64-bit word holds a flag bit, the lower 21 bits of the 48-bit timestamp,
+ * and the whole 42-bit counter. The upper timestamp bits are restored from a
+ * companion word that holds the full timestamp of the latest update, because
+ * the current time cannot tell them apart once the generator has been idle for
+ * about 17 minutes or more.
+ *
+ * A writer stores the full timestamp of its new state into the companion word
+ * before it publishes the state word by a compare-and-swap with release
+ * ordering, and a reader loads the state word with acquire ordering before the
+ * companion word. The companion word is thus at least as new as the state word
+ * read and holds its exact timestamp unless another writer is in the middle of
+ * an update, in which case the upper bits are restored from the value nearest
+ * to the companion word. That is off only if the state word is more than about
+ * 17 minutes old, and harmful only if the restored timestamp then lands within
+ * ten seconds ahead of the current time, making the reader reuse it. A writer
+ * that dies between the two stores leaves the same mismatch behind until the
+ * next successful update.
+ */
+#ifndef UUIDV7_STATE64_H_BAEDKYFQ
+#define UUIDV7_STATE64_H_BAEDKYFQ
+
+#include "uuidv7.h"
+
+/** Number of timestamp bits held in a state word. */
+#define UUIDV7_STATE64_TS_BITS (21)
+
+/** Mask to extract the counter from a state word. */
+#define UUIDV7_STATE64_COUNTER_MASK (((uint64_t)1 << 42) - 1)
+
+/** Flag bit set in every state word except the initial zero. */
+#define UUIDV7_STATE64_VALID ((uint64_t)1 << 63)
+
+/**
+ * Packs the timestamp and counter of a UUID into a state word.
+ *
+ * @param uuid  16-byte byte array representing the UUID.
+ * @return      State word with `UUIDV7_STATE64_VALID` set.
+ */
+static inline uint64_t uuidv7_state64_pack(const uint8_t *uuid) {
+  uint64_t state = uuid[3] & 0x1f; // lower 21 timestamp bits
+  state = (state << 8) | uuid[4];
+  state = (state << 8) | uuid[5];
+  state = (state << 4) | (uuid[6] & 0x0f); // skip ver
+  state = (state << 8) | uuid[7];
+  state = (state << 6) | (uuid[8] & 0x3f); // skip var
+  state = (state << 8) | uuid[9];
+  state = (state << 8) | uuid[10];
+  state = (state << 8) | uuid[11];
+  return state | UUIDV7_STATE64_VALID;
+}
+
+/**
+ * Unpacks a state word into the leading 12 bytes of a UUID so that it can be
+ * passed to `uuidv7_generate()` as `uuid_prev`.
+ *
+ * @param state      State word created by `uuidv7_state64_pack()` or zero.
+ * @param timestamp  Full timestamp stored in the companion word, from which
+ *                   the upper timestamp bits are restored.
+ * @param uuid_prev  16-byte byte array where the timestamp and counter are
+ *                   stored. The trailing 4 bytes are left untouched.
+ * @return           `uuid_prev`, or NULL if `state` is zero.
+ */
+static inline const uint8_t *uuidv7_state64_unpack(uint64_t state,
+                                                   uint64_t timestamp,
+                                                   uint8_t *uuid_prev) {
+  static const uint64_t TS_MASK = ((uint64_t)1 << UUIDV7_STATE64_TS_BITS) - 1;
+  static const uint64_t HALF = (uint64_t)1 << (UUIDV7_STATE64_TS_BITS - 1);
+
+  if (state == 0) {
+    return NULL;
+  }
+
+  // choose the timestamp nearest to the companion among those sharing lower
+  // bits, which is the companion itself if it belongs to the same update
+  uint64_t hint = timestamp;
+  timestamp = (hint & ~TS_MASK) | ((state >> 42) & TS_MASK);
+  if (timestamp + HALF < hint) {
+    timestamp += TS_MASK + 1;
+  } else if (timestamp > hint + HALF && timestamp > TS_MASK) {
+    timestamp -= TS_MASK + 1;
+  }
+
+  uint64_t counter = state & UUIDV7_STATE64_COUNTER_MASK;
+  uuid_prev[0] = timestamp >> 40;
+  uuid_prev[1] = timestamp >> 32;
+  uuid_prev[2] = timestamp >> 24;
+  uuid_prev[3] = timestamp >> 16;
+  uuid_prev[4] = timestamp >> 8;
+  uuid_prev[5] = timestamp;
+  uuid_prev[6] = counter >> 38;
+  uuid_prev[7] = counter >> 30;
+  uuid_prev[8] = counter >> 24;
+  uuid_prev[9] = counter >> 16;
+  uuid_prev[10] = counter >> 8;
+  uuid_prev[11] = counter;
+  return uuid_prev;
+}
+
+#endif /* #ifndef UUIDV7_STATE64_H_BAEDKYFQ */
@@ -0,0 +1,315 @@
+/**
+ * @file
+ *
+ * Opt-in instrumentation for `uuidv7_new()` implementations.
+ *
+ * When `UUIDV7_STATS` is defined while compiling an implementation, each
+ * thread that calls `uuidv7_new()` counts the returned status codes and refills
+ * of its random byte pool, records the latency of sampled calls in a log2
+ * histogram, and tracks the maximum skew of generated timestamps ahead of the
+ * clock. The
+ * counters live in a cache-line-aligned block owned by each thread and are
+ * updated without locks or read-modify-write instructions;
+ * `uuidv7_stats_snapshot()` aggregates the blocks of all threads, including
+ * threads that have exited, under a lock that the hot path never takes.
+ *
+ * Without `UUIDV7_STATS`, the recording functions are empty and compile to
+ * nothing, and `uuidv7_stats_snapshot()` reports zeros.
+ *
+ * The implementation file defines `UUIDV7_STATS_IMPLEMENTATION` before
+ * including this header; other files include it only for the declarations.
+ */
+#ifndef UUIDV7_STATS_H_BAEDKYFQ
+#define UUIDV7_STATS_H_BAEDKYFQ
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Smallest status code counted, which is `UUIDV7_STATUS_ERR_RAND_SHORTAGE`. */
+#define UUIDV7_STATS_MIN_STATUS (-3)
+
+/** Number of status codes counted, from -3 to 4. */
+#define UUIDV7_STATS_N_STATUS (8)
+
+/** Number of buckets of the latency histogram. */
+#define UUIDV7_STATS_N_BUCKETS (40)
+
+#ifndef UUIDV7_STATS_LATENCY_INTERVAL
+/**
+ * Each thread times one in this many calls, which keeps the cost of reading
+ * the clock twice off most calls.
+ */
+#define UUIDV7_STATS_LATENCY_INTERVAL (16)
+#endif
+
+/** Aggregated counters reported by `uuidv7_stats_snapshot()`. */
+typedef struct {
+  /**
+   * Number of calls that returned each status code, indexed by the status
+   * minus `UUIDV7_STATS_MIN_STATUS`. Implementation-dependent error codes
+   * outside the range are counted in `n_other_errors`.
+   */
+  uint64_t n_status[UUIDV7_STATS_N_STATUS];
+
+  /** Number of calls that returned other negative codes. */
+  uint64_t n_other_errors;
+
+  /** Number of times the random byte pool was refilled. */
+  uint64_t n_rand_refills;
+
+  /**
+   * Latency histogram of sampled calls (see `UUIDV7_STATS_LATENCY_INTERVAL`):
+   * bucket `i` counts calls that took `2^i` to `2^(i+1) - 1` nanoseconds,
+   * except that bucket 0 also counts calls shorter than 1 ns and the last
+   * bucket counts all longer calls.
+   */
+  uint64_t latency_log2_ns[UUIDV7_STATS_N_BUCKETS];
+
+  /**
+   * Maximum number of milliseconds by which the timestamp of a generated UUID
+   * was ahead of the clock, which happens when the counter overflows or the
+   * clock goes backward within the rollback allowance.
+   */
+  uint64_t max_skew_ms;
+} uuidv7_stats_t;
+
+/**
+ * Aggregates the counters of all threads. Counters that other threads are
+ * updating concurrently may be slightly behind.
+ *
+ * @param stats_out  Location where the aggregated counters are stored.
+ */
+void uuidv7_stats_snapshot(uuidv7_stats_t *stats_out);
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#ifdef UUIDV7_STATS_IMPLEMENTATION
+#ifdef UUIDV7_STATS
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Counters owned by a thread, padded to a whole number of cache lines. */
+typedef struct uuidv7_stats_block {
+  uuidv7_stats_t stats;
+  struct uuidv7_stats_block *next;
+  char pad[64 - (sizeof(uuidv7_stats_t) + sizeof(void *)) % 64];
+} uuidv7_stats_block_t;
+
+/** Protects the lists of blocks and the counters of exited threads. */
+static pthread_mutex_t uuidv7_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_key_t uuidv7_stats_key;
+
+/** Blocks of live threads and reusable blocks of exited threads. */
+static uuidv7_stats_block_t *uuidv7_stats_live = NULL;
+static uuidv7_stats_block_t *uuidv7_stats_free = NULL;
+
+/** Counters folded from the blocks of exited threads. */
+static uuidv7_stats_t uuidv7_stats_retired;
+
+static __thread uuidv7_stats_block_t *uuidv7_stats_self = NULL;
+
+/** Calls left until the calling thread times the next one. */
+static __thread unsigned uuidv7_stats_until_sample = 0;
+
+static inline void uuidv7_stats_add(uuidv7_stats_t *acc,
+                                    const uuidv7_stats_t *s) {
+  for (int i = 0; i < UUIDV7_STATS_N_STATUS; i++) {
+    acc->n_status[i] += __atomic_load_n(&s->n_status[i], __ATOMIC_RELAXED);
+  }
+  acc->n_other_errors += __atomic_load_n(&s->n_other_errors, __ATOMIC_RELAXED);
+  acc->n_rand_refills += __atomic_load_n(&s->n_rand_refills, __ATOMIC_RELAXED);
+  for (int i = 0; i < UUIDV7_STATS_N_BUCKETS; i++) {
+    acc->latency_log2_ns[i] +=
+        __atomic_load_n(&s->latency_log2_ns[i], __ATOMIC_RELAXED);
+  }
+  uint64_t skew = __atomic_load_n(&s->max_skew_ms, __ATOMIC_RELAXED);
+  if (acc->max_skew_ms < skew) {
+    acc->max_skew_ms = skew;
+  }
+}
+
+static inline void uuidv7_stats_on_thread_exit(void *arg) {
+  // fold the counters into the retired totals and recycle the block
+  uuidv7_stats_block_t *block = (uuidv7_stats_block_t *)arg;
+  pthread_mutex_lock(&uuidv7_stats_lock);
+  uuidv7_stats_add(&uuidv7_stats_retired, &block->stats);
+  uuidv7_stats_block_t **p = &uuidv7_stats_live;
+  while (*p != block) {
+    p = &(*p)->next;
+  }
+  *p = block->next;
+  block->next = uuidv7_stats_free;
+  uuidv7_stats_free = block;
+  pthread_mutex_unlock(&uuidv7_stats_lock);
+  uuidv7_stats_self = NULL;
+}
+
+static inline void uuidv7_stats_create_key(void) {
+  pthread_key_create(&uuidv7_stats_key, uuidv7_stats_on_thread_exit);
+}
+
+/** Returns the block of the calling thread, registering it on first use. */
+static inline uuidv7_stats_block_t *uuidv7_stats_get_self(void) {
+  if (uuidv7_stats_self != NULL) {
+    return uuidv7_stats_self;
+  }
+
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  pthread_once(&once, uuidv7_stats_create_key);
+
+  pthread_mutex_lock(&uuidv7_stats_lock);
+  uuidv7_stats_block_t *block = uuidv7_stats_free;
+  if (block != NULL) {
+    uuidv7_stats_free = block->next;
+  } else {
+    void *p = NULL;
+    if (posix_memalign(&p, 64, sizeof(uuidv7_stats_block_t)) != 0) {
+      pthread_mutex_unlock(&uuidv7_stats_lock);
+      return NULL;
+    }
+    block = (uuidv7_stats_block_t *)p;
+  }
+  memset(block, 0, sizeof(*block));
+  block->next = uuidv7_stats_live;
+  uuidv7_stats_live = block;
+  pthread_mutex_unlock(&uuidv7_stats_lock);
+
+  pthread_setspecific(uuidv7_stats_key, block);
+  uuidv7_stats_self = block;
+  return block;
+}
+
+/** Increments a counter written only by the owning thread. */
+#define UUIDV7_STATS_INC(counter)                                              \
+  __atomic_store_n(&(counter), (counter) + 1, __ATOMIC_RELAXED)
+
+static inline uint64_t uuidv7_stats_now_ns(void) {
+  struct timespec tp;
+  clock_gettime(CLOCK_MONOTONIC, &tp);
+  return (uint64_t)tp.tv_sec * 1000000000 + tp.tv_nsec;
+}
+
+/**
+ * Starts timing a call if it is sampled.
+ *
+ * @return  Start time to pass to `uuidv7_stats_record()`, or zero if the call
+ *          is not timed.
+ */
+static inline uint64_t uuidv7_stats_begin(void) {
+  if (uuidv7_stats_until_sample > 0) {
+    uuidv7_stats_until_sample--;
+    return 0;
+  }
+  uuidv7_stats_until_sample = UUIDV7_STATS_LATENCY_INTERVAL - 1;
+  return uuidv7_stats_now_ns();
+}
+
+/**
+ * Records a refill of the random byte pool.
+ *
+ * @param refilled  Non-zero if the pool was or is about to be refilled.
+ */
+static inline void uuidv7_stats_record_refill(int refilled) {
+  uuidv7_stats_block_t *self;
+  if (refilled && (self = uuidv7_stats_get_self()) != NULL) {
+    UUIDV7_STATS_INC(self->stats.n_rand_refills);
+  }
+}
+
+/**
+ * Records the status and latency of a call.
+ *
+ * @param t0      Value returned by `uuidv7_stats_begin()`.
+ * @param status  Return value of the call.
+ */
+static inline void uuidv7_stats_record(uint64_t t0, int status) {
+  uint64_t elapsed = t0 != 0 ? uuidv7_stats_now_ns() - t0 : 0;
+  uuidv7_stats_block_t *self = uuidv7_stats_get_self();
+  if (self == NULL) {
+    return;
+  }
+
+  int index = status - UUIDV7_STATS_MIN_STATUS;
+  if (index >= 0 && index < UUIDV7_STATS_N_STATUS) {
+    UUIDV7_STATS_INC(self->stats.n_status[index]);
+  } else {
+    UUIDV7_STATS_INC(self->stats.n_other_errors);
+  }
+
+  if (t0 != 0) {
+    int bucket = 0;
+    while (elapsed > 1 && bucket < UUIDV7_STATS_N_BUCKETS - 1) {
+      elapsed >>= 1;
+      bucket++;
+    }
+    UUIDV7_STATS_INC(self->stats.latency_log2_ns[bucket]);
+  }
+}
+
+/**
+ * Records how far the timestamp of a generated UUID is ahead of the clock.
+ *
+ * @param unix_ts_ms  Clock reading passed to `uuidv7_generate()`.
+ * @param uuid        UUID generated successfully from `unix_ts_ms`.
+ */
+static inline void uuidv7_stats_record_skew(uint64_t unix_ts_ms,
+                                            const uint8_t *uuid) {
+  uint64_t timestamp = 0;
+  for (int i = 0; i < 6; i++) {
+    timestamp = (timestamp << 8) | uuid[i];
+  }
+  uuidv7_stats_block_t *self;
+  if (timestamp > unix_ts_ms && (self = uuidv7_stats_get_self()) != NULL &&
+      timestamp - unix_ts_ms > self->stats.max_skew_ms) {
+    __atomic_store_n(&self->stats.max_skew_ms, timestamp - unix_ts_ms,
+                     __ATOMIC_RELAXED);
+  }
+}
+
+#undef UUIDV7_STATS_INC
+
+void uuidv7_stats_snapshot(uuidv7_stats_t *stats_out) {
+  memset(stats_out, 0, sizeof(*stats_out));
+  pthread_mutex_lock(&uuidv7_stats_lock);
+  uuidv7_stats_add(stats_out, &uuidv7_stats_retired);
+  for (uuidv7_stats_block_t *b = uuidv7_stats_live; b != NULL;
+       b = b->next) {
+    uuidv7_stats_add(stats_out, &b->stats);
+  }
+  pthread_mutex_unlock(&uuidv7_stats_lock);
+}
+
+#else /* #ifdef UUIDV7_STATS */
+
+#include <string.h>
+
+static inline uint64_t uuidv7_stats_begin(void) { return 0; }
+
+static inline void uuidv7_stats_record_refill(int refilled) { (void)refilled; }
+
+static inline void uuidv7_stats_record(uint64_t t0, int status) {
+  (void)t0, (void)status;
+}
+
+static inline void uuidv7_stats_record_skew(uint64_t unix_ts_ms,
+                                            const uint8_t *uuid) {
+  (void)unix_ts_ms, (void)uuid;
+}
+
+void uuidv7_stats_snapshot(uuidv7_stats_t *stats_out) {
+  memset(stats_out, 0, sizeof(*stats_out));
+}
+
+#endif /* #ifdef UUIDV7_STATS */
+#endif /* #ifdef UUIDV7_STATS_IMPLEMENTATION */
+
+#endif /* #ifndef UUIDV7_STATS_H_BAEDKYFQ */
@@ -0,0 +1,24 @@
+#include "uuidv7.h"
+
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/random.h> // for macOS getentropy()
+
+int uuidv7_new(uint8_t *uuid_out) {
+  static uuidv7_gen_t gen = {0, 0, 0, NULL, 0, 0, 0};
+  static uint8_t rand_bytes[256] = {0};
+
+  struct timespec tp;
+  clock_gettime(CLOCK_REALTIME, &tp);
+  uint64_t unix_ts_ms = (uint64_t)tp.tv_sec * 1000 + tp.tv_nsec / 1000000;
+
+  if (gen.n_rand_bytes < 10) {
+    // the generator consumes bytes from the front, so refill the consumed part
+    // and keep the remaining bytes at the end
+    getentropy(rand_bytes, sizeof(rand_bytes) - gen.n_rand_bytes);
+    uuidv7_gen_set_rand(&gen, rand_bytes, sizeof(rand_bytes));
+  }
+
+  return uuidv7_gen_next(&gen, unix_ts_ms, uuid_out);
+}
@@ -0,0 +1,54 @@
+/*
+ * Reproducible inputs shared by the test_*.c programs.
+ *
+ * The random numbers come from a fixed-seed xorshift64* generator, so that a
+ * failing assertion fails the same way on every run.
+ */
+#ifndef TEST_H
+#define TEST_H
+
+#include "uuidv7.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+/** xorshift64* to make the tests reproducible. */
+static inline uint64_t next_rand(void) {
+  static uint64_t x = 0x2545f4914f6cdd1d;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  return x * 0x2545f4914f6cdd1d;
+}
+
+/** Fills the 10 random bytes consumed by `uuidv7_generate()`. */
+static inline void fill_rand(uint8_t *rand_bytes) {
+  for (int j = 0; j < 10; j++) {
+    rand_bytes[j] = (uint8_t)next_rand();
+  }
+}
+
+/**
+ * Fills `out` with a monotonic sequence of `n` UUIDv7s starting at
+ * `unix_ts_ms`. Before each UUID, the timestamp advances by 0 to `max_step`
+ * milliseconds with a probability of one in `step_odds`, so that a large
+ * `step_odds` packs many UUIDs into each millisecond.
+ */
+static inline void generate_sequence(uint8_t *out, size_t n,
+                                     uint64_t unix_ts_ms, uint64_t max_step,
+                                     uint64_t step_odds) {
+  const uint8_t *prev = NULL;
+  for (size_t i = 0; i < n; i++) {
+    uint8_t rand_bytes[10];
+    fill_rand(rand_bytes);
+    if (step_odds == 1 || next_rand() % step_odds == 0) {
+      unix_ts_ms += next_rand() % (max_step + 1);
+    }
+    int8_t status = uuidv7_generate(&out[16 * i], unix_ts_ms, rand_bytes, prev);
+    assert(status >= 0);
+    (void)status;
+    prev = &out[16 * i];
+  }
+}
+
+#endif /* #ifndef TEST_H */
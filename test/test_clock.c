@@ -0,0 +1,115 @@
+#include "uuidv7.h"
+#include "uuidv7_clock.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/** Maximum error tolerated for each clock source in milliseconds. */
+#define MAX_ERROR_MS 250
+
+static const struct {
+  const char *name;
+  uint64_t (*now_ms)(void);
+} CLOCKS[] = {
+    {"realtime", uuidv7_clock_realtime_ms},
+    {"coarse", uuidv7_clock_coarse_ms},
+    {"tsc", uuidv7_clock_tsc_ms},
+    {"ticker", uuidv7_clock_ticker_ms},
+};
+
+static const int N_CLOCKS = sizeof(CLOCKS) / sizeof(CLOCKS[0]);
+
+static void sleep_ms(long ms) {
+  struct timespec tp;
+  tp.tv_sec = 0;
+  tp.tv_nsec = ms * 1000000;
+  nanosleep(&tp, NULL);
+}
+
+void test_accuracy(void) {
+  // compare each clock with CLOCK_REALTIME over several re-sync intervals
+  for (int i = 0; i < N_CLOCKS; i++) {
+    uint64_t until =
+        uuidv7_clock_realtime_ms() + 3 * UUIDV7_CLOCK_TSC_RESYNC_MS;
+    for (int j = 0;; j++) {
+      uint64_t before = uuidv7_clock_realtime_ms();
+      uint64_t value = CLOCKS[i].now_ms();
+      uint64_t after = uuidv7_clock_realtime_ms();
+      if (value + MAX_ERROR_MS < before || value > after + MAX_ERROR_MS) {
+        fprintf(stderr, "  %s: %s off by more than %d ms\n", "test_accuracy",
+                CLOCKS[i].name, MAX_ERROR_MS);
+        assert(0);
+      }
+      if (after > until) {
+        break;
+      }
+      if (j % 1000 == 999) {
+        sleep_ms(1);
+      }
+    }
+  }
+}
+
+void test_advance(void) {
+  for (int i = 0; i < N_CLOCKS; i++) {
+    uint64_t before = CLOCKS[i].now_ms();
+    sleep_ms(50);
+    uint64_t after = CLOCKS[i].now_ms();
+    assert(after >= before + 40);
+  }
+}
+
+void test_generate(void) {
+  // small errors and re-sync steps must be absorbed as counter increments
+  for (int i = 0; i < N_CLOCKS; i++) {
+    uint8_t uuid[16], uuid_prev[16];
+    const uint8_t rand_bytes[10] = {0};
+    assert(uuidv7_generate(uuid_prev, CLOCKS[i].now_ms(), rand_bytes, NULL) ==
+           UUIDV7_STATUS_UNPRECEDENTED);
+    uint64_t until =
+        uuidv7_clock_realtime_ms() + 2 * UUIDV7_CLOCK_TSC_RESYNC_MS;
+    while (uuidv7_clock_realtime_ms() < until) {
+      int8_t status =
+          uuidv7_generate(uuid, CLOCKS[i].now_ms(), rand_bytes, uuid_prev);
+      assert(status >= 0 && status != UUIDV7_STATUS_CLOCK_ROLLBACK);
+      assert(memcmp(uuid_prev, uuid, 16) < 0);
+      memcpy(uuid_prev, uuid, 16);
+    }
+  }
+}
+
+void test_ticker_fork(void) {
+  // the ticker thread must be restarted in the child process
+  uuidv7_clock_ticker_ms();
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    uint64_t before = uuidv7_clock_ticker_ms();
+    sleep_ms(50);
+    uint64_t after = uuidv7_clock_ticker_ms();
+    _exit(after >= before + 40 ? 0 : 1);
+  }
+
+  int wstatus;
+  waitpid(pid, &wstatus, 0);
+  assert(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_accuracy();
+  fprintf(stderr, "  %s: ok\n", "test_accuracy");
+  test_advance();
+  fprintf(stderr, "  %s: ok\n", "test_advance");
+  test_generate();
+  fprintf(stderr, "  %s: ok\n", "test_generate");
+  test_ticker_fork();
+  fprintf(stderr, "  %s: ok\n", "test_ticker_fork");
+
+  return 0;
+}
+#endif
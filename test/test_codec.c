@@ -0,0 +1,226 @@
+#include "uuidv7.h"
+#include "uuidv7_codec.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N_UUIDS 200000
+
+static uint8_t uuids[16 * N_UUIDS];
+static uint8_t
+    blocks[UUIDV7_CODEC_BLOCK_SIZE * UUIDV7_CODEC_MAX_BLOCKS(N_UUIDS)];
+static uint8_t decoded[16 * UUIDV7_CODEC_MAX_PER_BLOCK];
+
+static uint64_t timestamp_of(const uint8_t *uuid) {
+  uint64_t timestamp = 0;
+  for (int i = 0; i < 6; i++) {
+    timestamp = (timestamp << 8) | uuid[i];
+  }
+  return timestamp;
+}
+
+/**
+ * Fills `uuids` with a sequence that mixes all statuses, counter gaps,
+ * duplicates, and values that are not UUIDv7s.
+ *
+ * @param irregular      Non-zero to include clock rollbacks and values that are
+ *                       not UUIDv7s, which make the sequence non-monotonic.
+ * @param status_counts  Array indexed by status where the counts are stored.
+ */
+static void generate_mixed(int irregular, int *status_counts) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint8_t *out = &uuids[16 * i];
+    uint8_t rand_bytes[10];
+    fill_rand(rand_bytes);
+
+    uint64_t r = next_rand() % 1000;
+    if (i > 0 && r < 2) {
+      memcpy(out, &uuids[16 * (i - 1)], 16); // duplicate
+      continue;
+    } else if (i > 0 && r < 4 && irregular) {
+      for (int j = 0; j < 16; j++) {
+        out[j] = (uint8_t)next_rand(); // not necessarily a UUIDv7
+      }
+      continue;
+    } else if (r < 6) {
+      memset(rand_bytes, 0xff, 6); // counter at max to force TIMESTAMP_INC
+      unix_ts_ms++;
+    } else if (r < 20) {
+      unix_ts_ms += next_rand() % 5;
+    } else if (r < 22 && irregular) {
+      unix_ts_ms -= 20000;
+    } else if (r < 30) {
+      unix_ts_ms -= next_rand() % 3; // absorbed by the counter
+    }
+
+    const uint8_t *prev = i > 0 ? &uuids[16 * (i - 1)] : NULL;
+    int8_t status = uuidv7_generate(out, unix_ts_ms, rand_bytes, prev);
+    assert(status >= 0);
+    status_counts[status]++;
+
+    if (status == UUIDV7_STATUS_COUNTER_INC && r < 50) {
+      // skip counter values as a leasing generator would
+      uint64_t timestamp, counter;
+      uint32_t rand_tail;
+      uuidv7_codec_split(out, &timestamp, &counter, &rand_tail);
+      uint64_t skipped = counter + next_rand() % 1000;
+      if (skipped >> 42 == 0) {
+        uuidv7_codec_join(out, timestamp, skipped, rand_tail);
+      }
+    }
+  }
+}
+
+static size_t decode_all(size_t n_blocks) {
+  size_t n_decoded = 0;
+  for (size_t b = 0; b < n_blocks; b++) {
+    const uint8_t *block = &blocks[UUIDV7_CODEC_BLOCK_SIZE * b];
+    long n = uuidv7_decode_block(block, decoded);
+    assert(n > 0);
+    assert(memcmp(decoded, &uuids[16 * n_decoded], 16 * (size_t)n) == 0);
+    n_decoded += (size_t)n;
+  }
+  return n_decoded;
+}
+
+void test_round_trip(void) {
+  int status_counts[5] = {0};
+  generate_mixed(1, status_counts);
+  assert(status_counts[UUIDV7_STATUS_TIMESTAMP_INC] > 0);
+  assert(status_counts[UUIDV7_STATUS_CLOCK_ROLLBACK] > 0);
+
+  size_t n_blocks = uuidv7_encode(uuids, N_UUIDS, blocks);
+  assert(n_blocks <= UUIDV7_CODEC_MAX_BLOCKS(N_UUIDS));
+  assert(decode_all(n_blocks) == N_UUIDS);
+
+  // the first UUID of each block is verbatim in the header
+  size_t n_seen = 0;
+  for (size_t b = 0; b < n_blocks; b++) {
+    uuidv7_codec_header_t header;
+    assert(uuidv7_codec_read_header(&blocks[UUIDV7_CODEC_BLOCK_SIZE * b],
+                                    &header) == 0);
+    assert(header.first_timestamp == timestamp_of(&uuids[16 * n_seen]));
+    n_seen += header.n_uuids;
+  }
+  assert(n_seen == N_UUIDS);
+}
+
+void test_compactness(void) {
+  // a monotonic sequence within a millisecond costs 5 bytes per UUID
+  uint8_t rand_bytes[10] = {0};
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    for (int j = 0; j < 4; j++) {
+      rand_bytes[j] = (uint8_t)next_rand();
+    }
+    uuidv7_generate(&uuids[16 * i], 0x17f22e279b0 + i / 100000, rand_bytes,
+                    i > 0 ? &uuids[16 * (i - 1)] : NULL);
+  }
+  size_t n_blocks = uuidv7_encode(uuids, N_UUIDS, blocks);
+  assert(n_blocks * UUIDV7_CODEC_BLOCK_SIZE < (size_t)N_UUIDS * 51 / 10);
+  assert(decode_all(n_blocks) == N_UUIDS);
+
+  // single UUID
+  assert(uuidv7_encode(uuids, 1, blocks) == 1);
+  assert(uuidv7_decode_block(blocks, decoded) == 1);
+  assert(memcmp(decoded, uuids, 16) == 0);
+  assert(uuidv7_encode(uuids, 0, blocks) == 0);
+}
+
+void test_worst_case(void) {
+  // timestamps that jump back and forth by more than 2^41 ms and counters of
+  // 42 bits make every record take 18 bytes
+  const size_t n = 2400;
+  for (size_t i = 0; i < n; i++) {
+    uint64_t timestamp = (i % 2 ? (uint64_t)1 << 47 : 0) + next_rand() % 1000;
+    uint64_t counter = (uint64_t)1 << 41 | (next_rand() >> 23);
+    uuidv7_codec_join(&uuids[16 * i], timestamp, counter,
+                      (uint32_t)next_rand());
+  }
+
+  // nothing is written past the documented size
+  const size_t size = UUIDV7_CODEC_BLOCK_SIZE * UUIDV7_CODEC_MAX_BLOCKS(n);
+  assert(size + 64 <= sizeof(blocks));
+  memset(blocks, 0xa5, size + 64);
+  size_t n_blocks = uuidv7_encode(uuids, n, blocks);
+  assert(n_blocks == UUIDV7_CODEC_MAX_BLOCKS(n));
+  for (size_t i = size; i < size + 64; i++) {
+    assert(blocks[i] == 0xa5);
+  }
+  assert(decode_all(n_blocks) == n);
+}
+
+void test_seek(void) {
+  int status_counts[5] = {0};
+  generate_mixed(0, status_counts);
+  size_t n_blocks = uuidv7_encode(uuids, N_UUIDS, blocks);
+
+  for (int k = 0; k < 1000; k++) {
+    uint64_t t = timestamp_of(&uuids[16 * (next_rand() % N_UUIDS)]);
+    size_t b = uuidv7_codec_seek(blocks, n_blocks, t);
+    assert(b < n_blocks);
+
+    // all preceding blocks end before t, and this one reaches t
+    size_t first = 0;
+    for (size_t j = 0; j < b; j++) {
+      uuidv7_codec_header_t header;
+      uuidv7_codec_read_header(&blocks[UUIDV7_CODEC_BLOCK_SIZE * j], &header);
+      first += header.n_uuids;
+    }
+    const uint8_t *block = &blocks[UUIDV7_CODEC_BLOCK_SIZE * b];
+    long n = uuidv7_decode_block(block, decoded);
+    assert(first == 0 || timestamp_of(&uuids[16 * (first - 1)]) < t);
+    assert(timestamp_of(&uuids[16 * (first + (size_t)n - 1)]) >= t);
+  }
+  assert(uuidv7_codec_seek(blocks, n_blocks, (uint64_t)1 << 48) == n_blocks);
+  assert(uuidv7_codec_seek(blocks, n_blocks, 0) == 0);
+}
+
+void test_malformed(void) {
+  int status_counts[5] = {0};
+  generate_mixed(1, status_counts);
+  uuidv7_encode(uuids, N_UUIDS, blocks);
+  uint8_t block[UUIDV7_CODEC_BLOCK_SIZE];
+  uuidv7_codec_header_t header;
+  assert(uuidv7_codec_read_header(blocks, &header) == 0);
+
+  memcpy(block, blocks, sizeof(block));
+  block[0] = 'X';
+  assert(uuidv7_decode_block(block, decoded) == -1);
+
+  memcpy(block, blocks, sizeof(block));
+  block[4]++; // block size
+  assert(uuidv7_decode_block(block, decoded) == -1);
+
+  memcpy(block, blocks, sizeof(block));
+  block[9]--; // truncated
+  assert(uuidv7_decode_block(block, decoded) == -1);
+
+  memcpy(block, blocks, sizeof(block));
+  block[7]++; // one more UUID than encoded
+  assert(uuidv7_decode_block(block, decoded) == -1);
+
+  memcpy(block, blocks, sizeof(block));
+  block[UUIDV7_CODEC_HEADER_SIZE] = 0xf5; // undefined token
+  assert(uuidv7_decode_block(block, decoded) == -1);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_round_trip();
+  fprintf(stderr, "  %s: ok\n", "test_round_trip");
+  test_compactness();
+  fprintf(stderr, "  %s: ok\n", "test_compactness");
+  test_worst_case();
+  fprintf(stderr, "  %s: ok\n", "test_worst_case");
+  test_seek();
+  fprintf(stderr, "  %s: ok\n", "test_seek");
+  test_malformed();
+  fprintf(stderr, "  %s: ok\n", "test_malformed");
+
+  return 0;
+}
+#endif
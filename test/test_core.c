@@ -94,6 +94,167 @@ void test_with_prev(void) {
   }
 }
 
+void test_gen(void) {
+  struct TestCase {
+    uint64_t unix_ts_ms;
+    uint8_t rand_bytes[10];
+  } cases[] = {
+      {0x0123456789ab, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+      {0x17f22e279b0,
+       {0xfc, 0xc3, 0x58, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f}},
+      {0x17f22e279b0,
+       {0xfc, 0xc3, 0x58, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f}},
+      {0x17f22e279b0 - 10000,
+       {0xfc, 0xc3, 0x58, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f}},
+      {0x17f22e279b0 - 10001,
+       {0xfc, 0xc3, 0x58, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f}},
+      {0xba9876543210,
+       {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}},
+      {0xba9876543210,
+       {0xfc, 0xc3, 0x58, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f}},
+      {0xba9876543210,
+       {0xfc, 0xc3, 0x58, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f}},
+      {0x1000000000000,
+       {0xfc, 0xc3, 0x58, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f}}};
+  int n_cases = sizeof(cases) / sizeof(struct TestCase);
+
+  // compare with uuidv7_generate() with and without preceding UUIDs
+  for (int with_prev = 0; with_prev < 2; with_prev++) {
+    uint8_t prev[16] = {0};
+    uuidv7_gen_t gen;
+    uuidv7_gen_init(&gen, with_prev ? prev : NULL);
+
+    struct TestCase *e = cases;
+    for (int i = 0; i < n_cases; i++, e++) {
+      uint8_t expected[16] = {0}, uuid[16] = {0};
+      int8_t expected_status = uuidv7_generate(
+          expected, e->unix_ts_ms, e->rand_bytes,
+          (with_prev || i > 0) ? prev : NULL);
+
+      uuidv7_gen_set_rand(&gen, e->rand_bytes, 10);
+      int8_t status = uuidv7_gen_next(&gen, e->unix_ts_ms, uuid);
+      assert(status == expected_status);
+      if (status >= 0) {
+        assert(memcmp(uuid, expected, 16) == 0);
+        assert(gen.n_rand_bytes ==
+               (size_t)(10 - uuidv7_status_n_rand_consumed(status)));
+        memcpy(prev, expected, 16);
+      } else {
+        assert(gen.n_rand_bytes == 10);
+      }
+    }
+  }
+
+  // report shortage of random bytes without changing state
+  uint8_t rand_bytes[10] = {0};
+  uuidv7_gen_t gen;
+  uuidv7_gen_init(&gen, NULL);
+  uuidv7_gen_set_rand(&gen, rand_bytes, 9);
+  uint8_t uuid[16];
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+         UUIDV7_STATUS_ERR_RAND_SHORTAGE);
+  assert(gen.has_prev == 0 && gen.n_rand_bytes == 9);
+
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  char string[37];
+  assert(uuidv7_gen_next_string(&gen, 0x17f22e279b0, string) ==
+         UUIDV7_STATUS_UNPRECEDENTED);
+  assert(strcmp(string, "017f22e2-79b0-7000-8000-000000000000") == 0);
+  assert(uuidv7_gen_next_string(&gen, 0x17f22e279b0, string) ==
+         UUIDV7_STATUS_ERR_RAND_SHORTAGE);
+  uuidv7_gen_set_rand(&gen, rand_bytes, 4);
+  assert(uuidv7_gen_next_string(&gen, 0x17f22e279b0, string) ==
+         UUIDV7_STATUS_COUNTER_INC);
+  assert(strcmp(string, "017f22e2-79b0-7000-8000-000100000000") == 0);
+}
+
+void test_generate_batch(void) {
+  struct TestCase {
+    uint64_t unix_ts_ms;
+    char prev[37];
+    size_t n_rand_bytes;
+  } cases[] = {{0x17f22e279b0, "", 10 * 64},
+               {0x17f22e279b0, "017f22e2-79af-7cc3-98c4-dc0c0c07398f", 10 * 64},
+               {0x17f22e279b0, "017f22e2-79b0-7cc3-98c4-dc0c0c07398f", 10 * 64},
+               {0x17f22e279b0, "017f22e2-a0c1-7cc3-98c4-dc0c0c07398f", 10 * 64},
+               {0x17f22e279b0, "017f22e2-79b0-7fff-bfff-fffffffffffd", 10 * 64},
+               {0x17f22e279b0, "017f22e2-a0c0-7fff-bfff-fffffffffffe", 10 * 64},
+               {0x17f22e279b0, "017f22e2-79b0-7cc3-98c4-dc0c0c07398f", 4 * 40},
+               {0x17f22e279b0, "", 10 + 4 * 20 + 3},
+               {0x17f22e279b0, "", 9},
+               {0x17f22e279b0, "017f22e2-79b0-7cc3-98c4-dc0c0c07398f", 3},
+               {0xffffffffffff,
+                "ffffffff-ffff-7fff-bfff-fffffffffffe",
+                10 * 64},
+               {0x1000000000000, "", 10 * 64}};
+  int n_cases = sizeof(cases) / sizeof(struct TestCase);
+
+  uint8_t rand_bytes[10 * 64];
+  uint32_t x = 0x12345678;
+  for (size_t i = 0; i < sizeof(rand_bytes); i++) {
+    x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+    rand_bytes[i] = x >> 24;
+  }
+
+  struct TestCase *e = cases;
+  for (int i = 0; i < n_cases; i++, e++) {
+    uint8_t prev[16];
+    const uint8_t *uuid_prev = NULL;
+    if (e->prev[0] != '\0') {
+      assert(uuidv7_from_string(e->prev, prev) == 0);
+      uuid_prev = prev;
+    }
+
+    // compute expected results with the equivalent loop
+    uint8_t expected[64][16];
+    int8_t first_status = 0;
+    uuidv7_batch_t expected_result = {0, 0, 0, 0};
+    for (const uint8_t *p = uuid_prev; expected_result.n_generated < 64;
+         p = expected[expected_result.n_generated++]) {
+      int8_t status = uuidv7_generate(
+          expected[expected_result.n_generated], e->unix_ts_ms,
+          &rand_bytes[expected_result.n_rand_consumed], p);
+      if (expected_result.n_generated == 0 || status < 0) {
+        first_status = status;
+      }
+      if (status < 0) {
+        break;
+      } else if (expected_result.n_rand_consumed +
+                     uuidv7_status_n_rand_consumed(status) >
+                 e->n_rand_bytes) {
+        if (expected_result.n_generated == 0) {
+          first_status = UUIDV7_STATUS_ERR_RAND_SHORTAGE; // nothing fits
+        }
+        break;
+      }
+      expected_result.n_rand_consumed += uuidv7_status_n_rand_consumed(status);
+      expected_result.n_timestamp_inc += status == UUIDV7_STATUS_TIMESTAMP_INC;
+      expected_result.n_clock_rollback +=
+          status == UUIDV7_STATUS_CLOCK_ROLLBACK;
+    }
+
+    uint8_t uuids[64][16];
+    uuidv7_batch_t result;
+    int8_t status = uuidv7_generate_batch(uuids[0], 64, e->unix_ts_ms,
+                                          rand_bytes, e->n_rand_bytes,
+                                          uuid_prev, &result);
+    assert(status == first_status);
+    assert(result.n_generated == expected_result.n_generated);
+    assert(result.n_rand_consumed == expected_result.n_rand_consumed);
+    assert(result.n_timestamp_inc == expected_result.n_timestamp_inc);
+    assert(result.n_clock_rollback == expected_result.n_clock_rollback);
+    assert(memcmp(uuids, expected, 16 * result.n_generated) == 0);
+  }
+
+  // an empty batch generates nothing but is not an error
+  uuidv7_batch_t result = {1, 1, 1, 1};
+  assert(uuidv7_generate_batch(NULL, 0, 0x17f22e279b0, rand_bytes,
+                               sizeof(rand_bytes), NULL,
+                               &result) == UUIDV7_STATUS_UNPRECEDENTED);
+  assert(result.n_generated == 0 && result.n_rand_consumed == 0 &&
+         result.n_timestamp_inc == 0 && result.n_clock_rollback == 0);
+}
+
 void test_from_to_string(void) {
   struct TestCase {
     uint8_t bytes[16];
@@ -130,6 +291,38 @@ void test_from_to_string(void) {
   }
 }
 
+void test_to_string_bulk(void) {
+  uint8_t uuids[37][16];
+  uint32_t x = 0x87654321;
+  for (int i = 0; i < 37; i++) {
+    for (int j = 0; j < 16; j++) {
+      x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+      uuids[i][j] = x >> 24;
+    }
+  }
+
+  int separators[] = {-1, '\0', '\n'};
+  for (int i = 0; i < 3; i++) {
+    size_t stride = separators[i] < 0 ? 36 : 37;
+    for (size_t n = 0; n <= 37; n++) {
+      char text[37 * 37 + 1];
+      memset(text, '*', sizeof(text));
+      size_t len = uuidv7_to_string_bulk(uuids[0], n, text, separators[i]);
+      assert(len == stride * n);
+      assert(text[len] == '*');
+
+      for (size_t j = 0; j < n; j++) {
+        char expected[37];
+        uuidv7_to_string(uuids[j], expected);
+        assert(memcmp(&text[stride * j], expected, 36) == 0);
+        if (separators[i] >= 0) {
+          assert(text[stride * j + 36] == separators[i]);
+        }
+      }
+    }
+  }
+}
+
 void test_from_string_error(void) {
   char cases[][40] = {
       "",
@@ -159,16 +352,322 @@ void test_from_string_error(void) {
   }
 }
 
+void test_from_string_bulk(void) {
+  char cases[][40] = {
+      "01234567-89ab-7000-8000-000000000000",
+      "ba987654-3210-7fff-bfff-ffffffffffff",
+      "017f22e2-79b0-7cc3-98c4-dc0c0c07398f",
+      "017F22E2-79B0-7CC3-98C4-DC0C0C07398F",
+      "01815515-70af-73bb-a597-7259",
+      "01815515_70af-73bb-a597-726461ccf7f4",
+      "01815515-70af 73bb-a597-726523b5414d",
+      "01815515-70af-73bb_a597-726523b5414d",
+      "01815515-70af-73bb-a597_726523b5414d",
+      "01815515-70af-73bb-a597-7266_8e4c2c3",
+      "0181-515-70af-73bb-a597-726778070225",
+      "01815515-70af-7 bb-a597-726849072769",
+      "0181g515-70af-73bb-a597-72699ab58e63",
+      "01815515-70af-73bb-a597-726ladf25973",
+      "01815515-70af-73zb-a597-726b873b50aa",
+      "01815515-70af-73bb-a597-726b873b50a\xaa",
+      "\xb0" "1815515-70af-73bb-a597-726b873b50aa",
+      "01815515-70af-73bb-a597-726b873b50:@",
+      "`G815515-70af-73bb-a597-726b873b50aa",
+      "/1815515-70af-73bb-a597-726b873b50aa",
+      "0181551570af73bba5977263d33e981a",
+  };
+  const int n_cases = sizeof(cases) / sizeof(cases[0]);
+
+  int separators[] = {-1, '\0', '\n'};
+  for (int i = 0; i < 3; i++) {
+    size_t stride = separators[i] < 0 ? 36 : 37;
+    char text[sizeof(cases) / sizeof(cases[0]) + 1][37];
+    for (int j = 0; j < n_cases; j++) {
+      memset(&text[0][stride * j], 0, stride);
+      memcpy(&text[0][stride * j], cases[j], strlen(cases[j]));
+      if (separators[i] >= 0) {
+        text[0][stride * j + 36] = separators[i];
+      }
+    }
+    // wrong separator
+    memcpy(&text[0][stride * n_cases], cases[0], 36);
+    text[0][stride * n_cases + 36] = separators[i] == '\n' ? '\0' : '\n';
+
+    uint8_t uuids[sizeof(cases) / sizeof(cases[0]) + 1][16];
+    uint8_t failed[sizeof(cases) / sizeof(cases[0]) + 1];
+    size_t n_failed = uuidv7_from_string_bulk(text[0], n_cases + 1,
+                                              separators[i], uuids[0], failed);
+
+    size_t n_expected = 0;
+    for (int j = 0; j <= n_cases; j++) {
+      char string[37];
+      memcpy(string, &text[0][stride * j], 36);
+      string[36] = '\0';
+      uint8_t uuid[16];
+      int err = uuidv7_from_string(string, uuid);
+      if (j == n_cases && separators[i] >= 0) {
+        err = -1;
+      }
+
+      assert(failed[j] == (err != 0));
+      if (err == 0) {
+        assert(memcmp(uuids[j], uuid, 16) == 0);
+      }
+      n_expected += err != 0;
+    }
+    assert(n_failed == n_expected);
+    assert(uuidv7_from_string_bulk(text[0], n_cases + 1, separators[i],
+                                   uuids[0], NULL) == n_expected);
+  }
+}
+
+void test_field_access(void) {
+  uint8_t uuid[16];
+  uint8_t rand_bytes[10] = {0xfc, 0xc3, 0x58, 0xc4, 0xdc,
+                            0x0c, 0x0c, 0x07, 0x39, 0x8f};
+  uuidv7_generate(uuid, 0x17f22e279b0, rand_bytes, NULL);
+  assert(uuidv7_get_timestamp(uuid) == 0x17f22e279b0);
+  assert(uuidv7_get_counter(uuid) == 0x330d8c4dc0c);
+
+  char buffer[37];
+  uuidv7_min_for_timestamp(0x17f22e279b0, uuid);
+  uuidv7_to_string(uuid, buffer);
+  assert(strcmp(buffer, "017f22e2-79b0-7000-8000-000000000000") == 0);
+  assert(uuidv7_get_counter(uuid) == 0);
+  uuidv7_max_for_timestamp(0x17f22e279b0, uuid);
+  uuidv7_to_string(uuid, buffer);
+  assert(strcmp(buffer, "017f22e2-79b0-7fff-bfff-ffffffffffff") == 0);
+  assert(uuidv7_get_counter(uuid) == 0x3ffffffffff);
+
+  // every UUIDv7 of the millisecond falls within [min, max]
+  uint8_t lo[16], hi[16];
+  uuidv7_min_for_timestamp(0x17f22e279b0, lo);
+  uuidv7_max_for_timestamp(0x17f22e279b0, hi);
+  for (int i = 0; i < 1000; i++) {
+    for (int j = 0; j < 10; j++) {
+      rand_bytes[j] = (uint8_t)(rand_bytes[j] * 31 + i + j);
+    }
+    uuidv7_generate(uuid, 0x17f22e279b0, rand_bytes, NULL);
+    assert(memcmp(lo, uuid, 16) <= 0 && memcmp(uuid, hi, 16) <= 0);
+    assert(uuidv7_get_timestamp(uuid) == 0x17f22e279b0);
+  }
+}
+
+void test_words(void) {
+  // generate the same sequence in both representations over all statuses
+  uint32_t x = 0x12345678;
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  uint8_t uuid[16], bytes[16];
+  uuidv7_words_t words;
+  for (int i = 0; i < 20000; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+      rand_bytes[j] = (uint8_t)(x >> 24);
+    }
+    switch (x % 32) {
+    case 0: // new timestamp with a nearly exhausted counter
+      memset(rand_bytes, 0xff, 6);
+      unix_ts_ms++;
+      break;
+    case 1:
+      unix_ts_ms -= 1 + x % 10000;
+      break;
+    case 2:
+      unix_ts_ms -= 10001;
+      break;
+    case 3:
+      unix_ts_ms += 10000;
+      break;
+    }
+    int8_t status = uuidv7_generate(uuid, unix_ts_ms, rand_bytes,
+                                    i > 0 ? uuid : NULL);
+    assert(uuidv7_generate_words(&words, unix_ts_ms, rand_bytes,
+                                 i > 0 ? &words : NULL) == status);
+    uuidv7_words_to_bytes(&words, bytes);
+    assert(memcmp(uuid, bytes, 16) == 0);
+    assert(uuidv7_words_get_timestamp(&words) == uuidv7_get_timestamp(uuid));
+    assert(uuidv7_words_get_counter(&words) == uuidv7_get_counter(uuid));
+  }
+
+  // errors
+  uint8_t ff[10];
+  memset(ff, 0xff, sizeof(ff));
+  uint64_t max_timestamp = ((uint64_t)1 << 48) - 1;
+  uuidv7_generate_words(&words, max_timestamp, ff, NULL);
+  uuidv7_words_t prev = words;
+  assert(uuidv7_generate_words(&words, max_timestamp, ff, &prev) ==
+         UUIDV7_STATUS_ERR_TIMESTAMP_OVERFLOW);
+  assert(uuidv7_generate_words(&words, max_timestamp + 1, ff, NULL) ==
+         UUIDV7_STATUS_ERR_TIMESTAMP);
+
+  // arbitrary values convert in both directions and to the same strings
+  for (int i = 0; i < 10000; i++) {
+    for (int j = 0; j < 16; j++) {
+      x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+      uuid[j] = (uint8_t)(x >> 24);
+    }
+    uuidv7_words_from_bytes(uuid, &words);
+    uuidv7_words_to_bytes(&words, bytes);
+    assert(memcmp(uuid, bytes, 16) == 0);
+
+    char expected[37], text[37];
+    uuidv7_to_string(uuid, expected);
+    memset(text, 0x55, sizeof(text));
+    uuidv7_words_to_string(&words, text);
+    assert(strcmp(text, expected) == 0);
+
+    uuidv7_words_t parsed;
+    for (int j = 0; j < 36; j++) {
+      text[j] = (char)(x >> j & 1 ? toupper(text[j]) : text[j]);
+    }
+    assert(uuidv7_words_from_string(text, &parsed) == 0);
+    assert(parsed.hi == words.hi && parsed.lo == words.lo);
+  }
+
+  // every character at every position is accepted or rejected as by
+  // uuidv7_from_string()
+  char text[37];
+  uuidv7_to_string(uuid, text);
+  for (int j = 0; j < 36; j++) {
+    char c = text[j];
+    for (int k = 0; k < 256; k++) {
+      text[j] = (char)k;
+      uuidv7_words_t parsed;
+      int err = uuidv7_from_string(text, bytes);
+      assert((uuidv7_words_from_string(text, &parsed) != 0) == (err != 0));
+      if (err == 0) {
+        uuidv7_words_to_bytes(&parsed, uuid);
+        assert(memcmp(uuid, bytes, 16) == 0);
+      }
+    }
+    text[j] = c;
+  }
+}
+
+/** Validates one entry as uuidv7_validate_bulk() should. */
+static int is_valid_entry(const uint8_t *uuid, const uint8_t *prev,
+                          uint64_t min_timestamp, uint64_t max_timestamp,
+                          int ascending) {
+  static const uint8_t NIL[16] = {0};
+  uint64_t timestamp = uuidv7_get_timestamp(uuid);
+  return (uuid[6] >> 4) == 7 && (uuid[8] >> 6) == 2 &&
+         timestamp >= min_timestamp && timestamp <= max_timestamp &&
+         (!ascending || memcmp(prev != NULL ? prev : NIL, uuid, 16) < 0);
+}
+
+void test_validate_bulk(void) {
+  enum { N = 203 };
+  static uint8_t uuids[N][16];
+  static char text[N][37];
+  static uint8_t decoded[N][16];
+  uint8_t bitmap[(N + 7) / 8], bitmap_str[(N + 7) / 8];
+  uint32_t x = 0x9e3779b9;
+
+  for (int round = 0; round < 300; round++) {
+    // mostly ascending UUIDv7s with occasional defects
+    uint64_t unix_ts_ms = 0x17f22e279b0;
+    for (int i = 0; i < N; i++) {
+      uint8_t rand_bytes[10];
+      for (int j = 0; j < 10; j++) {
+        x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+        rand_bytes[j] = (uint8_t)x;
+      }
+      unix_ts_ms += x % 3 == 0;
+      uuidv7_generate(uuids[i], unix_ts_ms, rand_bytes,
+                      i > 0 ? uuids[i - 1] : NULL);
+      switch ((x >> 8) % 40) {
+      case 0:
+        uuids[i][6] ^= 0x30; // version
+        break;
+      case 1:
+        uuids[i][8] ^= 0x40; // variant
+        break;
+      case 2:
+        memcpy(uuids[i], uuids[i > 0 ? i - 1 : 0], 16); // duplicate
+        break;
+      case 3:
+        uuids[i][0] ^= 0x80; // far future or past
+        break;
+      case 4:
+        uuids[i][5] -= 5; // slightly out of order
+        break;
+      }
+    }
+
+    size_t n = (size_t)x % (N + 1);
+    int ascending = round % 2;
+    const uint64_t base = 0x17f22e279b0;
+    uint64_t min_timestamp = round % 3 ? base + x % 20 : 0;
+    uint64_t max_timestamp = round % 5 ? base + x % 200 : UINT64_MAX;
+    const uint8_t *prev = round % 7 ? NULL : uuids[x % N];
+
+    size_t n_invalid = uuidv7_validate_bulk(
+        uuids[0], n, min_timestamp, max_timestamp, ascending, prev, bitmap);
+    uuidv7_to_string_bulk(uuids[0], n, text[0], '\n');
+    if (n > 0 && round % 4 == 0) {
+      text[x % n][x % 36] = 'x';
+    }
+    size_t n_invalid_str = uuidv7_validate_string_bulk(
+        text[0], n, '\n', min_timestamp, max_timestamp, ascending, prev,
+        decoded[0], bitmap_str);
+
+    size_t n_expected = 0, n_expected_str = 0;
+    for (size_t i = 0; i < n; i++) {
+      const uint8_t *p = i > 0 ? uuids[i - 1] : prev;
+      int valid = is_valid_entry(uuids[i], p, min_timestamp, max_timestamp,
+                                 ascending);
+      assert(((bitmap[i / 8] >> (i % 8)) & 1) == valid);
+      n_expected += !valid;
+
+      uint8_t uuid[16];
+      char string[37];
+      memcpy(string, text[i], 36);
+      string[36] = '\0';
+      if (uuidv7_from_string(string, uuid) == 0) {
+        assert(memcmp(decoded[i], uuid, 16) == 0);
+        p = i > 0 ? decoded[i - 1] : prev;
+        valid = is_valid_entry(uuid, p, min_timestamp, max_timestamp,
+                               ascending);
+      } else {
+        valid = 0;
+      }
+      assert(((bitmap_str[i / 8] >> (i % 8)) & 1) == valid);
+      n_expected_str += !valid;
+    }
+    for (size_t i = n; i % 8 != 0; i++) {
+      assert(((bitmap[i / 8] >> (i % 8)) & 1) == 0);
+      assert(((bitmap_str[i / 8] >> (i % 8)) & 1) == 0);
+    }
+    assert(n_invalid == n_expected);
+    assert(n_invalid_str == n_expected_str);
+  }
+}
+
 #ifndef NDEBUG
 int main(void) {
   test_unprecedented();
   fprintf(stderr, "  %s: ok\n", "test_unprecedented");
   test_with_prev();
   fprintf(stderr, "  %s: ok\n", "test_with_prev");
+  test_gen();
+  fprintf(stderr, "  %s: ok\n", "test_gen");
+  test_generate_batch();
+  fprintf(stderr, "  %s: ok\n", "test_generate_batch");
   test_from_to_string();
   fprintf(stderr, "  %s: ok\n", "test_from_to_string");
+  test_to_string_bulk();
+  fprintf(stderr, "  %s: ok\n", "test_to_string_bulk");
   test_from_string_error();
   fprintf(stderr, "  %s: ok\n", "test_from_string_error");
+  test_from_string_bulk();
+  fprintf(stderr, "  %s: ok\n", "test_from_string_bulk");
+  test_field_access();
+  fprintf(stderr, "  %s: ok\n", "test_field_access");
+  test_words();
+  fprintf(stderr, "  %s: ok\n", "test_words");
+  test_validate_bulk();
+  fprintf(stderr, "  %s: ok\n", "test_validate_bulk");
 
   return 0;
 }
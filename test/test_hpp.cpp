@@ -0,0 +1,326 @@
+#include "uuidv7.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+using namespace uuidv7::literals;
+
+static_assert(sizeof(uuidv7::uuid) == 16);
+static_assert(std::is_trivially_copyable_v<uuidv7::uuid>);
+
+// parsing and accessors are usable in constant expressions
+constexpr uuidv7::uuid LITERAL = "017F22E2-79B0-7cc3-98c4-dc0c0c07398f"_uuid;
+static_assert(LITERAL.hi() == 0x017f22e279b07cc3);
+static_assert(LITERAL.lo() == 0x98c4dc0c0c07398f);
+static_assert(LITERAL.timestamp() == 0x17f22e279b0);
+static_assert(LITERAL.counter() == (0xcc3ull << 30 | 0x18c4dc0c));
+static_assert(LITERAL.rand() == 0x0c07398f);
+static_assert(LITERAL.version() == 7 && LITERAL.variant() == 2);
+static_assert(!uuidv7::uuid::parse("017f22e2-79b0-7cc3-98c4-dc0c0c07398"));
+static_assert(uuidv7::uuid() < LITERAL && LITERAL <= LITERAL);
+
+/** Generates a monotonic sequence of UUIDs in both representations. */
+static void generate(std::vector<uuidv7::uuid> &uuids,
+                     std::vector<uint8_t> &bytes, size_t n) {
+  uint32_t x = 0x12345678;
+  uint8_t rand_bytes[10];
+  uint8_t prev[16];
+  bytes.resize(16 * n);
+  for (size_t i = 0; i < n; i++) {
+    for (int j = 0; j < 10; j++) {
+      x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+      rand_bytes[j] = x >> 24;
+    }
+    // advance the timestamp only occasionally to mix statuses
+    uint64_t unix_ts_ms = 0x17f22e279b0 + i / 64;
+    uuidv7_generate(&bytes[16 * i], unix_ts_ms, rand_bytes,
+                    i == 0 ? NULL : prev);
+    memcpy(prev, &bytes[16 * i], 16);
+    uuids.push_back(uuidv7::uuid::from_bytes(&bytes[16 * i]));
+  }
+}
+
+void test_bytes_and_strings(void) {
+  std::vector<uuidv7::uuid> uuids;
+  std::vector<uint8_t> bytes;
+  generate(uuids, bytes, 1000);
+  for (size_t i = 0; i < uuids.size(); i++) {
+    uint8_t buffer[16];
+    uuids[i].to_bytes(buffer);
+    assert(memcmp(buffer, &bytes[16 * i], 16) == 0);
+
+    char expected[37];
+    uuidv7_to_string(&bytes[16 * i], expected);
+    assert(uuids[i].to_string() == expected);
+    assert(uuidv7::uuid::parse(expected) == uuids[i]);
+
+    std::ostringstream os;
+    os << uuids[i];
+    assert(os.str() == expected);
+
+#ifdef __cpp_lib_format
+    assert(std::format("{}", uuids[i]) == expected);
+#endif
+  }
+}
+
+void test_parse_error(void) {
+  // same cases as test_from_string_error() in test_core.c
+  const char *cases[] = {
+      "",
+      " 01815515-70af-73bb-a597-725c2086f131",
+      "01815515-70af-73bb-a597-725d90351474 ",
+      " 01815515-70af-73bb-a597-725eb688399d ",
+      "+01815515-70af-73bb-a597-725f825e57d7",
+      "-01815515-70af-73bb-a597-72602859e906",
+      "+1815515-70af-73bb-a597-7261115ae9fd",
+      "-1815515-70af-73bb-a597-7262c43b6483",
+      "0181551570af73bba5977263d33e981a",
+      "01815515_70af-73bb-a597-726461ccf7f4",
+      "01815515-70af 73bb-a597-726523b5414d",
+      "01815515-70af-73bb-a597-7266_8e4c2c3",
+      "0181-515-70af-73bb-a597-726778070225",
+      "01815515-70af-7 bb-a597-726849072769",
+      "0181g515-70af-73bb-a597-72699ab58e63",
+      "01815515-70af-73bb-a597-726ladf25973",
+      "01815515-70af-73zb-a597-726b873b50aa",
+  };
+  for (const char *c : cases) {
+    assert(!uuidv7::uuid::parse(c));
+  }
+
+  bool thrown = false;
+  try {
+    operator""_uuid(cases[1], strlen(cases[1]));
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+void test_order(void) {
+  std::vector<uuidv7::uuid> uuids;
+  std::vector<uint8_t> bytes;
+  generate(uuids, bytes, 1000);
+  for (size_t i = 0; i < uuids.size(); i++) {
+    for (size_t j = i; j < uuids.size() && j < i + 70; j++) {
+      int c = memcmp(&bytes[16 * i], &bytes[16 * j], 16);
+      assert((uuids[i] < uuids[j]) == (c < 0));
+      assert((uuids[i] == uuids[j]) == (c == 0));
+      assert((uuids[j] > uuids[i]) == (c < 0));
+      assert((uuids[j] >= uuids[i]) == (c <= 0));
+    }
+  }
+  std::vector<uuidv7::uuid> shuffled(uuids.rbegin(), uuids.rend());
+  std::sort(shuffled.begin(), shuffled.end());
+  assert(shuffled == uuids);
+}
+
+void test_hash(void) {
+  // UUIDs sharing a timestamp must spread over the low bits of hashes
+  std::vector<uuidv7::uuid> uuids;
+  std::vector<uint8_t> bytes;
+  generate(uuids, bytes, 64 * 256);
+  std::hash<uuidv7::uuid> hasher;
+  uint32_t bins[256] = {0};
+  std::unordered_set<size_t> hashes;
+  for (const uuidv7::uuid &u : uuids) {
+    size_t h = hasher(u);
+    bins[h & 255]++;
+    hashes.insert(h);
+  }
+  assert(hashes.size() == uuids.size());
+  for (int i = 0; i < 256; i++) {
+    assert(bins[i] > 64 / 2 && bins[i] < 64 * 2);
+  }
+
+  std::unordered_set<uuidv7::uuid> set(uuids.begin(), uuids.end());
+  assert(set.size() == uuids.size() && set.count(uuids[100]) == 1);
+}
+
+/** Clock policy that replays fixed timestamps. */
+struct fixed_clock {
+  uint64_t unix_ts_ms = 0;
+  uint64_t now_ms() const noexcept { return unix_ts_ms; }
+};
+
+using default_generator =
+    uuidv7::basic_generator<fixed_clock, uuidv7::buffer_rand>;
+
+void test_generator_default(void) {
+  // drive uuidv7_generate() over a mix of all statuses and record the random
+  // bytes it consumes, then replay them through the template
+  uint32_t x = 0x12345678;
+  std::vector<uint64_t> timestamps;
+  std::vector<uint8_t> expected, rand_stream;
+  std::vector<int8_t> statuses;
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  uint8_t uuid[16], prev[16];
+  for (int i = 0; i < 20000; i++) {
+    uint8_t rand_bytes[10];
+    for (int j = 0; j < 10; j++) {
+      x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+      rand_bytes[j] = x >> 24;
+    }
+    switch (x % 32) {
+    case 0: // new timestamp with a nearly exhausted counter
+      memset(rand_bytes, 0xff, 6);
+      rand_bytes[5] = 0xff - x % 3;
+      unix_ts_ms++;
+      break;
+    case 1:
+      unix_ts_ms += 1 + x % 3;
+      break;
+    case 2: // small rollback
+      unix_ts_ms -= 1 + x % 10000;
+      break;
+    case 3: // large rollback
+      unix_ts_ms -= 10001 + x % 5;
+      break;
+    case 4:
+      unix_ts_ms += 10000;
+      break;
+    }
+    int8_t status = uuidv7_generate(uuid, unix_ts_ms, rand_bytes,
+                                    i == 0 ? NULL : prev);
+    assert(status >= 0);
+    size_t n_rand = status == UUIDV7_STATUS_COUNTER_INC ? 4 : 10;
+    rand_stream.insert(rand_stream.end(), rand_bytes, rand_bytes + n_rand);
+    timestamps.push_back(unix_ts_ms);
+    statuses.push_back(status);
+    expected.insert(expected.end(), uuid, uuid + 16);
+    memcpy(prev, uuid, 16);
+  }
+  for (int s = UUIDV7_STATUS_UNPRECEDENTED; s <= UUIDV7_STATUS_CLOCK_ROLLBACK;
+       s++) {
+    assert(std::count(statuses.begin(), statuses.end(), s) > 0);
+  }
+
+  default_generator g(fixed_clock(),
+                      uuidv7::buffer_rand(rand_stream.data(),
+                                          rand_stream.size()));
+  for (size_t i = 0; i < timestamps.size(); i++) {
+    g.clock().unix_ts_ms = timestamps[i];
+    assert(g.generate(uuid) == statuses[i]);
+    assert(memcmp(uuid, &expected[16 * i], 16) == 0);
+  }
+  assert(g.rand().take(1) == nullptr);
+
+  // errors leave the generator unchanged
+  assert(g.generate(uint64_t{1} << 48, uuid) == UUIDV7_STATUS_ERR_TIMESTAMP);
+  assert(g.generate(timestamps.back(), uuid) ==
+         UUIDV7_STATUS_ERR_RAND_SHORTAGE);
+  uint8_t ff[10];
+  memset(ff, 0xff, sizeof(ff));
+  default_generator h(fixed_clock(), uuidv7::buffer_rand(ff, sizeof(ff)));
+  assert(h.generate((uint64_t{1} << 48) - 1, uuid) ==
+         UUIDV7_STATUS_UNPRECEDENTED);
+  assert(h.generate((uint64_t{1} << 48) - 1, uuid) ==
+         UUIDV7_STATUS_ERR_TIMESTAMP_OVERFLOW);
+  assert((size_t)uuidv7_status_n_rand_consumed(UUIDV7_STATUS_COUNTER_INC) ==
+         default_generator::N_RAND_COUNTER_INC);
+}
+
+void test_generator_layouts(void) {
+  std::vector<uint8_t> rand_stream(1 << 20);
+  uint32_t x = 0x12345678;
+  for (uint8_t &e : rand_stream) {
+    x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+    e = x >> 24;
+  }
+
+  // 8-bit counter refreshes 66 random bits on each increment and overflows
+  // after at most 255 UUIDs
+  using narrow = uuidv7::basic_generator<fixed_clock, uuidv7::buffer_rand, 8>;
+  static_assert(narrow::MAX_COUNTER == 255 && narrow::N_RAND_COUNTER_INC == 9);
+  narrow g(fixed_clock(),
+           uuidv7::buffer_rand(rand_stream.data(), rand_stream.size()));
+  uint8_t uuid[16], prev[16];
+  int n_timestamp_inc = 0, n_counter_inc = 0;
+  uint8_t lower_or = 0;
+  for (int i = 0; i < 10000; i++) {
+    int8_t status = g.generate(0x17f22e279b0, uuid);
+    assert(status >= 0);
+    if (i > 0) {
+      assert(memcmp(prev, uuid, 16) < 0);
+      n_timestamp_inc += status == UUIDV7_STATUS_TIMESTAMP_INC;
+      n_counter_inc += status == UUIDV7_STATUS_COUNTER_INC;
+      if (status == UUIDV7_STATUS_COUNTER_INC) {
+        // the counter occupies the 4 bits after ver and the next 4 bits
+        assert((((uuid[6] & 0x0f) << 4 | uuid[7] >> 4) ==
+                ((prev[6] & 0x0f) << 4 | prev[7] >> 4) + 1));
+        lower_or |= uuid[7] & 0x0f;
+      }
+    }
+    assert((uuid[6] & 0xf0) == 0x70 && (uuid[8] & 0xc0) == 0x80);
+    memcpy(prev, uuid, 16);
+  }
+  assert(n_timestamp_inc > 10000 / 256 && n_counter_inc > 9000);
+  assert(lower_or == 0x0f); // the bits below the counter are random
+
+  // 1-bit counter with no rollback tolerance
+  using strict =
+      uuidv7::basic_generator<fixed_clock, uuidv7::buffer_rand, 1, 0>;
+  strict s(fixed_clock(),
+           uuidv7::buffer_rand(rand_stream.data(), rand_stream.size()));
+  assert(s.generate(1000, uuid) == UUIDV7_STATUS_UNPRECEDENTED);
+  assert(s.generate(999, uuid) == UUIDV7_STATUS_CLOCK_ROLLBACK);
+  if (s.generate(999, uuid) == UUIDV7_STATUS_COUNTER_INC) {
+    assert(s.generate(999, uuid) == UUIDV7_STATUS_TIMESTAMP_INC);
+  } else {
+    // the random counter started at 1 and moved the timestamp to 1000
+    assert(uuidv7_get_timestamp(uuid) == 1000);
+    assert(s.generate(999, uuid) == UUIDV7_STATUS_CLOCK_ROLLBACK);
+  }
+
+  // unlimited tolerance never resets the generator
+  using lenient = uuidv7::basic_generator<fixed_clock, uuidv7::buffer_rand, 42,
+                                          UINT64_MAX>;
+  lenient l(fixed_clock(),
+            uuidv7::buffer_rand(rand_stream.data(), rand_stream.size()));
+  assert(l.generate((uint64_t{1} << 48) - 1, prev) ==
+         UUIDV7_STATUS_UNPRECEDENTED);
+  assert(l.generate(0, uuid) == UUIDV7_STATUS_COUNTER_INC);
+  assert(memcmp(prev, uuid, 16) < 0);
+}
+
+void test_generator_system(void) {
+  uuidv7::generator g;
+  uint64_t before = uuidv7::system_clock().now_ms();
+  uuidv7::uuid prev = g();
+  for (int i = 0; i < 10000; i++) {
+    uuidv7::uuid u = g();
+    assert(prev < u && u.version() == 7 && u.variant() == 2);
+    prev = u;
+  }
+  uint64_t after = uuidv7::system_clock().now_ms();
+  assert(before <= prev.timestamp() && prev.timestamp() <= after + 1);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_bytes_and_strings();
+  fprintf(stderr, "  %s: ok\n", "test_bytes_and_strings");
+  test_parse_error();
+  fprintf(stderr, "  %s: ok\n", "test_parse_error");
+  test_order();
+  fprintf(stderr, "  %s: ok\n", "test_order");
+  test_hash();
+  fprintf(stderr, "  %s: ok\n", "test_hash");
+  test_generator_default();
+  fprintf(stderr, "  %s: ok\n", "test_generator_default");
+  test_generator_layouts();
+  fprintf(stderr, "  %s: ok\n", "test_generator_layouts");
+  test_generator_system();
+  fprintf(stderr, "  %s: ok\n", "test_generator_system");
+
+  return 0;
+}
+#endif
@@ -0,0 +1,134 @@
+#include "uuidv7.h"
+#include "uuidv7_index.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define N_UUIDS 100000
+
+static uint8_t uuids[16 * N_UUIDS];
+
+static size_t linear_lower_bound(const uint8_t *array, size_t n,
+                                 uint64_t unix_ts_ms) {
+  size_t i = 0;
+  while (i < n && uuidv7_get_timestamp(&array[16 * i]) < unix_ts_ms) {
+    i++;
+  }
+  return i;
+}
+
+/** Compares the index with a linear scan over the first `n` UUIDs. */
+static void check(const uint8_t *array, size_t n) {
+  size_t n_keys = uuidv7_index_n_keys(n);
+  uint64_t *keys = (uint64_t *)malloc(sizeof(uint64_t) * n_keys);
+  uuidv7_index_t index;
+  uuidv7_index_build(&index, array, n, keys);
+
+  uint64_t first = n > 0 ? uuidv7_get_timestamp(array) : 0x17f22e279b0;
+  uint64_t last = n > 0 ? uuidv7_get_timestamp(&array[16 * (n - 1)]) : first;
+  for (uint64_t t = first - 2; t <= last + 2; t += 1 + next_rand() % 5) {
+    assert(uuidv7_index_lower_bound(&index, t) ==
+           linear_lower_bound(array, n, t));
+  }
+  assert(uuidv7_index_lower_bound(&index, 0) == 0);
+  assert(uuidv7_index_lower_bound(&index, UINT64_MAX) == n);
+
+  for (int k = 0; k < 100; k++) {
+    uint64_t t1 = first - 1 + next_rand() % (last - first + 3);
+    uint64_t t2 = t1 + next_rand() % 8;
+    size_t begin = 0;
+    size_t count = uuidv7_index_range(&index, t1, t2, &begin);
+    assert(begin == linear_lower_bound(array, n, t1));
+    assert(begin + count == linear_lower_bound(array, n, t2 + 1));
+    for (size_t i = begin; i < begin + count; i++) {
+      uint64_t t = uuidv7_get_timestamp(&array[16 * i]);
+      assert(t1 <= t && t <= t2);
+    }
+
+    // byte-order bounds agree with the timestamp range
+    uint8_t lo[16], hi[16];
+    uuidv7_min_for_timestamp(t1, lo);
+    uuidv7_max_for_timestamp(t2, hi);
+    for (size_t i = begin; i < begin + count; i++) {
+      assert(memcmp(lo, &array[16 * i], 16) <= 0);
+      assert(memcmp(&array[16 * i], hi, 16) <= 0);
+    }
+    assert(begin == 0 || memcmp(&array[16 * (begin - 1)], lo, 16) < 0);
+    assert(begin + count == n ||
+           memcmp(hi, &array[16 * (begin + count)], 16) < 0);
+
+    assert(uuidv7_index_range(&index, t2 + 1, t1, &begin) == 0);
+  }
+  size_t begin = 1;
+  assert(uuidv7_index_range(&index, 0, UINT64_MAX, &begin) == n);
+  assert(begin == 0);
+  free(keys);
+}
+
+void test_lower_bound(void) {
+  // some milliseconds hold many UUIDs and others none
+  generate_sequence(uuids, N_UUIDS, 0x17f22e279b0, 3, 64);
+  check(uuids, N_UUIDS);
+
+  // sizes around stride and tree boundaries
+  size_t sizes[] = {0,
+                    1,
+                    2,
+                    UUIDV7_INDEX_STRIDE - 1,
+                    UUIDV7_INDEX_STRIDE,
+                    UUIDV7_INDEX_STRIDE + 1,
+                    UUIDV7_INDEX_STRIDE * 3,
+                    UUIDV7_INDEX_STRIDE * 4 + 1,
+                    UUIDV7_INDEX_STRIDE * 127,
+                    UUIDV7_INDEX_STRIDE * 128,
+                    UUIDV7_INDEX_STRIDE * 128 + 7};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    check(uuids, sizes[i]);
+  }
+}
+
+void test_duplicates(void) {
+  // long runs of one timestamp span several strides
+  uint8_t rand_bytes[10] = {0};
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uuidv7_generate(&uuids[16 * i], 0x17f22e279b0 + i / 1000, rand_bytes,
+                    i > 0 ? &uuids[16 * (i - 1)] : NULL);
+  }
+  check(uuids, N_UUIDS);
+}
+
+void test_mmap(void) {
+  // index a file of binary records in place
+  generate_sequence(uuids, N_UUIDS, 0x17f22e279b0, 3, 64);
+  char path[] = "/tmp/uuidv7_h_test_index_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  unlink(path);
+  ssize_t n_written = write(fd, uuids, sizeof(uuids));
+  assert(n_written == (ssize_t)sizeof(uuids));
+
+  void *map = mmap(NULL, sizeof(uuids), PROT_READ, MAP_PRIVATE, fd, 0);
+  assert(map != MAP_FAILED);
+  close(fd);
+  check((const uint8_t *)map, N_UUIDS);
+  munmap(map, sizeof(uuids));
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_lower_bound();
+  fprintf(stderr, "  %s: ok\n", "test_lower_bound");
+  test_duplicates();
+  fprintf(stderr, "  %s: ok\n", "test_duplicates");
+  test_mmap();
+  fprintf(stderr, "  %s: ok\n", "test_mmap");
+
+  return 0;
+}
+#endif
@@ -0,0 +1,213 @@
+#include "uuidv7.h"
+#include "uuidv7_state64.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define N_PROCS 8
+#define N_SAMPLES 20000 // per process
+#define N_TICKETS (2 * N_PROCS * N_SAMPLES)
+#define N_KILLS 20
+
+struct Sample {
+  uint8_t uuid[16];
+  uint64_t begin; // ticket taken before generation
+  uint64_t end;   // ticket taken after generation
+};
+
+/** Memory shared between the test process and its children. */
+struct Shared {
+  uint64_t ticket;
+  struct Sample samples[N_PROCS][N_SAMPLES];
+
+  // UUIDs generated by the child being killed
+  uint64_t n_logged;
+  uint8_t log[1 << 16][16];
+};
+static struct Shared *shared;
+
+// sample that took each ticket, tagged with the low bit set for end tickets
+static uintptr_t events[N_TICKETS];
+
+static void generate(struct Sample *e) {
+  for (int i = 0; i < N_SAMPLES; i++, e++) {
+    e->begin = __atomic_fetch_add(&shared->ticket, 1, __ATOMIC_SEQ_CST);
+    int status = uuidv7_new(e->uuid);
+    assert(status >= 0);
+    (void)status;
+    e->end = __atomic_fetch_add(&shared->ticket, 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+void setup(void) {
+  pid_t pids[N_PROCS];
+  for (int i = 0; i < N_PROCS; i++) {
+    pids[i] = fork();
+    assert(pids[i] >= 0);
+    if (pids[i] == 0) {
+      generate(shared->samples[i]);
+      _exit(0);
+    }
+  }
+  for (int i = 0; i < N_PROCS; i++) {
+    int wstatus;
+    waitpid(pids[i], &wstatus, 0);
+    assert(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0);
+  }
+}
+
+static int compare_uuids(const void *a, const void *b) {
+  return memcmp(a, b, 16);
+}
+
+void test_uniqueness(void) {
+  uint8_t(*uuids)[16] =
+      (uint8_t(*)[16])malloc(sizeof(uint8_t[16]) * N_PROCS * N_SAMPLES);
+  assert(uuids != NULL);
+  for (int i = 0; i < N_PROCS; i++) {
+    for (int j = 0; j < N_SAMPLES; j++) {
+      memcpy(uuids[i * N_SAMPLES + j], shared->samples[i][j].uuid, 16);
+    }
+  }
+
+  qsort(uuids, N_PROCS * N_SAMPLES, 16, compare_uuids);
+  for (int i = 1; i < N_PROCS * N_SAMPLES; i++) {
+    assert(memcmp(uuids[i - 1], uuids[i], 16) < 0);
+  }
+  free(uuids);
+}
+
+void test_order_across_processes(void) {
+  // a UUID must be greater than every UUID whose generation finished before
+  // its generation began in any process
+  for (int i = 0; i < N_PROCS; i++) {
+    for (int j = 0; j < N_SAMPLES; j++) {
+      struct Sample *e = &shared->samples[i][j];
+      assert(e->begin < N_TICKETS && e->end < N_TICKETS);
+      events[e->begin] = (uintptr_t)e;
+      events[e->end] = (uintptr_t)e | 1;
+    }
+  }
+
+  uint8_t max_finished[16] = {0};
+  for (int i = 0; i < N_TICKETS; i++) {
+    struct Sample *e = (struct Sample *)(events[i] & ~(uintptr_t)1);
+    if (events[i] & 1) {
+      if (memcmp(max_finished, e->uuid, 16) < 0) {
+        memcpy(max_finished, e->uuid, 16);
+      }
+    } else {
+      assert(memcmp(max_finished, e->uuid, 16) < 0);
+    }
+  }
+}
+
+void test_crash_recovery(void) {
+  // a process killed at an arbitrary point must not block or break the
+  // sequence for the others
+  for (int k = 0; k < N_KILLS; k++) {
+    shared->n_logged = 0;
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+      for (;;) {
+        uint8_t uuid[16];
+        if (uuidv7_new(uuid) < 0) {
+          _exit(1);
+        }
+        uint64_t n = __atomic_load_n(&shared->n_logged, __ATOMIC_RELAXED);
+        memcpy(shared->log[n % (1 << 16)], uuid, 16);
+        __atomic_store_n(&shared->n_logged, n + 1, __ATOMIC_RELEASE);
+      }
+    }
+
+    struct timespec tp = {0, 1000000 + (k % 5) * 777777};
+    nanosleep(&tp, NULL);
+    kill(pid, SIGKILL);
+    int wstatus;
+    waitpid(pid, &wstatus, 0);
+    assert(WIFSIGNALED(wstatus));
+
+    uint8_t uuid[16];
+    assert(uuidv7_new(uuid) >= 0);
+    uint64_t n = __atomic_load_n(&shared->n_logged, __ATOMIC_ACQUIRE);
+    if (n > 0) {
+      assert(memcmp(shared->log[(n - 1) % (1 << 16)], uuid, 16) < 0);
+    }
+  }
+}
+
+static uint64_t now_ms(void) {
+  struct timespec tp;
+  clock_gettime(CLOCK_REALTIME, &tp);
+  return (uint64_t)tp.tv_sec * 1000 + tp.tv_nsec / 1000000;
+}
+
+void test_stale_state(const char *name) {
+  // a state left long ago must be restored exactly rather than relative to the
+  // current time, even when the idle time is close to a multiple of 2^21 ms
+  int fd = shm_open(name, O_RDWR, 0);
+  assert(fd >= 0);
+  uint64_t *object = (uint64_t *)mmap(
+      NULL, 2 * sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  assert(object != MAP_FAILED);
+  close(fd);
+
+  const int64_t gaps[] = {((int64_t)1 << 21) - 5000, ((int64_t)1 << 21),
+                          ((int64_t)5 << 20) + 3000};
+  for (size_t k = 0; k < sizeof(gaps) / sizeof(gaps[0]); k++) {
+    uint8_t prev[16], uuid[16], rand_bytes[10] = {0};
+    uint64_t t0 = now_ms() - (uint64_t)gaps[k];
+    assert(uuidv7_generate(prev, t0, rand_bytes, NULL) >= 0);
+    object[0] = uuidv7_state64_pack(prev); // state word
+    object[1] = t0;                        // full timestamp of the update
+
+    uint64_t begin = now_ms();
+    assert(uuidv7_new(uuid) == UUIDV7_STATUS_NEW_TIMESTAMP);
+    uint64_t timestamp = uuidv7_get_timestamp(uuid);
+    assert(timestamp >= begin && timestamp <= now_ms());
+  }
+  munmap(object, 2 * sizeof(uint64_t));
+}
+
+#ifndef NDEBUG
+int main(void) {
+  // use a private shared memory object unless the caller specifies one
+  char name[64];
+  int owns_name = getenv("UUIDV7_SHM_NAME") == NULL;
+  if (owns_name) {
+    snprintf(name, sizeof(name), "/uuidv7_h_test_%ld", (long)getpid());
+    setenv("UUIDV7_SHM_NAME", name, 1);
+  }
+
+  shared = (struct Shared *)mmap(NULL, sizeof(struct Shared),
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  assert(shared != MAP_FAILED);
+
+  setup();
+
+  test_uniqueness();
+  fprintf(stderr, "  %s: ok\n", "test_uniqueness");
+  test_order_across_processes();
+  fprintf(stderr, "  %s: ok\n", "test_order_across_processes");
+  test_crash_recovery();
+  fprintf(stderr, "  %s: ok\n", "test_crash_recovery");
+  test_stale_state(getenv("UUIDV7_SHM_NAME"));
+  fprintf(stderr, "  %s: ok\n", "test_stale_state");
+
+  if (owns_name) {
+    shm_unlink(name);
+  }
+  return 0;
+}
+#endif
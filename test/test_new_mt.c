@@ -0,0 +1,177 @@
+#include "uuidv7.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_THREADS 16
+#define N_SAMPLES 20000 // per thread
+#define N_TICKETS (2 * N_THREADS * N_SAMPLES)
+
+struct Sample {
+  uint8_t uuid[16];
+  uint64_t begin; // ticket taken before generation
+  uint64_t end;   // ticket taken after generation
+};
+static struct Sample samples[N_THREADS][N_SAMPLES];
+static uint64_t ticket = 0;
+
+// sample that took each ticket, tagged with the low bit set for end tickets
+static uintptr_t events[N_TICKETS];
+
+static void *generate(void *arg) {
+  struct Sample *e = (struct Sample *)arg;
+  for (int i = 0; i < N_SAMPLES; i++, e++) {
+    e->begin = __atomic_fetch_add(&ticket, 1, __ATOMIC_SEQ_CST);
+    int status = uuidv7_new(e->uuid);
+    assert(status >= 0);
+    (void)status;
+    e->end = __atomic_fetch_add(&ticket, 1, __ATOMIC_SEQ_CST);
+  }
+  return NULL;
+}
+
+void setup(void) {
+  pthread_t threads[N_THREADS];
+  for (int i = 0; i < N_THREADS; i++) {
+    int err = pthread_create(&threads[i], NULL, generate, samples[i]);
+    assert(err == 0);
+    (void)err;
+  }
+  for (int i = 0; i < N_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+}
+
+static int compare_uuids(const void *a, const void *b) {
+  return memcmp(a, b, 16);
+}
+
+void test_format(void) {
+  for (int i = 0; i < N_THREADS; i++) {
+    for (int j = 0; j < N_SAMPLES; j++) {
+      assert((samples[i][j].uuid[6] & 0xf0) == 0x70);
+      assert((samples[i][j].uuid[8] & 0xc0) == 0x80);
+    }
+  }
+}
+
+void test_uniqueness(void) {
+  uint8_t(*uuids)[16] =
+      (uint8_t(*)[16])malloc(sizeof(uint8_t[16]) * N_THREADS * N_SAMPLES);
+  assert(uuids != NULL);
+  for (int i = 0; i < N_THREADS; i++) {
+    for (int j = 0; j < N_SAMPLES; j++) {
+      memcpy(uuids[i * N_SAMPLES + j], samples[i][j].uuid, 16);
+    }
+  }
+
+  qsort(uuids, N_THREADS * N_SAMPLES, 16, compare_uuids);
+  for (int i = 1; i < N_THREADS * N_SAMPLES; i++) {
+    assert(memcmp(uuids[i - 1], uuids[i], 16) < 0);
+  }
+  free(uuids);
+}
+
+void test_order_within_thread(void) {
+  for (int i = 0; i < N_THREADS; i++) {
+    for (int j = 1; j < N_SAMPLES; j++) {
+      assert(memcmp(samples[i][j - 1].uuid, samples[i][j].uuid, 16) < 0);
+    }
+  }
+}
+
+void test_order_across_threads(void) {
+  // a UUID must be greater than every UUID whose generation finished before
+  // its generation began, unless the implementation orders UUIDs per thread
+  // only (define ORDER_PER_THREAD to skip this check)
+  for (int i = 0; i < N_THREADS; i++) {
+    for (int j = 0; j < N_SAMPLES; j++) {
+      struct Sample *e = &samples[i][j];
+      assert(e->begin < N_TICKETS && e->end < N_TICKETS);
+      events[e->begin] = (uintptr_t)e;
+      events[e->end] = (uintptr_t)e | 1;
+    }
+  }
+
+  uint8_t max_finished[16] = {0};
+  for (int i = 0; i < N_TICKETS; i++) {
+    struct Sample *e = (struct Sample *)(events[i] & ~(uintptr_t)1);
+    if (events[i] & 1) {
+      if (memcmp(max_finished, e->uuid, 16) < 0) {
+        memcpy(max_finished, e->uuid, 16);
+      }
+    } else {
+      assert(memcmp(max_finished, e->uuid, 16) < 0);
+    }
+  }
+}
+
+void test_order_across_blocks(void) {
+  // where UUIDs are ordered per block only, each run of consecutive counter
+  // values in a thread is a block, or blocks leased back to back, and a block
+  // leased after another one was leased must follow all UUIDs of the latter
+  struct Block {
+    struct Sample *first;
+    struct Sample *last;
+  };
+  static struct Block blocks[N_THREADS * N_SAMPLES];
+  int n_blocks = 0;
+  memset(events, 0, sizeof(events));
+  for (int i = 0; i < N_THREADS; i++) {
+    struct Sample *s = samples[i];
+    for (int j = 0; j < N_SAMPLES; j++) {
+      if (j == 0 ||
+          uuidv7_get_timestamp(s[j].uuid) !=
+              uuidv7_get_timestamp(s[j - 1].uuid) ||
+          uuidv7_get_counter(s[j].uuid) !=
+              uuidv7_get_counter(s[j - 1].uuid) + 1) {
+        struct Block *b = &blocks[n_blocks++];
+        b->first = &s[j];
+        assert(s[j].begin < N_TICKETS && s[j].end < N_TICKETS);
+        events[s[j].begin] = (uintptr_t)b;
+        events[s[j].end] = (uintptr_t)b | 1;
+      }
+      blocks[n_blocks - 1].last = &s[j];
+    }
+  }
+  assert(n_blocks > N_THREADS);
+
+  uint8_t max_leased[16] = {0};
+  for (int i = 0; i < N_TICKETS; i++) {
+    struct Block *b = (struct Block *)(events[i] & ~(uintptr_t)1);
+    if (b == NULL) {
+      continue;
+    } else if (events[i] & 1) {
+      if (memcmp(max_leased, b->last->uuid, 16) < 0) {
+        memcpy(max_leased, b->last->uuid, 16);
+      }
+    } else {
+      assert(memcmp(max_leased, b->first->uuid, 16) < 0);
+    }
+  }
+}
+
+#ifndef NDEBUG
+int main(void) {
+  setup();
+
+  test_format();
+  fprintf(stderr, "  %s: ok\n", "test_format");
+  test_uniqueness();
+  fprintf(stderr, "  %s: ok\n", "test_uniqueness");
+  test_order_within_thread();
+  fprintf(stderr, "  %s: ok\n", "test_order_within_thread");
+#ifndef ORDER_PER_THREAD
+  test_order_across_threads();
+  fprintf(stderr, "  %s: ok\n", "test_order_across_threads");
+#else
+  test_order_across_blocks();
+  fprintf(stderr, "  %s: ok\n", "test_order_across_blocks");
+#endif
+
+  return 0;
+}
+#endif
@@ -0,0 +1,248 @@
+#include "uuidv7.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define N_PROCS 16
+#define N_SAMPLES 20000 // per process
+
+/** Memory shared between the test process and its children. */
+struct Shared {
+  uint8_t uuids[N_PROCS][N_SAMPLES][16];
+};
+static struct Shared *shared;
+
+void test_default(void) {
+  // node ID zero of zero bits must not change the output
+  uint8_t prev[16], expected[16], uuid[16], rand_bytes[10];
+  uuidv7_gen_t gen;
+  uuidv7_gen_init(&gen, NULL);
+  assert(uuidv7_gen_set_node(&gen, 0, 0) == 0);
+
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (int i = 0; i < 10000; i++) {
+    fill_rand(rand_bytes);
+    unix_ts_ms += next_rand() % 64 == 0;
+    int8_t status = uuidv7_generate(expected, unix_ts_ms, rand_bytes,
+                                    i > 0 ? prev : NULL);
+    uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+    assert(uuidv7_gen_next(&gen, unix_ts_ms, uuid) == status);
+    assert(memcmp(uuid, expected, 16) == 0);
+    memcpy(prev, expected, 16);
+  }
+}
+
+void test_set_node(void) {
+  uuidv7_gen_t gen;
+  uuidv7_gen_init(&gen, NULL);
+  assert(uuidv7_gen_set_node(&gen, 5, 3) == 0);
+  assert(uuidv7_gen_set_node(&gen, 8, 3) != 0);
+  assert(uuidv7_gen_set_node(&gen, 1, 0) != 0);
+  assert(uuidv7_gen_set_node(&gen, 0, -1) != 0);
+  assert(uuidv7_gen_set_node(&gen, 0, 42) != 0);
+  assert(gen.node_bits == 3 && gen.node_prefix == (uint64_t)5 << 39);
+
+  assert(uuidv7_gen_set_node(&gen, ((uint64_t)1 << 41) - 1, 41) == 0);
+  assert(gen.node_prefix == ((uint64_t)1 << 42) - 2);
+
+  // statically initialized generators have no node ID
+  uuidv7_gen_t zero = {0, 0, 0, NULL, 0, 0, 0};
+  assert(zero.node_bits == 0 && zero.node_prefix == 0);
+}
+
+void test_node_field(void) {
+  const uint64_t node_id = 0x2a5;
+  uint8_t prev[16], uuid[16], rand_bytes[10];
+  uuidv7_gen_t gen;
+  uuidv7_gen_init(&gen, NULL);
+  assert(uuidv7_gen_set_node(&gen, node_id, 10) == 0);
+
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (int i = 0; i < 10000; i++) {
+    fill_rand(rand_bytes);
+    unix_ts_ms += next_rand() % 64 == 0;
+    uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+    assert(uuidv7_gen_next(&gen, unix_ts_ms, uuid) >= 0);
+    assert(uuidv7_get_node(uuid, 10) == node_id);
+    assert(uuid[6] >> 4 == 7 && uuid[8] >> 6 == 2);
+    assert(i == 0 || memcmp(prev, uuid, 16) < 0);
+    memcpy(prev, uuid, 16);
+  }
+}
+
+void test_overflow(void) {
+  // with two local counter bits reset to 0b11, every second UUID within a
+  // millisecond overflows the counter
+  uint8_t rand_bytes[10], uuid[16];
+  memset(rand_bytes, 0xff, sizeof(rand_bytes));
+  uuidv7_gen_t gen;
+  uuidv7_gen_init(&gen, NULL);
+  assert(uuidv7_gen_set_node(&gen, 0x15, 40) == 0);
+
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+         UUIDV7_STATUS_UNPRECEDENTED);
+  assert(uuidv7_get_counter(uuid) == ((uint64_t)0x15 << 2 | 3));
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+         UUIDV7_STATUS_TIMESTAMP_INC);
+  assert(uuidv7_get_timestamp(uuid) == 0x17f22e279b1);
+  assert(uuidv7_get_counter(uuid) == ((uint64_t)0x15 << 2 | 3));
+
+  // zero local bits count up to the maximum before they overflow
+  memset(rand_bytes, 0, sizeof(rand_bytes));
+  uuidv7_gen_init(&gen, NULL);
+  assert(uuidv7_gen_set_node(&gen, 0x15, 40) == 0);
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+         UUIDV7_STATUS_UNPRECEDENTED);
+  for (uint64_t i = 1; i < 4; i++) {
+    uuidv7_gen_set_rand(&gen, rand_bytes, 4);
+    assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+           UUIDV7_STATUS_COUNTER_INC);
+    assert(uuidv7_get_counter(uuid) == ((uint64_t)0x15 << 2 | i));
+  }
+  uuidv7_gen_set_rand(&gen, rand_bytes, 4);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+         UUIDV7_STATUS_ERR_RAND_SHORTAGE);
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+         UUIDV7_STATUS_TIMESTAMP_INC);
+  assert(uuidv7_get_counter(uuid) == (uint64_t)0x15 << 2);
+}
+
+void test_switch_node(void) {
+  // a generator that takes over another node ID stays monotonic
+  uint8_t rand_bytes[10], prev[16], uuid[16];
+  memset(rand_bytes, 0xff, sizeof(rand_bytes));
+  uuidv7_gen_t gen;
+  uuidv7_gen_init(&gen, NULL);
+  assert(uuidv7_gen_set_node(&gen, 7, 3) == 0);
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, prev) >= 0);
+
+  memset(rand_bytes, 0, sizeof(rand_bytes));
+  assert(uuidv7_gen_set_node(&gen, 0, 3) == 0);
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b0, uuid) ==
+         UUIDV7_STATUS_TIMESTAMP_INC);
+  assert(uuidv7_get_node(uuid, 3) == 0);
+  assert(memcmp(prev, uuid, 16) < 0);
+
+  // resuming from a UUID of the same node keeps incrementing its counter
+  memcpy(prev, uuid, 16);
+  uuidv7_gen_init(&gen, prev);
+  assert(uuidv7_gen_set_node(&gen, 0, 3) == 0);
+  uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+  assert(uuidv7_gen_next(&gen, 0x17f22e279b1, uuid) ==
+         UUIDV7_STATUS_COUNTER_INC);
+  assert(uuidv7_get_counter(uuid) == uuidv7_get_counter(prev) + 1);
+}
+
+static uint64_t now_ms(void) {
+  struct timespec tp;
+  clock_gettime(CLOCK_REALTIME, &tp);
+  return (uint64_t)tp.tv_sec * 1000 + tp.tv_nsec / 1000000;
+}
+
+static int compare_uuids(const void *a, const void *b) {
+  return memcmp(a, b, 16);
+}
+
+/**
+ * Generates UUIDs in `N_PROCS` processes that share the same timestamps and
+ * random bytes but have distinct node IDs, so that they would all generate the
+ * same UUIDs without the node IDs.
+ */
+static void run_nodes(int node_bits, int use_clock) {
+  pid_t pids[N_PROCS];
+  for (int i = 0; i < N_PROCS; i++) {
+    pids[i] = fork();
+    assert(pids[i] >= 0);
+    if (pids[i] == 0) {
+      uint8_t rand_bytes[10];
+      uuidv7_gen_t gen;
+      uuidv7_gen_init(&gen, NULL);
+      if (uuidv7_gen_set_node(&gen, (uint64_t)i << (node_bits - 4),
+                              node_bits) != 0) {
+        _exit(1);
+      }
+      for (int j = 0; j < N_SAMPLES; j++) {
+        uint64_t unix_ts_ms = use_clock ? now_ms()
+                                        : 0x17f22e279b0 + (uint64_t)j / 256;
+        fill_rand(rand_bytes); // same in every child forked from this state
+        uuidv7_gen_set_rand(&gen, rand_bytes, 10);
+        if (uuidv7_gen_next(&gen, unix_ts_ms, shared->uuids[i][j]) < 0) {
+          _exit(1);
+        }
+      }
+      _exit(0);
+    }
+  }
+  for (int i = 0; i < N_PROCS; i++) {
+    int wstatus;
+    waitpid(pids[i], &wstatus, 0);
+    assert(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0);
+  }
+
+  // each node generates a monotonic sequence with its own node ID
+  for (int i = 0; i < N_PROCS; i++) {
+    for (int j = 0; j < N_SAMPLES; j++) {
+      const uint8_t *uuid = shared->uuids[i][j];
+      assert(uuidv7_get_node(uuid, node_bits) ==
+             (uint64_t)i << (node_bits - 4));
+      assert(j == 0 || memcmp(shared->uuids[i][j - 1], uuid, 16) < 0);
+    }
+  }
+
+  // and no two nodes generate the same UUID
+  uint8_t(*uuids)[16] = (uint8_t(*)[16])malloc(sizeof(shared->uuids));
+  assert(uuids != NULL);
+  memcpy(uuids, shared->uuids, sizeof(shared->uuids));
+  qsort(uuids, N_PROCS * N_SAMPLES, 16, compare_uuids);
+  for (int i = 1; i < N_PROCS * N_SAMPLES; i++) {
+    assert(memcmp(uuids[i - 1], uuids[i], 16) < 0);
+  }
+  free(uuids);
+}
+
+void test_multi_node(void) {
+  run_nodes(4, 0);
+  run_nodes(12, 0);
+  run_nodes(38, 0); // overflows the four local bits every few UUIDs
+  run_nodes(8, 1);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  shared = (struct Shared *)mmap(NULL, sizeof(struct Shared),
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  assert(shared != MAP_FAILED);
+
+  test_default();
+  fprintf(stderr, "  %s: ok\n", "test_default");
+  test_set_node();
+  fprintf(stderr, "  %s: ok\n", "test_set_node");
+  test_node_field();
+  fprintf(stderr, "  %s: ok\n", "test_node_field");
+  test_overflow();
+  fprintf(stderr, "  %s: ok\n", "test_overflow");
+  test_switch_node();
+  fprintf(stderr, "  %s: ok\n", "test_switch_node");
+  test_multi_node();
+  fprintf(stderr, "  %s: ok\n", "test_multi_node");
+
+  munmap(shared, sizeof(struct Shared));
+  return 0;
+}
+#endif
@@ -0,0 +1,239 @@
+#include "uuidv7.h"
+#include "uuidv7_partition.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_UUIDS 100000
+
+static uint8_t uuids[16 * N_UUIDS];
+static uint8_t expected[16 * N_UUIDS];
+static uint8_t actual[16 * N_UUIDS];
+
+/**
+ * Fills `uuids` with UUIDv7s whose timestamps are spread over `range_ms`
+ * milliseconds in no particular order and whose random tails hold their
+ * positions, so that the output reveals the input order.
+ */
+static void generate_input(uint64_t first_ms, uint64_t range_ms) {
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint8_t rand_bytes[10];
+    fill_rand(rand_bytes);
+    rand_bytes[6] = (uint8_t)(i >> 24);
+    rand_bytes[7] = (uint8_t)(i >> 16);
+    rand_bytes[8] = (uint8_t)(i >> 8);
+    rand_bytes[9] = (uint8_t)i;
+    uuidv7_generate(&uuids[16 * i], first_ms + next_rand() % range_ms,
+                    rand_bytes, NULL);
+  }
+}
+
+struct Key {
+  size_t bucket;
+  size_t index;
+};
+
+static struct Key keys[N_UUIDS];
+
+static int compare_keys(const void *a, const void *b) {
+  const struct Key *x = (const struct Key *)a, *y = (const struct Key *)b;
+  if (x->bucket != y->bucket) {
+    return x->bucket < y->bucket ? -1 : 1;
+  }
+  return x->index < y->index ? -1 : x->index > y->index;
+}
+
+/**
+ * Partitions `uuids` into `expected` by sorting them by bucket and position,
+ * and checks the bucket boundaries.
+ */
+static void partition_reference(const uuidv7_partition_t *p,
+                                const size_t *bucket_starts) {
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint64_t ts = uuidv7_get_timestamp(&uuids[16 * i]);
+    keys[i].bucket = ts >= p->base_ms && ts - p->base_ms < p->span_ms
+                         ? (size_t)((ts - p->base_ms) / p->width_ms)
+                         : p->n_buckets;
+    keys[i].index = i;
+  }
+  qsort(keys, N_UUIDS, sizeof(struct Key), compare_keys);
+
+  size_t b = 0;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    while (b <= keys[i].bucket) {
+      assert(bucket_starts[b++] == i);
+    }
+    memcpy(&expected[16 * i], &uuids[16 * keys[i].index], 16);
+  }
+  while (b <= p->n_buckets + 1) {
+    assert(bucket_starts[b++] == N_UUIDS);
+  }
+}
+
+void test_bucket(void) {
+  const uint64_t widths[] = {1, 3, 1000, 60000, 3600000, 86400000, 604800000,
+                             0x123456789};
+  for (size_t k = 0; k < sizeof(widths) / sizeof(widths[0]); k++) {
+    uint64_t width = widths[k];
+    size_t n_buckets = (size_t)((((uint64_t)1 << 48) - 1) / width);
+    uuidv7_partition_t p;
+    assert(uuidv7_partition_init(&p, 0, width, n_buckets) == 0);
+    for (int i = 0; i < 100000; i++) {
+      // hit the bucket boundaries as often as the values between them
+      uint64_t ts = next_rand() % p.span_ms;
+      if (i % 2 == 0) {
+        ts = ts - ts % width + (i % 4 == 0 ? 0 : width - 1);
+      }
+      uint8_t uuid[16] = {0};
+      for (int j = 0; j < 6; j++) {
+        uuid[j] = (uint8_t)(ts >> (40 - 8 * j));
+      }
+      assert(uuidv7_partition_bucket(&p, uuid) == ts / width);
+    }
+  }
+
+  // out-of-range timestamps fall into the extra bucket
+  uuidv7_partition_t p;
+  assert(uuidv7_partition_init(&p, 1000, 10, 5) == 0);
+  uint8_t uuid[16] = {0};
+  const uint64_t cases[][2] = {{0, 5},    {999, 5},  {1000, 0}, {1009, 0},
+                               {1010, 1}, {1049, 4}, {1050, 5},
+                               {((uint64_t)1 << 48) - 1, 5}};
+  for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+    for (int j = 0; j < 6; j++) {
+      uuid[j] = (uint8_t)(cases[k][0] >> (40 - 8 * j));
+    }
+    assert(uuidv7_partition_bucket(&p, uuid) == cases[k][1]);
+  }
+}
+
+void test_init(void) {
+  uuidv7_partition_t p;
+  assert(uuidv7_partition_init(&p, 0, 0, 1) != 0);
+  assert(uuidv7_partition_init(&p, 0, 1, 0) != 0);
+  assert(uuidv7_partition_init(&p, 0, (uint64_t)1 << 48, 1) == 0);
+  assert(uuidv7_partition_init(&p, 0, (uint64_t)1 << 48, 2) != 0);
+  assert(uuidv7_partition_init(&p, 1, (uint64_t)1 << 47, 2) != 0);
+  assert(uuidv7_partition_init(&p, 0, (uint64_t)1 << 49, 1) != 0);
+  assert(uuidv7_partition_init(&p, 0, 1, (size_t)1 << 48) == 0);
+  assert(uuidv7_partition_init(&p, 1, 1, (size_t)1 << 48) != 0);
+
+  // the covering layout aligns the buckets to the epoch
+  generate_input(0x17f22e279b0, 3 * 86400000);
+  assert(uuidv7_partition_init_range(&p, uuids, N_UUIDS, 0) != 0);
+  assert(uuidv7_partition_init_range(&p, uuids, N_UUIDS, 3600000) == 0);
+  assert(p.base_ms % 3600000 == 0 && p.base_ms <= 0x17f22e279b0 &&
+         p.base_ms + 3600000 > 0x17f22e279b0);
+  assert(p.n_buckets == 72 || p.n_buckets == 73);
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    assert(uuidv7_partition_bucket(&p, &uuids[16 * i]) < p.n_buckets);
+  }
+
+  assert(uuidv7_partition_init_range(&p, uuids, 0, 86400000) == 0);
+  assert(p.base_ms == 0 && p.n_buckets == 1);
+}
+
+void test_partition(void) {
+  size_t bucket_starts[1000];
+  uuidv7_partition_t p;
+
+  // covering layouts of various widths, and narrower ones with outliers
+  generate_input(0x17f22e279b0, 3 * 86400000);
+  const uint64_t widths[] = {86400000, 3600000, 600000, 1};
+  for (size_t k = 0; k < sizeof(widths) / sizeof(widths[0]); k++) {
+    if (widths[k] == 1) {
+      assert(uuidv7_partition_init(&p, 0x17f22e279b0 + 1000, 1, 500) == 0);
+    } else {
+      assert(uuidv7_partition_init_range(&p, uuids, N_UUIDS, widths[k]) == 0);
+    }
+    assert(p.n_buckets + 2 <= sizeof(bucket_starts) / sizeof(size_t));
+    uuidv7_partition(&p, uuids, N_UUIDS, bucket_starts, actual);
+    partition_reference(&p, bucket_starts);
+    assert(memcmp(actual, expected, sizeof(actual)) == 0);
+  }
+
+  assert(uuidv7_partition_init(&p, 0x17f22e279b0 + 86400000, 3600000, 24) ==
+         0);
+  uuidv7_partition(&p, uuids, N_UUIDS, bucket_starts, actual);
+  partition_reference(&p, bucket_starts);
+  assert(memcmp(actual, expected, sizeof(actual)) == 0);
+  size_t n_outliers = bucket_starts[25] - bucket_starts[24];
+  assert(n_outliers > N_UUIDS / 2 && n_outliers < N_UUIDS * 3 / 4);
+
+  // empty input
+  uuidv7_partition(&p, uuids, 0, bucket_starts, actual);
+  for (size_t b = 0; b < 26; b++) {
+    assert(bucket_starts[b] == 0);
+  }
+}
+
+void test_chunks(void) {
+  // uneven chunks counted and scattered one by one, in reverse order
+  static size_t counts[7 * 26];
+  size_t bucket_starts[27], sizes[7] = {0, 1, 12345, 20000, 0, 33333};
+  sizes[6] = N_UUIDS - (1 + 12345 + 20000 + 33333);
+  uuidv7_partition_t p;
+  generate_input(0x17f22e279b0, 86400000);
+  assert(uuidv7_partition_init_range(&p, uuids, N_UUIDS, 3600000) == 0);
+  assert(p.n_buckets <= 25);
+
+  memset(counts, 0, sizeof(counts));
+  for (size_t c = 0, begin = 0; c < 7; begin += sizes[c++]) {
+    uuidv7_partition_count(&p, &uuids[16 * begin], sizes[c],
+                           &counts[c * (p.n_buckets + 1)]);
+  }
+  uuidv7_partition_offsets(&p, counts, 7, bucket_starts);
+  for (size_t c = 7, end = N_UUIDS; c-- > 0; end -= sizes[c]) {
+    uuidv7_partition_scatter(&p, &uuids[16 * (end - sizes[c])], sizes[c],
+                             &counts[c * (p.n_buckets + 1)], actual);
+  }
+  partition_reference(&p, bucket_starts);
+  assert(memcmp(actual, expected, sizeof(actual)) == 0);
+}
+
+void test_parallel(void) {
+#ifdef UUIDV7_PARTITION_PTHREAD
+  static size_t counts[UUIDV7_PARTITION_MAX_THREADS * 74];
+  size_t bucket_starts[75];
+  uuidv7_partition_t p;
+  generate_input(0x17f22e279b0, 3 * 86400000);
+  assert(uuidv7_partition_init_range(&p, uuids, N_UUIDS, 3600000) == 0);
+  assert(p.n_buckets <= 73);
+
+  const size_t n_threads[] = {0, 1, 2, 3, 8, 64, 100};
+  const size_t n_uuids[] = {N_UUIDS, 5, 0};
+  for (size_t k = 0; k < sizeof(n_threads) / sizeof(n_threads[0]); k++) {
+    for (size_t m = 0; m < sizeof(n_uuids) / sizeof(n_uuids[0]); m++) {
+      size_t expected_starts[75];
+      uuidv7_partition(&p, uuids, n_uuids[m], expected_starts, expected);
+      memset(actual, 0, sizeof(actual));
+      uuidv7_partition_parallel(&p, uuids, n_uuids[m], n_threads[k], counts,
+                                bucket_starts, actual);
+      assert(memcmp(bucket_starts, expected_starts,
+                    sizeof(size_t) * (p.n_buckets + 2)) == 0);
+      assert(memcmp(actual, expected, 16 * n_uuids[m]) == 0);
+    }
+  }
+#endif
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_bucket();
+  fprintf(stderr, "  %s: ok\n", "test_bucket");
+  test_init();
+  fprintf(stderr, "  %s: ok\n", "test_init");
+  test_partition();
+  fprintf(stderr, "  %s: ok\n", "test_partition");
+  test_chunks();
+  fprintf(stderr, "  %s: ok\n", "test_chunks");
+  test_parallel();
+  fprintf(stderr, "  %s: ok\n", "test_parallel");
+
+  return 0;
+}
+#endif
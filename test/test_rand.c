@@ -0,0 +1,103 @@
+#define UUIDV7_RAND_BUFFER_SIZE 1000
+#define UUIDV7_RAND_RESEED_INTERVAL 5000
+#include "uuidv7_rand.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/wait.h>
+
+void test_chacha20_block(void) {
+  // RFC 8439, Section 2.3.2
+  const uint32_t input[16] = {
+      0x61707865, 0x3320646e, 0x79622d32, 0x6b206574, 0x03020100, 0x07060504,
+      0x0b0a0908, 0x0f0e0d0c, 0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c,
+      0x00000001, 0x09000000, 0x4a000000, 0x00000000};
+  const uint8_t expected[64] = {
+      0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd,
+      0x1f, 0xa3, 0x20, 0x71, 0xc4, 0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0,
+      0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e, 0xd2,
+      0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05,
+      0xd9, 0x8b, 0x02, 0xa2, 0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e,
+      0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e};
+
+  uint8_t block[64];
+  uuidv7_chacha20_block(input, block);
+  assert(memcmp(block, expected, 64) == 0);
+}
+
+void test_no_waste(void) {
+  // bytes peeked but not consumed must be returned again, even across
+  // refills and reseeds
+  uuidv7_rand_t rng;
+  assert(uuidv7_rand_init(&rng) == 0);
+  for (int i = 0; i < 10000; i++) {
+    uint8_t peeked[10];
+    memcpy(peeked, uuidv7_rand_peek(&rng, 10), 10);
+    size_t n = (i % 3 == 0) ? 10 : 4;
+    uuidv7_rand_consume(&rng, n);
+    assert(memcmp(uuidv7_rand_peek(&rng, 10 - n), &peeked[n], 10 - n) == 0);
+  }
+}
+
+void test_random_bits(void) {
+  // count '1' of each bit position of bytes over many refills
+  uuidv7_rand_t rng;
+  assert(uuidv7_rand_init(&rng) == 0);
+  uint32_t bins[8] = {0};
+  const int n_samples = 200000;
+  for (int i = 0; i < n_samples; i++) {
+    uint8_t byte = *uuidv7_rand_peek(&rng, 1);
+    uuidv7_rand_consume(&rng, 1);
+    for (int j = 0; j < 8; j++) {
+      bins[j] += (byte >> j) & 1;
+    }
+  }
+  for (int j = 0; j < 8; j++) {
+    assert(bins[j] > n_samples * 0.49 && bins[j] < n_samples * 0.51);
+  }
+}
+
+void test_fork(void) {
+  // child must not reproduce the bytes the parent produces after fork
+  uuidv7_rand_t rng;
+  assert(uuidv7_rand_init(&rng) == 0);
+  uuidv7_rand_peek(&rng, 16);
+
+  int fds[2];
+  assert(pipe(fds) == 0);
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    const uint8_t *bytes = uuidv7_rand_peek(&rng, 16);
+    ssize_t n = write(fds[1], bytes, 16);
+    _exit(n == 16 ? 0 : 1);
+  }
+
+  uint8_t parent[16], child[16];
+  memcpy(parent, uuidv7_rand_peek(&rng, 16), 16);
+  assert(read(fds[0], child, 16) == 16);
+  int wstatus;
+  waitpid(pid, &wstatus, 0);
+  assert(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0);
+  assert(memcmp(parent, child, 16) != 0);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_chacha20_block();
+  fprintf(stderr, "  %s: ok\n", "test_chacha20_block");
+  test_no_waste();
+  fprintf(stderr, "  %s: ok\n", "test_no_waste");
+  test_random_bits();
+  fprintf(stderr, "  %s: ok\n", "test_random_bits");
+  test_fork();
+  fprintf(stderr, "  %s: ok\n", "test_fork");
+
+  return 0;
+}
+#endif
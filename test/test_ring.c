@@ -0,0 +1,159 @@
+#include "uuidv7.h"
+#include "uuidv7_new_ring.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// must be defined for the implementation as well
+#ifndef UUIDV7_RING_SIZE
+#error "define UUIDV7_RING_SIZE for both uuidv7_new_ring.c and this file"
+#endif
+#ifndef UUIDV7_RING_MAX_AGE_MS
+#error "define UUIDV7_RING_MAX_AGE_MS for both uuidv7_new_ring.c and this file"
+#endif
+
+static void sleep_ms(long ms) {
+  struct timespec tp;
+  tp.tv_sec = 0;
+  tp.tv_nsec = ms * 1000000;
+  nanosleep(&tp, NULL);
+}
+
+void test_refill(void) {
+  // a consumer slower than the producer should never find the ring empty
+  uint8_t prev[16], uuid[16];
+  assert(uuidv7_new(prev) >= 0);
+  sleep_ms(20);
+
+  uuidv7_ring_stats_t before, after;
+  uuidv7_ring_get_stats(&before);
+  for (int i = 0; i < 1000; i++) {
+    assert(uuidv7_new(uuid) >= 0);
+    assert(memcmp(prev, uuid, 16) < 0);
+    memcpy(prev, uuid, 16);
+    if (i % 16 == 15) {
+      sleep_ms(1);
+    }
+  }
+  uuidv7_ring_get_stats(&after);
+  assert(after.n_popped - before.n_popped + after.n_empty - before.n_empty ==
+         1000);
+  assert(after.n_empty - before.n_empty < 50);
+}
+
+static uint64_t now_ms(void) {
+  struct timespec tp;
+  clock_gettime(CLOCK_REALTIME, &tp);
+  return (uint64_t)tp.tv_sec * 1000 + (uint64_t)tp.tv_nsec / 1000000;
+}
+
+void test_expiry(void) {
+  // UUIDs pre-generated before an idle period must not be handed out after it
+  uint8_t prev[16], uuid[16];
+  assert(uuidv7_new(prev) >= 0);
+  sleep_ms(20);
+
+  uuidv7_ring_stats_t before, after;
+  uuidv7_ring_get_stats(&before);
+  sleep_ms(UUIDV7_RING_MAX_AGE_MS * 4);
+  for (int i = 0; i < UUIDV7_RING_SIZE * 2; i++) {
+    uint64_t t0 = now_ms();
+    assert(uuidv7_new(uuid) >= 0);
+    assert(uuidv7_get_timestamp(uuid) + UUIDV7_RING_MAX_AGE_MS >= t0);
+    assert(uuidv7_get_timestamp(uuid) <= now_ms());
+    assert(memcmp(prev, uuid, 16) < 0);
+    memcpy(prev, uuid, 16);
+  }
+  uuidv7_ring_get_stats(&after);
+  assert(after.n_expired - before.n_expired >= UUIDV7_RING_SIZE);
+  assert(after.n_popped - before.n_popped + after.n_empty - before.n_empty ==
+         UUIDV7_RING_SIZE * 2);
+}
+
+void test_string(void) {
+  uint8_t prev[16], uuid[16];
+  assert(uuidv7_new(prev) >= 0);
+  for (int i = 0; i < 10000; i++) {
+    char text[37];
+    memset(text, 'x', sizeof(text));
+    assert(uuidv7_ring_new_string(text) >= 0);
+    assert(strlen(text) == 36);
+    assert(uuidv7_from_string(text, uuid) == 0);
+    assert(memcmp(prev, uuid, 16) < 0);
+    memcpy(prev, uuid, 16);
+  }
+}
+
+void test_fork(void) {
+  // a child must not hand out the UUIDs pre-generated for its parent
+  uint8_t *shared = (uint8_t *)mmap(NULL, 16 * 16, PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  assert(shared != MAP_FAILED);
+  uint8_t uuid[16];
+  assert(uuidv7_new(uuid) >= 0);
+  sleep_ms(20);
+
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    for (int i = 0; i < 16; i++) {
+      if (uuidv7_new(&shared[16 * i]) < 0) {
+        _exit(1);
+      }
+    }
+    _exit(0);
+  }
+
+  int wstatus;
+  waitpid(pid, &wstatus, 0);
+  assert(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0);
+  for (int i = 0; i < 16; i++) {
+    assert(uuidv7_new(uuid) >= 0);
+    for (int j = 0; j < 16; j++) {
+      assert(memcmp(uuid, &shared[16 * j], 16) != 0);
+    }
+  }
+  munmap(shared, 16 * 16);
+}
+
+void test_shutdown(void) {
+  uint8_t prev[16], uuid[16];
+  assert(uuidv7_new(prev) >= 0);
+  uuidv7_ring_shutdown();
+  uuidv7_ring_shutdown(); // no-op
+
+  // the remaining UUIDs and then directly generated ones follow in order
+  uuidv7_ring_stats_t before, after;
+  uuidv7_ring_get_stats(&before);
+  for (int i = 0; i < 1000; i++) {
+    assert(uuidv7_new(uuid) >= 0);
+    assert(memcmp(prev, uuid, 16) < 0);
+    memcpy(prev, uuid, 16);
+  }
+  uuidv7_ring_get_stats(&after);
+  assert(after.n_popped - before.n_popped <= UUIDV7_RING_SIZE);
+  assert(after.n_empty - before.n_empty >= 1000 - UUIDV7_RING_SIZE);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_refill();
+  fprintf(stderr, "  %s: ok\n", "test_refill");
+  test_expiry();
+  fprintf(stderr, "  %s: ok\n", "test_expiry");
+  test_string();
+  fprintf(stderr, "  %s: ok\n", "test_string");
+  test_fork();
+  fprintf(stderr, "  %s: ok\n", "test_fork");
+  test_shutdown();
+  fprintf(stderr, "  %s: ok\n", "test_shutdown");
+
+  return 0;
+}
+#endif
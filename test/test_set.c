@@ -0,0 +1,265 @@
+#include "uuidv7.h"
+#include "uuidv7_set.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_UUIDS 100000
+
+static uint8_t uuids[16 * N_UUIDS];
+static uint8_t stream[16 * 4 * N_UUIDS];
+static size_t picks[4 * N_UUIDS];
+
+/**
+ * Fills `stream` with `n` UUIDs picked from the first `n_distinct` of `uuids`,
+ * so that about `n - n_distinct` of them are duplicates.
+ */
+static void pick_stream(size_t n, size_t n_distinct) {
+  for (size_t i = 0; i < n; i++) {
+    picks[i] = (size_t)(next_rand() % n_distinct);
+    memcpy(&stream[16 * i], &uuids[16 * picks[i]], 16);
+  }
+}
+
+static uuidv7_set_t *new_set(size_t capacity, int with_values) {
+  uuidv7_set_t *set = (uuidv7_set_t *)malloc(sizeof(uuidv7_set_t));
+  size_t n_slots = uuidv7_set_n_slots(capacity);
+  void *memory = malloc(uuidv7_set_memory_size(n_slots, with_values));
+  uuidv7_set_init(set, n_slots, memory, with_values);
+  assert(uuidv7_set_capacity(set) >= capacity);
+  return set;
+}
+
+static void delete_set(uuidv7_set_t *set) {
+  free(set->ctrl);
+  free(set);
+}
+
+void test_insert_find(void) {
+  generate_sequence(uuids, N_UUIDS, 0x17f22e279b0, 1, 16);
+  pick_stream(2 * N_UUIDS, N_UUIDS / 2);
+  uuidv7_set_t *set = new_set(N_UUIDS / 2, 1);
+  uint8_t *seen = (uint8_t *)calloc(N_UUIDS, 1);
+
+  size_t n_distinct = 0;
+  for (size_t i = 0; i < 2 * N_UUIDS; i++) {
+    size_t slot = 0;
+    int status = uuidv7_set_insert(set, &stream[16 * i], &slot);
+    assert(status == !seen[picks[i]]);
+    assert(memcmp(&set->keys[16 * slot], &stream[16 * i], 16) == 0);
+    if (status == 1) {
+      set->values[slot] = picks[i];
+      seen[picks[i]] = 1;
+      n_distinct++;
+    }
+    assert(set->values[slot] == picks[i]);
+  }
+  assert(set->size == n_distinct);
+
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    size_t slot = uuidv7_set_find(set, &uuids[16 * i]);
+    if (seen[i]) {
+      assert(slot != UUIDV7_SET_NOT_FOUND);
+      assert(set->values[slot] == i);
+    } else {
+      assert(slot == UUIDV7_SET_NOT_FOUND);
+    }
+  }
+
+  // UUIDs that differ from stored ones in a single bit are not found
+  for (size_t i = 0; i < 10000; i++) {
+    uint8_t key[16];
+    memcpy(key, &uuids[16 * i], 16);
+    key[next_rand() % 16] ^= (uint8_t)(1 << next_rand() % 8);
+    assert(uuidv7_set_find(set, key) == UUIDV7_SET_NOT_FOUND ||
+           memcmp(key, &uuids[16 * (i + 1)], 16) == 0 ||
+           (i > 0 && memcmp(key, &uuids[16 * (i - 1)], 16) == 0));
+  }
+
+  uuidv7_set_clear(set);
+  assert(set->size == 0);
+  assert(uuidv7_set_find(set, uuids) == UUIDV7_SET_NOT_FOUND);
+  free(seen);
+  delete_set(set);
+}
+
+void test_full(void) {
+  generate_sequence(uuids, N_UUIDS, 0x17f22e279b0, 1, 16);
+  uuidv7_set_t *set = new_set(1000, 0);
+  size_t capacity = uuidv7_set_capacity(set);
+  assert(set->values == NULL);
+  for (size_t i = 0; i < capacity; i++) {
+    assert(uuidv7_set_insert(set, &uuids[16 * i], NULL) == 1);
+  }
+  size_t slot = 0;
+  assert(uuidv7_set_insert(set, &uuids[16 * capacity], &slot) == -1);
+  assert(slot == UUIDV7_SET_NOT_FOUND);
+  assert(uuidv7_set_insert(set, uuids, &slot) == 0);
+  assert(slot != UUIDV7_SET_NOT_FOUND);
+  assert(uuidv7_set_find(set, &uuids[16 * capacity]) == UUIDV7_SET_NOT_FOUND);
+  for (size_t i = 0; i < capacity; i++) {
+    assert(uuidv7_set_find(set, &uuids[16 * i]) != UUIDV7_SET_NOT_FOUND);
+  }
+
+  // bulk insert stops inserting at the capacity
+  uuidv7_set_clear(set);
+  int8_t *status = (int8_t *)malloc(capacity + 10);
+  assert(uuidv7_set_insert_bulk(set, uuids, capacity + 10, status, NULL) ==
+         capacity);
+  for (size_t i = 0; i < capacity + 10; i++) {
+    assert(status[i] == (i < capacity ? 1 : -1));
+  }
+  free(status);
+  delete_set(set);
+}
+
+void test_bulk(void) {
+  generate_sequence(uuids, N_UUIDS, 0x17f22e279b0, 1, 16);
+  pick_stream(4 * N_UUIDS, N_UUIDS);
+  uuidv7_set_t *single = new_set(N_UUIDS, 0);
+  uuidv7_set_t *bulk = new_set(N_UUIDS, 0);
+  int8_t *status = (int8_t *)malloc(4 * N_UUIDS);
+  size_t *slots = (size_t *)malloc(sizeof(size_t) * 4 * N_UUIDS);
+
+  // the bulk functions match the single ones, in chunks of various sizes
+  size_t n_inserted = 0;
+  for (size_t i = 0; i < 4 * N_UUIDS;) {
+    size_t n = 1 + next_rand() % 1000;
+    n = n < 4 * N_UUIDS - i ? n : 4 * N_UUIDS - i;
+    n_inserted += uuidv7_set_insert_bulk(bulk, &stream[16 * i], n, &status[i],
+                                         &slots[i]);
+    i += n;
+  }
+  size_t n_expected = 0;
+  for (size_t i = 0; i < 4 * N_UUIDS; i++) {
+    size_t slot = 0;
+    int s = uuidv7_set_insert(single, &stream[16 * i], &slot);
+    assert(s == status[i]);
+    assert(slot == slots[i]);
+    n_expected += s == 1;
+  }
+  assert(n_inserted == n_expected);
+  assert(bulk->size == single->size);
+  assert(memcmp(bulk->ctrl, single->ctrl, bulk->n_slots) == 0);
+
+  assert(uuidv7_set_find_bulk(bulk, uuids, N_UUIDS, slots) == bulk->size);
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    assert(slots[i] == uuidv7_set_find(single, &uuids[16 * i]));
+  }
+  assert(uuidv7_set_find_bulk(bulk, uuids, N_UUIDS, NULL) == bulk->size);
+
+  free(slots);
+  free(status);
+  delete_set(bulk);
+  delete_set(single);
+}
+
+/** Keeps a sliding window of UUIDs and checks it after each eviction. */
+static void check_window(size_t capacity, uint64_t window_ms) {
+  uuidv7_set_t *set = new_set(capacity, 1);
+  uint64_t first_ts = uuidv7_get_timestamp(uuids);
+  uint64_t cutoff = first_ts;
+  size_t begin = 0; // first UUID in the window
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint64_t unix_ts_ms = uuidv7_get_timestamp(&uuids[16 * i]);
+    if (unix_ts_ms >= cutoff + window_ms + 1) {
+      // slide the window once per millisecond
+      cutoff = unix_ts_ms - window_ms;
+      size_t new_begin = begin;
+      while (uuidv7_get_timestamp(&uuids[16 * new_begin]) < cutoff) {
+        new_begin++;
+      }
+      assert(uuidv7_set_evict_before(set, cutoff) == new_begin - begin);
+      begin = new_begin;
+      assert(set->size == i - begin);
+
+      for (size_t j = begin; j < i; j += 1 + next_rand() % 16) {
+        size_t slot = uuidv7_set_find(set, &uuids[16 * j]);
+        assert(slot != UUIDV7_SET_NOT_FOUND);
+        assert(set->values[slot] == j);
+      }
+      for (size_t j = begin > 100 ? begin - 100 : 0; j < begin; j++) {
+        assert(uuidv7_set_find(set, &uuids[16 * j]) == UUIDV7_SET_NOT_FOUND);
+      }
+    }
+
+    size_t slot = 0;
+    if (uuidv7_set_insert(set, &uuids[16 * i], &slot) == -1) {
+      // window wider than the capacity: evict the oldest millisecond
+      uint64_t oldest = uuidv7_get_timestamp(&uuids[16 * begin]);
+      uuidv7_set_evict_before(set, oldest + 1);
+      while (begin < i &&
+             uuidv7_get_timestamp(&uuids[16 * begin]) <= oldest) {
+        begin++;
+      }
+      assert(uuidv7_set_insert(set, &uuids[16 * i], &slot) == 1);
+    }
+    set->values[slot] = i;
+  }
+  delete_set(set);
+}
+
+void test_evict(void) {
+  generate_sequence(uuids, N_UUIDS, 0x17f22e279b0, 1, 16);
+  check_window(16, 1);
+  check_window(100, 4);
+  check_window(3000, 64);
+  check_window(1000, 128);
+
+  // eviction of everything and of nothing
+  uuidv7_set_t *set = new_set(N_UUIDS, 0);
+  uuidv7_set_insert_bulk(set, uuids, N_UUIDS, NULL, NULL);
+  assert(uuidv7_set_evict_before(set, 0) == 0);
+  assert(set->size == N_UUIDS);
+  assert(uuidv7_set_find_bulk(set, uuids, N_UUIDS, NULL) == N_UUIDS);
+  assert(uuidv7_set_evict_before(set, UINT64_MAX) == N_UUIDS);
+  assert(set->size == 0);
+  assert(uuidv7_set_find_bulk(set, uuids, N_UUIDS, NULL) == 0);
+  delete_set(set);
+}
+
+void test_collisions(void) {
+  // UUIDs whose halves XOR to the same value share a hash and thus a probe
+  // sequence, which must still tell them apart
+  uuidv7_set_t *set = new_set(2000, 0);
+  uint8_t key[16];
+  for (uint64_t i = 0; i < 1000; i++) {
+    uuidv7_store_be64(0x017f22e279b07000 + i, key);
+    uuidv7_store_be64(0x8000000000000000 ^ (0x017f22e279b07000 + i), &key[8]);
+    assert(uuidv7_set_insert(set, key, NULL) == 1);
+  }
+  for (uint64_t i = 0; i < 1000; i++) {
+    uuidv7_store_be64(0x017f22e279b07000 + i, key);
+    uuidv7_store_be64(0x8000000000000000 ^ (0x017f22e279b07000 + i), &key[8]);
+    assert(uuidv7_set_insert(set, key, NULL) == 0);
+  }
+  for (uint64_t i = 1000; i < 2000; i++) {
+    uuidv7_store_be64(0x017f22e279b07000 + i, key);
+    uuidv7_store_be64(0x8000000000000000 ^ (0x017f22e279b07000 + i), &key[8]);
+    assert(uuidv7_set_find(set, key) == UUIDV7_SET_NOT_FOUND);
+  }
+  assert(uuidv7_set_evict_before(set, 0x17f22e279b0) == 0);
+  assert(set->size == 1000);
+  delete_set(set);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_insert_find();
+  fprintf(stderr, "  %s: ok\n", "test_insert_find");
+  test_full();
+  fprintf(stderr, "  %s: ok\n", "test_full");
+  test_bulk();
+  fprintf(stderr, "  %s: ok\n", "test_bulk");
+  test_evict();
+  fprintf(stderr, "  %s: ok\n", "test_evict");
+  test_collisions();
+  fprintf(stderr, "  %s: ok\n", "test_collisions");
+
+  return 0;
+}
+#endif
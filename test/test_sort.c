@@ -0,0 +1,159 @@
+#include "uuidv7.h"
+#include "uuidv7_sort.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_MAX 100000
+
+static uint8_t uuids[16 * N_MAX];
+static uint8_t expected[16 * N_MAX];
+static uint8_t scratch[16 * N_MAX];
+
+static int compare(const void *a, const void *b) { return memcmp(a, b, 16); }
+
+static void shuffle(uint8_t *a, size_t n) {
+  for (size_t i = n; i > 1; i--) {
+    size_t j = next_rand() % i;
+    uint8_t tmp[16];
+    memcpy(tmp, &a[16 * (i - 1)], 16);
+    memcpy(&a[16 * (i - 1)], &a[16 * j], 16);
+    memcpy(&a[16 * j], tmp, 16);
+  }
+}
+
+/** Sorts `uuids` with each function and compares the result with qsort. */
+static void check_sorts(size_t n) {
+  memcpy(expected, uuids, 16 * n);
+  qsort(expected, n, 16, compare);
+
+  uint8_t *copy = (uint8_t *)malloc(16 * n + 1);
+  memcpy(copy, uuids, 16 * n);
+  uuidv7_sort_radix(uuids, n, scratch);
+  assert(memcmp(uuids, expected, 16 * n) == 0);
+
+  memcpy(uuids, copy, 16 * n);
+  uuidv7_sort(uuids, n, scratch);
+  assert(memcmp(uuids, expected, 16 * n) == 0);
+  free(copy);
+}
+
+void test_sort_shuffled(void) {
+  static const size_t SIZES[] = {0, 1, 2, 3, 31, 32, 33, 100, 1000, N_MAX};
+  for (size_t k = 0; k < sizeof(SIZES) / sizeof(SIZES[0]); k++) {
+    generate_sequence(uuids, SIZES[k], 0x17f22e279b0, 3, 1);
+    shuffle(uuids, SIZES[k]);
+    check_sorts(SIZES[k]);
+  }
+}
+
+void test_sort_edge_cases(void) {
+  // fully random bytes without common prefixes
+  for (size_t i = 0; i < 16 * N_MAX; i++) {
+    uuids[i] = (uint8_t)next_rand();
+  }
+  check_sorts(N_MAX);
+
+  // duplicates, including runs of equal UUIDs longer than the cutoff
+  for (size_t i = 0; i < N_MAX; i++) {
+    memset(&uuids[16 * i], 0, 16);
+    uuids[16 * i + 15] = (uint8_t)(next_rand() % 3);
+    uuids[16 * i + 3] = (uint8_t)(next_rand() % 2);
+  }
+  check_sorts(N_MAX);
+
+  // descending input, where every UUID starts a run
+  generate_sequence(expected, N_MAX, 0x17f22e279b0, 1, 1);
+  for (size_t i = 0; i < N_MAX; i++) {
+    memcpy(&uuids[16 * i], &expected[16 * (N_MAX - 1 - i)], 16);
+  }
+  check_sorts(N_MAX);
+}
+
+void test_sort_runs(void) {
+  // already sorted input and concatenated outputs of up to 20 generators,
+  // which exercise both the merge path and the fallback to radix sort
+  for (size_t n_gens = 1; n_gens <= 20; n_gens++) {
+    size_t n_per_gen = N_MAX / n_gens;
+    for (size_t g = 0; g < n_gens; g++) {
+      generate_sequence(&uuids[16 * g * n_per_gen], n_per_gen,
+                        0x17f22e279b0 + g, 2, 1);
+    }
+    check_sorts(n_gens * n_per_gen);
+  }
+}
+
+void test_merger(void) {
+  enum { N_RUNS = 7, N_PER_RUN = 5000, CHUNK = 97 };
+  static uint8_t merged[16 * N_RUNS * N_PER_RUN];
+
+  // runs of different lengths, including an empty one
+  size_t lengths[N_RUNS];
+  size_t total = 0;
+  for (int r = 0; r < N_RUNS; r++) {
+    lengths[r] = r == 3 ? 0 : N_PER_RUN - (size_t)r * 300;
+    generate_sequence(&uuids[16 * total], lengths[r], 0x17f22e279b0, 2, 1);
+    total += lengths[r];
+  }
+  memcpy(expected, uuids, 16 * total);
+  qsort(expected, total, 16, compare);
+
+  // supply each run in chunks, starting with an empty chunk
+  uuidv7_merge_run_t runs[N_RUNS];
+  size_t supplied[N_RUNS], offsets[N_RUNS], heap[N_RUNS];
+  size_t offset = 0;
+  for (int r = 0; r < N_RUNS; r++) {
+    offsets[r] = offset;
+    offset += lengths[r];
+    supplied[r] = 0;
+    runs[r].uuids = NULL;
+    runs[r].n_uuids = 0;
+    runs[r].finished = 0;
+  }
+
+  uuidv7_merger_t m;
+  uuidv7_merger_init(&m, runs, N_RUNS, heap);
+  size_t n_merged = 0;
+  for (;;) {
+    size_t n = uuidv7_merger_next(&m, &merged[16 * n_merged], 1000);
+    n_merged += n;
+    if (n == 1000) {
+      continue;
+    }
+    if (m.starved < 0) {
+      break;
+    }
+    int r = (int)m.starved;
+    assert(runs[r].n_uuids == 0 && !runs[r].finished);
+    size_t chunk = lengths[r] - supplied[r];
+    if (chunk > CHUNK) {
+      chunk = CHUNK;
+    }
+    runs[r].uuids = &uuids[16 * (offsets[r] + supplied[r])];
+    runs[r].n_uuids = chunk;
+    supplied[r] += chunk;
+    runs[r].finished = supplied[r] == lengths[r];
+  }
+  assert(n_merged == total);
+  assert(memcmp(merged, expected, 16 * total) == 0);
+  assert(uuidv7_merger_next(&m, merged, 1000) == 0);
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_sort_shuffled();
+  fprintf(stderr, "  %s: ok\n", "test_sort_shuffled");
+  test_sort_edge_cases();
+  fprintf(stderr, "  %s: ok\n", "test_sort_edge_cases");
+  test_sort_runs();
+  fprintf(stderr, "  %s: ok\n", "test_sort_runs");
+  test_merger();
+  fprintf(stderr, "  %s: ok\n", "test_merger");
+
+  return 0;
+}
+#endif
@@ -0,0 +1,77 @@
+#include "uuidv7_state64.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void test_round_trip(void) {
+  uint8_t uuid[16], uuid_prev[16], rand_bytes[10];
+  assert(uuidv7_state64_unpack(0, 0x17f22e279b0, uuid_prev) == NULL);
+
+  for (int i = 0; i < 100000; i++) {
+    fill_rand(rand_bytes);
+    uint64_t unix_ts_ms = next_rand() >> 16;
+    assert(uuidv7_generate(uuid, unix_ts_ms, rand_bytes, NULL) >= 0);
+    uint64_t state = uuidv7_state64_pack(uuid);
+    assert(state & UUIDV7_STATE64_VALID);
+
+    // the exact timestamp, or one a concurrent writer has just stored
+    uint64_t hint = unix_ts_ms + next_rand() % 2001 - 1000;
+    if (hint >= ((uint64_t)1 << 48)) {
+      hint = unix_ts_ms;
+    }
+    memset(uuid_prev, 0, sizeof(uuid_prev));
+    assert(uuidv7_state64_unpack(state, hint, uuid_prev) == uuid_prev);
+    assert(uuidv7_get_timestamp(uuid_prev) == unix_ts_ms);
+    assert(uuidv7_get_counter(uuid_prev) == uuidv7_get_counter(uuid));
+  }
+}
+
+void test_idle_gap(void) {
+  // an idle generator resumes from the stored timestamp however long it has
+  // been idle, including gaps close to multiples of 2^21 ms
+  const uint64_t t0 = 0x17f22e279b0;
+  const int64_t gaps[] = {1000,
+                          ((int64_t)1 << 20) + 1,
+                          ((int64_t)1 << 21) - 5000,
+                          ((int64_t)1 << 21),
+                          ((int64_t)1 << 21) + 5000,
+                          ((int64_t)3 << 21) - 1,
+                          -((int64_t)1 << 21) + 5000,
+                          -5000};
+  uint8_t prev[16], uuid[16], uuid_prev[16], rand_bytes[10];
+  for (size_t k = 0; k < sizeof(gaps) / sizeof(gaps[0]); k++) {
+    fill_rand(rand_bytes);
+    assert(uuidv7_generate(prev, t0, rand_bytes, NULL) >= 0);
+    uint64_t state = uuidv7_state64_pack(prev);
+
+    uint64_t unix_ts_ms = t0 + (uint64_t)gaps[k];
+    fill_rand(rand_bytes);
+    int8_t status = uuidv7_generate(
+        uuid, unix_ts_ms, rand_bytes,
+        uuidv7_state64_unpack(state, t0, uuid_prev));
+    if (gaps[k] > 0) {
+      assert(status == UUIDV7_STATUS_NEW_TIMESTAMP);
+      assert(uuidv7_get_timestamp(uuid) == unix_ts_ms);
+    } else if (gaps[k] >= -10000) {
+      assert(status == UUIDV7_STATUS_COUNTER_INC);
+      assert(uuidv7_get_timestamp(uuid) == t0);
+    } else {
+      assert(status == UUIDV7_STATUS_CLOCK_ROLLBACK);
+      assert(uuidv7_get_timestamp(uuid) == unix_ts_ms);
+    }
+  }
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_round_trip();
+  fprintf(stderr, "  %s: ok\n", "test_round_trip");
+  test_idle_gap();
+  fprintf(stderr, "  %s: ok\n", "test_idle_gap");
+
+  return 0;
+}
+#endif
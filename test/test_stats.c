@@ -0,0 +1,115 @@
+#include "uuidv7.h"
+#include "uuidv7_stats.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+
+// must be defined for the implementation as well
+#if UUIDV7_STATS_LATENCY_INTERVAL != 1
+#error "define UUIDV7_STATS_LATENCY_INTERVAL=1 to time every call"
+#endif
+
+#define N_THREADS 4
+#define N_PER_THREAD 50000
+
+static uint64_t sum(const uint64_t *counters, int n) {
+  uint64_t acc = 0;
+  for (int i = 0; i < n; i++) {
+    acc += counters[i];
+  }
+  return acc;
+}
+
+static char failed;
+
+static void *generate_many(void *arg) {
+  (void)arg;
+  uint8_t uuid[16];
+  for (int i = 0; i < N_PER_THREAD; i++) {
+    if (uuidv7_new(uuid) < 0) {
+      return &failed;
+    }
+  }
+  return NULL;
+}
+
+void test_counts(void) {
+  // counters of exited threads must survive in the snapshot
+  uuidv7_stats_t before, after;
+  uuidv7_stats_snapshot(&before);
+
+  pthread_t threads[N_THREADS];
+  for (int i = 0; i < N_THREADS; i++) {
+    assert(pthread_create(&threads[i], NULL, generate_many, NULL) == 0);
+  }
+  for (int i = 0; i < N_THREADS; i++) {
+    void *ret;
+    pthread_join(threads[i], &ret);
+    assert(ret == NULL);
+  }
+
+  uint8_t uuid[16];
+  assert(uuidv7_new(uuid) >= 0);
+  uuidv7_stats_snapshot(&after);
+
+  uint64_t n = (uint64_t)N_THREADS * N_PER_THREAD + 1;
+#ifdef UUIDV7_STATS
+  uint64_t n_ok = 0;
+  for (int s = 0; s < UUIDV7_STATS_N_STATUS; s++) {
+    uint64_t delta = after.n_status[s] - before.n_status[s];
+    if (s + UUIDV7_STATS_MIN_STATUS < 0) {
+      assert(delta == 0);
+    } else {
+      n_ok += delta;
+    }
+  }
+  assert(n_ok == n);
+  assert(after.n_other_errors == before.n_other_errors);
+  assert(sum(after.latency_log2_ns, UUIDV7_STATS_N_BUCKETS) -
+             sum(before.latency_log2_ns, UUIDV7_STATS_N_BUCKETS) ==
+         n);
+
+  // every 4 KiB pool serves at most 1024 UUIDs
+  assert(after.n_rand_refills - before.n_rand_refills >= n / 1024);
+  assert(after.max_skew_ms >= before.max_skew_ms);
+  assert(after.max_skew_ms < 10000);
+#else
+  (void)n;
+  assert(sum(after.n_status, UUIDV7_STATS_N_STATUS) == 0);
+  assert(after.n_rand_refills == 0);
+  assert(sum(after.latency_log2_ns, UUIDV7_STATS_N_BUCKETS) == 0);
+#endif
+}
+
+void test_thread_reuse(void) {
+  // threads that come and go must not lose counts while blocks are recycled
+  uuidv7_stats_t before, after;
+  uuidv7_stats_snapshot(&before);
+  for (int i = 0; i < 100; i++) {
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, generate_many, NULL) == 0);
+    void *ret;
+    pthread_join(thread, &ret);
+    assert(ret == NULL);
+  }
+  uuidv7_stats_snapshot(&after);
+#ifdef UUIDV7_STATS
+  assert(sum(after.latency_log2_ns, UUIDV7_STATS_N_BUCKETS) -
+             sum(before.latency_log2_ns, UUIDV7_STATS_N_BUCKETS) ==
+         (uint64_t)100 * N_PER_THREAD);
+#else
+  assert(sum(after.latency_log2_ns, UUIDV7_STATS_N_BUCKETS) == 0);
+#endif
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_counts();
+  fprintf(stderr, "  %s: ok\n", "test_counts");
+  test_thread_reuse();
+  fprintf(stderr, "  %s: ok\n", "test_thread_reuse");
+
+  return 0;
+}
+#endif
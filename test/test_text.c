@@ -0,0 +1,281 @@
+#include "uuidv7.h"
+#include "uuidv7_text.h"
+
+#include "test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N_UUIDS 10000
+
+static uint8_t uuids[16 * N_UUIDS];
+static uint8_t decoded[16 * N_UUIDS];
+static uint8_t failed[N_UUIDS];
+static char text[27 * N_UUIDS];
+
+static const char BASE32[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+static const char BASE64URL[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/** Fills `uuids` with UUIDv7s mixed with random and all-zero/one values. */
+static void fill_uuids(void) {
+  uint64_t unix_ts_ms = 0x17f22e279b0;
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    uint8_t *out = &uuids[16 * i];
+    uint8_t rand_bytes[10];
+    fill_rand(rand_bytes);
+    unix_ts_ms += next_rand() % 3;
+    if (i % 7 == 3) {
+      for (int j = 0; j < 16; j++) {
+        out[j] = (uint8_t)next_rand();
+      }
+    } else {
+      uuidv7_generate(out, unix_ts_ms, rand_bytes, NULL);
+    }
+  }
+  memset(&uuids[0], 0x00, 16);
+  memset(&uuids[16], 0xff, 16);
+}
+
+/**
+ * Encodes a UUID bit by bit, as a reference for the word-based encoders.
+ *
+ * @param n_pad_before  Number of zero bits before the UUID.
+ * @param bits          Number of bits per digit.
+ */
+static void encode_reference(const uint8_t *uuid, int n_pad_before, int bits,
+                             const char *digits, int n_digits, char *out) {
+  for (int i = 0; i < n_digits; i++) {
+    int value = 0;
+    for (int j = 0; j < bits; j++) {
+      int pos = i * bits + j - n_pad_before;
+      int bit = pos >= 0 && pos < 128 ? uuid[pos / 8] >> (7 - pos % 8) & 1 : 0;
+      value = value << 1 | bit;
+    }
+    out[i] = digits[value];
+  }
+  out[n_digits] = '\0';
+}
+
+void test_known_values(void) {
+  const uint8_t uuid[16] = {0x01, 0x7f, 0x22, 0xe2, 0x79, 0xb0, 0x7c, 0xc3,
+                            0x98, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f};
+  uint8_t out[16];
+  char string[27];
+
+  uuidv7_to_base32(uuid, string);
+  assert(strcmp(string, "01FWHE4YDGFK1SHH6W1G60EECF") == 0);
+  assert(uuidv7_from_base32(string, out) == 0);
+  assert(memcmp(out, uuid, 16) == 0);
+  assert(uuidv7_from_base32("01fwhe4ydgfk1shh6w1g60eecf", out) == 0);
+  assert(memcmp(out, uuid, 16) == 0);
+
+  uuidv7_to_base64url(uuid, string);
+  assert(strcmp(string, "AX8i4nmwfMOYxNwMDAc5jw") == 0);
+  assert(uuidv7_from_base64url(string, out) == 0);
+  assert(memcmp(out, uuid, 16) == 0);
+
+  const uint8_t max[16] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                           0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+  uuidv7_to_base32(max, string);
+  assert(strcmp(string, "7ZZZZZZZZZZZZZZZZZZZZZZZZZ") == 0);
+  uuidv7_to_base64url(max, string);
+  assert(strcmp(string, "_____________________w") == 0);
+}
+
+void test_round_trip(void) {
+  fill_uuids();
+  for (size_t i = 0; i < N_UUIDS; i++) {
+    const uint8_t *uuid = &uuids[16 * i];
+    char string[27], expected[27];
+    uint8_t out[16];
+
+    uuidv7_to_base32(uuid, string);
+    encode_reference(uuid, 2, 5, BASE32, 26, expected);
+    assert(strcmp(string, expected) == 0);
+    assert(uuidv7_from_base32(string, out) == 0);
+    assert(memcmp(out, uuid, 16) == 0);
+
+    uuidv7_to_base64url(uuid, string);
+    encode_reference(uuid, 0, 6, BASE64URL, 22, expected);
+    assert(strcmp(string, expected) == 0);
+    assert(uuidv7_from_base64url(string, out) == 0);
+    assert(memcmp(out, uuid, 16) == 0);
+  }
+
+  // Base32 strings sort in the same order as the bytes
+  for (size_t i = 1; i < N_UUIDS; i++) {
+    char a[27], b[27];
+    uuidv7_to_base32(&uuids[16 * (i - 1)], a);
+    uuidv7_to_base32(&uuids[16 * i], b);
+    int by_bytes = memcmp(&uuids[16 * (i - 1)], &uuids[16 * i], 16);
+    int by_text = strcmp(a, b);
+    assert((by_bytes < 0) == (by_text < 0));
+    assert((by_bytes > 0) == (by_text > 0));
+  }
+}
+
+/**
+ * Replaces each character of a valid string with every byte value and checks
+ * that the decoders accept exactly the digits that yield a canonical string.
+ */
+void test_strict(void) {
+  const uint8_t uuid[16] = {0x01, 0x7f, 0x22, 0xe2, 0x79, 0xb0, 0x7c, 0xc3,
+                            0x98, 0xc4, 0xdc, 0x0c, 0x0c, 0x07, 0x39, 0x8f};
+  uint8_t out[16];
+  char string[28];
+
+  uuidv7_to_base32(uuid, string);
+  for (int pos = 0; pos < 26; pos++) {
+    for (int c = 1; c < 256; c++) {
+      char s[27];
+      memcpy(s, string, 27);
+      s[pos] = (char)c;
+      const char *p = strchr(BASE32, c >= 'a' && c <= 'z' ? c - 0x20 : c);
+      int expected = p != NULL && (pos > 0 || p - BASE32 < 8);
+      assert((uuidv7_from_base32(s, out) == 0) == expected);
+      if (expected) {
+        char canonical[27];
+        uuidv7_to_base32(out, canonical);
+        s[pos] = BASE32[p - BASE32];
+        assert(strcmp(canonical, s) == 0);
+      }
+    }
+  }
+  assert(uuidv7_from_base32("01FWHE4YDGFK1SHH6W1G60EEC", out) != 0);
+  assert(uuidv7_from_base32("01FWHE4YDGFK1SHH6W1G60EECFF", out) != 0);
+  assert(uuidv7_from_base32("01FWHE4YDGFK1SHH6W1G60EECI", out) != 0);
+  assert(uuidv7_from_base32("01FWHE4YDGFK1SHH6W1G60EECL", out) != 0);
+  assert(uuidv7_from_base32("01FWHE4YDGFK1SHH6W1G60EECO", out) != 0);
+  assert(uuidv7_from_base32("01FWHE4YDGFK1SHH6W1G60EECU", out) != 0);
+  assert(uuidv7_from_base32("81FWHE4YDGFK1SHH6W1G60EECF", out) != 0);
+
+  uuidv7_to_base64url(uuid, string);
+  for (int pos = 0; pos < 22; pos++) {
+    for (int c = 1; c < 256; c++) {
+      char s[23];
+      memcpy(s, string, 23);
+      s[pos] = (char)c;
+      const char *p = c != 0 ? strchr(BASE64URL, c) : NULL;
+      int expected = p != NULL && (pos < 21 || (p - BASE64URL) % 16 == 0);
+      assert((uuidv7_from_base64url(s, out) == 0) == expected);
+    }
+  }
+  assert(uuidv7_from_base64url("AX8i4nmwfMOYxNwMDAc5j", out) != 0);
+  assert(uuidv7_from_base64url("AX8i4nmwfMOYxNwMDAc5jww", out) != 0);
+  assert(uuidv7_from_base64url("AX8i4nmwfMOYxNwMDAc5jw==", out) != 0);
+  assert(uuidv7_from_base64url("AX8i4nmwfMOYxNwMDAc5jx", out) != 0);
+  assert(uuidv7_from_base64url("AX8i4nmwfMOYxNwMDAc+jw", out) != 0);
+  assert(uuidv7_from_base64url("AX8i4nmwfMOYxNwMDAc/jw", out) != 0);
+}
+
+void test_bulk(void) {
+  fill_uuids();
+  const int separators[] = {-1, '\0', '\n'};
+  for (int k = 0; k < 3; k++) {
+    int separator = separators[k];
+    size_t stride = separator < 0 ? 26 : 27;
+    assert(uuidv7_to_base32_bulk(uuids, N_UUIDS, text, separator) ==
+           stride * N_UUIDS);
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      char string[27];
+      uuidv7_to_base32(&uuids[16 * i], string);
+      assert(memcmp(&text[stride * i], string, 26) == 0);
+      assert(separator < 0 || text[stride * i + 26] == (char)separator);
+    }
+    memset(failed, 0xff, N_UUIDS);
+    assert(uuidv7_from_base32_bulk(text, N_UUIDS, separator, decoded,
+                                   failed) == 0);
+    assert(memcmp(decoded, uuids, 16 * N_UUIDS) == 0);
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      assert(failed[i] == 0);
+    }
+
+    stride = separator < 0 ? 22 : 23;
+    assert(uuidv7_to_base64url_bulk(uuids, N_UUIDS, text, separator) ==
+           stride * N_UUIDS);
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      char string[23];
+      uuidv7_to_base64url(&uuids[16 * i], string);
+      assert(memcmp(&text[stride * i], string, 22) == 0);
+      assert(separator < 0 || text[stride * i + 22] == (char)separator);
+    }
+    memset(failed, 0xff, N_UUIDS);
+    assert(uuidv7_from_base64url_bulk(text, N_UUIDS, separator, decoded,
+                                      failed) == 0);
+    assert(memcmp(decoded, uuids, 16 * N_UUIDS) == 0);
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      assert(failed[i] == 0);
+    }
+  }
+
+  // lower case Base32 is accepted in bulk as well
+  uuidv7_to_base32_bulk(uuids, N_UUIDS, text, '\n');
+  for (size_t i = 0; i < 27 * N_UUIDS; i++) {
+    if (i % 2 == 0 && text[i] >= 'A' && text[i] <= 'Z') {
+      text[i] = (char)(text[i] + 0x20);
+    }
+  }
+  assert(uuidv7_from_base32_bulk(text, N_UUIDS, '\n', decoded, NULL) == 0);
+  assert(memcmp(decoded, uuids, 16 * N_UUIDS) == 0);
+}
+
+/** Corrupts one character per string and compares with the single decoders. */
+void test_bulk_invalid(void) {
+  fill_uuids();
+  for (int base = 32; base <= 64; base += 32) {
+    size_t len = base == 32 ? 26 : 22;
+    if (base == 32) {
+      uuidv7_to_base32_bulk(uuids, N_UUIDS, text, '\n');
+    } else {
+      uuidv7_to_base64url_bulk(uuids, N_UUIDS, text, '\n');
+    }
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      if (next_rand() % 2 == 0) {
+        text[(len + 1) * i + next_rand() % (len + 1)] =
+            (char)(next_rand() % 256);
+      }
+    }
+
+    size_t n_failed = base == 32 ? uuidv7_from_base32_bulk(text, N_UUIDS, '\n',
+                                                           decoded, failed)
+                                 : uuidv7_from_base64url_bulk(
+                                       text, N_UUIDS, '\n', decoded, failed);
+    size_t n_expected = 0;
+    for (size_t i = 0; i < N_UUIDS; i++) {
+      char string[28];
+      memcpy(string, &text[(len + 1) * i], len + 1);
+      int valid = string[len] == '\n';
+      string[len] = '\0';
+      uint8_t out[16];
+      valid &= base == 32 ? uuidv7_from_base32(string, out) == 0
+                          : uuidv7_from_base64url(string, out) == 0;
+      valid &= strlen(string) == len; // NUL inserted by the corruption
+      assert(failed[i] == !valid);
+      if (valid) {
+        assert(memcmp(&decoded[16 * i], out, 16) == 0);
+      }
+      n_expected += !valid;
+    }
+    assert(n_failed == n_expected);
+    assert(n_failed > N_UUIDS / 4);
+  }
+}
+
+#ifndef NDEBUG
+int main(void) {
+  test_known_values();
+  fprintf(stderr, "  %s: ok\n", "test_known_values");
+  test_round_trip();
+  fprintf(stderr, "  %s: ok\n", "test_round_trip");
+  test_strict();
+  fprintf(stderr, "  %s: ok\n", "test_strict");
+  test_bulk();
+  fprintf(stderr, "  %s: ok\n", "test_bulk");
+  test_bulk_invalid();
+  fprintf(stderr, "  %s: ok\n", "test_bulk_invalid");
+
+  return 0;
+}
+#endif
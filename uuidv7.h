@@ -28,9 +28,14 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 /**
- * @name Status codes returned by uuidv7_generate()
+ * @name Status codes returned by uuidv7_generate() and uuidv7_gen_next()
  *
  * @{
  */
@@ -74,6 +79,12 @@
  */
 #define UUIDV7_STATUS_ERR_TIMESTAMP_OVERFLOW (-2)
 
+/**
+ * Indicates that `uuidv7_gen_next()` failed because fewer random bytes were
+ * available to the generator than required.
+ */
+#define UUIDV7_STATUS_ERR_RAND_SHORTAGE (-3)
+
 /** @} */
 
 #ifdef __cplusplus
@@ -213,6 +224,38 @@ static inline void uuidv7_to_string(const uint8_t *uuid, char *string_out) {
   *string_out = '\0';
 }
 
+/**
+ * Decodes a hexadecimal digit.
+ *
+ * @param c  Character to decode. Both upper and lower case are accepted.
+ * @return   Value of the digit (0-15), or `0xff` if `c` is not a hexadecimal
+ *           digit.
+ */
+static inline uint8_t uuidv7_decode_hex_digit(char c) {
+  // clang-format off
+  static const uint8_t VALUES[128] = {
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+         0,    1,    2,    3,    4,    5,    6,    7,
+         8,    9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff,   10,   11,   12,   13,   14,   15, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff,   10,   11,   12,   13,   14,   15, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  };
+  // clang-format on
+  uint8_t u = (uint8_t)c;
+  return u < 128 ? VALUES[u] : 0xff;
+}
+
 /**
  * Decodes the 8-4-4-4-12 hexadecimal string representation of a UUID.
  *
@@ -222,27 +265,19 @@ static inline void uuidv7_to_string(const uint8_t *uuid, char *string_out) {
  * @return          Zero on success or non-zero integer on failure.
  */
 static inline int uuidv7_from_string(const char *string, uint8_t *uuid_out) {
-  for (int i = 0; i < 32; i++) {
-    char c = *string++;
-    // clang-format off
-    uint8_t x = c == '0' ?  0 : c == '1' ?  1 : c == '2' ?  2 : c == '3' ?  3
-              : c == '4' ?  4 : c == '5' ?  5 : c == '6' ?  6 : c == '7' ?  7
-              : c == '8' ?  8 : c == '9' ?  9 : c == 'a' ? 10 : c == 'b' ? 11
-              : c == 'c' ? 12 : c == 'd' ? 13 : c == 'e' ? 14 : c == 'f' ? 15
-              : c == 'A' ? 10 : c == 'B' ? 11 : c == 'C' ? 12 : c == 'D' ? 13
-              : c == 'E' ? 14 : c == 'F' ? 15 : 0xff;
-    // clang-format on
-    if (x == 0xff) {
+  for (int i = 0; i < 16; i++) {
+    // check each digit before reading the next so as not to read past NUL
+    uint8_t hi = uuidv7_decode_hex_digit(*string++);
+    if (hi == 0xff) {
       return -1; // invalid digit
     }
-
-    if ((i & 1) == 0) {
-      uuid_out[i >> 1] = x << 4; // even i => hi 4 bits
-    } else {
-      uuid_out[i >> 1] |= x; // odd i => lo 4 bits
+    uint8_t lo = uuidv7_decode_hex_digit(*string++);
+    if (lo == 0xff) {
+      return -1; // invalid digit
     }
+    uuid_out[i] = (hi << 4) | lo;
 
-    if ((i == 7 || i == 11 || i == 15 || i == 19) && (*string++ != '-')) {
+    if ((i == 3 || i == 5 || i == 7 || i == 9) && (*string++ != '-')) {
       return -1; // invalid format
     }
   }
@@ -254,6 +289,1185 @@ static inline int uuidv7_from_string(const char *string, uint8_t *uuid_out) {
 
 /** @} */
 
+/**
+ * @name Word representation
+ *
+ * These functions hold a UUID as two 64-bit words in big-endian order: `hi`
+ * holds `unix_ts_ms`, `ver`, and the upper 12 bits of `counter`, and `lo`
+ * holds `var`, the lower 30 bits of `counter`, and the 32-bit random tail.
+ * Fields are then a few shifts and masks away, and each word moves to and from
+ * the 16-byte representation with a single byte swap on little-endian targets.
+ * Both representations are interchangeable: the word functions produce the same
+ * UUIDs, strings, and status codes as their byte-oriented counterparts.
+ *
+ * @{
+ */
+
+/** UUID represented as two 64-bit words in big-endian order. */
+typedef struct {
+  /** Bytes 0-7: `unix_ts_ms`, `ver`, and the upper 12 bits of `counter`. */
+  uint64_t hi;
+
+  /** Bytes 8-15: `var`, the lower 30 bits of `counter`, and random bits. */
+  uint64_t lo;
+} uuidv7_words_t;
+
+/** Loads 8 bytes as a big-endian integer. */
+static inline uint64_t uuidv7_load_be64(const uint8_t *bytes) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) &&                           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t word;
+  memcpy(&word, bytes, 8);
+  return __builtin_bswap64(word);
+#else
+  return (uint64_t)bytes[0] << 56 | (uint64_t)bytes[1] << 48 |
+         (uint64_t)bytes[2] << 40 | (uint64_t)bytes[3] << 32 |
+         (uint64_t)bytes[4] << 24 | (uint64_t)bytes[5] << 16 |
+         (uint64_t)bytes[6] << 8 | (uint64_t)bytes[7];
+#endif
+}
+
+/** Stores an integer as 8 bytes in big-endian order. */
+static inline void uuidv7_store_be64(uint64_t word, uint8_t *bytes_out) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) &&                           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+  memcpy(bytes_out, &word, 8);
+#else
+  for (int i = 0; i < 8; i++) {
+    bytes_out[i] = (uint8_t)(word >> (56 - 8 * i));
+  }
+#endif
+}
+
+/** Loads 4 bytes as a big-endian integer. */
+static inline uint32_t uuidv7_load_be32(const uint8_t *bytes) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) &&                           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint32_t word;
+  memcpy(&word, bytes, 4);
+  return __builtin_bswap32(word);
+#else
+  return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 |
+         (uint32_t)bytes[2] << 8 | (uint32_t)bytes[3];
+#endif
+}
+
+/** Stores an integer as 4 bytes in big-endian order. */
+static inline void uuidv7_store_be32(uint32_t word, uint8_t *bytes_out) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) &&                           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap32(word);
+  memcpy(bytes_out, &word, 4);
+#else
+  bytes_out[0] = (uint8_t)(word >> 24);
+  bytes_out[1] = (uint8_t)(word >> 16);
+  bytes_out[2] = (uint8_t)(word >> 8);
+  bytes_out[3] = (uint8_t)word;
+#endif
+}
+
+/**
+ * Converts a UUID from the 16-byte representation to words.
+ *
+ * @param uuid       16-byte byte array representing the UUID.
+ * @param words_out  Location where the words are stored.
+ */
+static inline void uuidv7_words_from_bytes(const uint8_t *uuid,
+                                           uuidv7_words_t *words_out) {
+  words_out->hi = uuidv7_load_be64(uuid);
+  words_out->lo = uuidv7_load_be64(&uuid[8]);
+}
+
+/**
+ * Converts a UUID from words to the 16-byte representation.
+ *
+ * @param words     UUID to convert.
+ * @param uuid_out  16-byte byte array where the UUID is stored.
+ */
+static inline void uuidv7_words_to_bytes(const uuidv7_words_t *words,
+                                         uint8_t *uuid_out) {
+  uuidv7_store_be64(words->hi, uuid_out);
+  uuidv7_store_be64(words->lo, &uuid_out[8]);
+}
+
+/** Extracts the 48-bit `unix_ts_ms` field of a UUIDv7 in words. */
+static inline uint64_t uuidv7_words_get_timestamp(const uuidv7_words_t *words) {
+  return words->hi >> 16;
+}
+
+/** Extracts the 42-bit `counter` field of a UUIDv7 in words. */
+static inline uint64_t uuidv7_words_get_counter(const uuidv7_words_t *words) {
+  return (words->hi & 0xfff) << 30 | (words->lo >> 32 & 0x3fffffff);
+}
+
+/**
+ * Generates a new UUIDv7 in words.
+ *
+ * This function is equivalent to `uuidv7_generate()`: given the same
+ * arguments, it produces the same UUID and status code and consumes the same
+ * random bytes.
+ *
+ * @param uuid_out    Location where the generated UUID is stored.
+ * @param unix_ts_ms  Current Unix time in milliseconds.
+ * @param rand_bytes  At least 10-byte byte array filled with random bytes,
+ *                    consumed in the same manner as by `uuidv7_generate()`.
+ * @param uuid_prev   Immediately preceding UUID, or NULL. This may point to the
+ *                    same location as `uuid_out`.
+ * @return            One of the `UUIDV7_STATUS_*` codes that
+ *                    `uuidv7_generate()` returns.
+ */
+static inline int8_t uuidv7_generate_words(uuidv7_words_t *uuid_out,
+                                           uint64_t unix_ts_ms,
+                                           const uint8_t *rand_bytes,
+                                           const uuidv7_words_t *uuid_prev) {
+  static const uint64_t MAX_TIMESTAMP = ((uint64_t)1 << 48) - 1;
+  static const uint64_t MAX_COUNTER = ((uint64_t)1 << 42) - 1;
+
+  if (unix_ts_ms > MAX_TIMESTAMP) {
+    return UUIDV7_STATUS_ERR_TIMESTAMP;
+  }
+
+  int8_t status;
+  uint64_t timestamp = unix_ts_ms;
+  if (uuid_prev == NULL) {
+    status = UUIDV7_STATUS_UNPRECEDENTED;
+  } else {
+    uint64_t prev_timestamp = uuidv7_words_get_timestamp(uuid_prev);
+    if (unix_ts_ms > prev_timestamp) {
+      status = UUIDV7_STATUS_NEW_TIMESTAMP;
+    } else if (unix_ts_ms + 10000 < prev_timestamp) {
+      status = UUIDV7_STATUS_CLOCK_ROLLBACK;
+    } else {
+      uint64_t counter = uuidv7_words_get_counter(uuid_prev);
+      if (counter < MAX_COUNTER) {
+        counter++;
+        uuid_out->hi = prev_timestamp << 16 | 0x7000 | counter >> 30;
+        uuid_out->lo = (uint64_t)0x8 << 60 | (counter & 0x3fffffff) << 32 |
+                       uuidv7_load_be32(rand_bytes);
+        return UUIDV7_STATUS_COUNTER_INC;
+      }
+      if (prev_timestamp == MAX_TIMESTAMP) {
+        return UUIDV7_STATUS_ERR_TIMESTAMP_OVERFLOW;
+      }
+      status = UUIDV7_STATUS_TIMESTAMP_INC;
+      timestamp = prev_timestamp + 1;
+    }
+  }
+
+  // same bytes as uuidv7_generate() with ver and var set in place
+  uint32_t head = (uint32_t)rand_bytes[0] << 8 | rand_bytes[1];
+  uuid_out->hi = timestamp << 16 | 0x7000 | (head & 0x0fff);
+  uuid_out->lo = (uint64_t)(0x80000000 |
+                            (uuidv7_load_be32(&rand_bytes[2]) & 0x3fffffff))
+                     << 32 |
+                 uuidv7_load_be32(&rand_bytes[6]);
+  return status;
+}
+
+/**
+ * Spreads the 8 nibbles of a 32-bit integer into the 8 bytes of a 64-bit
+ * integer and converts them to lowercase hexadecimal digits.
+ */
+static inline uint64_t uuidv7_words_hex32(uint32_t x) {
+  uint64_t v = x;
+  v = (v | v << 16) & 0x0000ffff0000ffff;
+  v = (v | v << 8) & 0x00ff00ff00ff00ff;
+  v = (v | v << 4) & 0x0f0f0f0f0f0f0f0f;
+  // add '0' to each nibble and 'a' - '0' - 10 to those greater than 9
+  uint64_t alpha = ((v + 0x0606060606060606) >> 4) & 0x0101010101010101;
+  return v + 0x3030303030303030 + alpha * ('a' - '0' - 10);
+}
+
+/**
+ * Encodes a UUID in words in the 8-4-4-4-12 hexadecimal string representation.
+ *
+ * This function writes the same string as `uuidv7_to_string()`, converting
+ * eight digits at a time within 64-bit integers.
+ *
+ * @param words       UUID to encode.
+ * @param string_out  Character array where the encoded string is stored. Its
+ *                    length must be 37 (36 digits + NUL) or longer.
+ */
+static inline void uuidv7_words_to_string(const uuidv7_words_t *words,
+                                          char *string_out) {
+  uint8_t *out = (uint8_t *)string_out;
+  uint64_t x = uuidv7_words_hex32((uint32_t)(words->hi >> 32));
+  uuidv7_store_be64(x, out);
+  x = uuidv7_words_hex32((uint32_t)words->hi);
+  uuidv7_store_be32((uint32_t)(x >> 32), &out[9]);
+  uuidv7_store_be32((uint32_t)x, &out[14]);
+  x = uuidv7_words_hex32((uint32_t)(words->lo >> 32));
+  uuidv7_store_be32((uint32_t)(x >> 32), &out[19]);
+  uuidv7_store_be32((uint32_t)x, &out[24]);
+  x = uuidv7_words_hex32((uint32_t)words->lo);
+  uuidv7_store_be64(x, &out[28]);
+  string_out[8] = string_out[13] = string_out[18] = string_out[23] = '-';
+  string_out[36] = '\0';
+}
+
+/**
+ * Decodes 8 hexadecimal digits held in the bytes of a 64-bit integer.
+ *
+ * @return  Decoded 32-bit value, or a value greater than `UINT32_MAX` if any
+ *          byte is not a hexadecimal digit.
+ */
+static inline uint64_t uuidv7_words_unhex32(uint64_t v) {
+  static const uint64_t H = 0x8080808080808080;
+  // test each byte against the digit and letter ranges; the additions do not
+  // carry across bytes because the bytes are less than 0x80 if valid at all
+  uint64_t x = v & ~H;
+  uint64_t y = x | 0x2020202020202020; // fold 'A'-'F' into 'a'-'f'
+  uint64_t digit = (x + 0x5050505050505050) & ~(x + 0x4646464646464646) & H;
+  uint64_t alpha = (y + 0x1f1f1f1f1f1f1f1f) & ~(y + 0x1919191919191919) & H;
+  uint64_t invalid = ((digit | alpha) ^ H) | (v & H);
+
+  // map digits to 0-9 and letters to 10-15, then pack the nibbles
+  x = (x & 0x0f0f0f0f0f0f0f0f) + (alpha >> 7) * 9;
+  x = (x | x >> 4) & 0x00ff00ff00ff00ff;
+  x = (x | x >> 8) & 0x0000ffff0000ffff;
+  x = (x | x >> 16) & 0x00000000ffffffff;
+  return x | (uint64_t)(invalid != 0) << 32;
+}
+
+/**
+ * Decodes the 8-4-4-4-12 hexadecimal string representation of a UUID to
+ * words.
+ *
+ * This function accepts the same strings as `uuidv7_from_string()` but reads
+ * eight characters at a time and thus requires `string` to have 36 readable
+ * characters; it does not examine the character after them.
+ *
+ * @param string     36-character array. Both upper and lower case are accepted.
+ * @param words_out  Location where the decoded UUID is stored.
+ * @return           Zero on success or non-zero integer on failure.
+ */
+static inline int uuidv7_words_from_string(const char *string,
+                                           uuidv7_words_t *words_out) {
+  const uint8_t *in = (const uint8_t *)string;
+  uint64_t a = uuidv7_words_unhex32(uuidv7_load_be64(in));
+  uint64_t b = uuidv7_words_unhex32((uint64_t)uuidv7_load_be32(&in[9]) << 32 |
+                                    uuidv7_load_be32(&in[14]));
+  uint64_t c = uuidv7_words_unhex32((uint64_t)uuidv7_load_be32(&in[19]) << 32 |
+                                    uuidv7_load_be32(&in[24]));
+  uint64_t d = uuidv7_words_unhex32(uuidv7_load_be64(&in[28]));
+  if (((a | b | c | d) >> 32) != 0 || string[8] != '-' || string[13] != '-' ||
+      string[18] != '-' || string[23] != '-') {
+    return -1;
+  }
+  words_out->hi = a << 32 | b;
+  words_out->lo = c << 32 | d;
+  return 0;
+}
+
+/** @} */
+
+/**
+ * @name Bulk string conversion
+ *
+ * @{
+ */
+
+/**
+ * Encodes an array of UUIDs in the 8-4-4-4-12 hexadecimal string
+ * representation.
+ *
+ * This function writes the strings at a fixed stride and uses SSE2, SSSE3, or
+ * AVX2 instructions if the compiler targets them (e.g. `-mssse3`), unless
+ * `UUIDV7_NO_SIMD` is defined. Otherwise, it falls back to portable code.
+ *
+ * @param uuids      Byte array of `16 * n_uuids` bytes representing the UUIDs
+ *                   to encode.
+ * @param n_uuids    Number of UUIDs to encode.
+ * @param text_out   Character array where the encoded strings are stored. Its
+ *                   length must be `36 * n_uuids` or longer without separators
+ *                   or `37 * n_uuids` or longer with separators.
+ * @param separator  Character written after each string, such as `'\0'` or
+ *                   `'\n'`, or a negative value to write no separator.
+ * @return           Number of characters written to `text_out`.
+ */
+static inline size_t uuidv7_to_string_bulk(const uint8_t *uuids, size_t n_uuids,
+                                           char *text_out, int separator) {
+  const size_t stride = separator < 0 ? 36 : 37;
+  size_t i = 0;
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSSE3__)
+  // hex digits of 16 bytes are split into two vectors of 16 digits (a and b)
+  // and then shuffled into three slices of the 36-char layout
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i shuf_a0 = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10,
+                                        11, -1, 12, 13);
+  const __m128i shuf_a1 = _mm_setr_epi8(14, 15, -1, -1, -1, -1, -1, -1, -1, -1,
+                                        -1, -1, -1, -1, -1, -1);
+  const __m128i shuf_b1 = _mm_setr_epi8(-1, -1, -1, 0, 1, 2, 3, -1, 4, 5, 6, 7,
+                                        8, 9, 10, 11);
+  const __m128i hyphens0 =
+      _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0);
+  const __m128i hyphens1 =
+      _mm_setr_epi8(0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0);
+
+#if defined(__AVX2__)
+  // process two UUIDs per iteration, one in each 128-bit lane
+  const __m256i mask2 = _mm256_broadcastsi128_si256(mask);
+  const __m256i digits2 = _mm256_broadcastsi128_si256(digits);
+  const __m256i shuf_a02 = _mm256_broadcastsi128_si256(shuf_a0);
+  const __m256i shuf_a12 = _mm256_broadcastsi128_si256(shuf_a1);
+  const __m256i shuf_b12 = _mm256_broadcastsi128_si256(shuf_b1);
+  const __m256i hyphens02 = _mm256_broadcastsi128_si256(hyphens0);
+  const __m256i hyphens12 = _mm256_broadcastsi128_si256(hyphens1);
+  for (; i + 2 <= n_uuids; i += 2) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)&uuids[16 * i]);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), mask2);
+    __m256i lo = _mm256_and_si256(x, mask2);
+    __m256i a = _mm256_shuffle_epi8(digits2, _mm256_unpacklo_epi8(hi, lo));
+    __m256i b = _mm256_shuffle_epi8(digits2, _mm256_unpackhi_epi8(hi, lo));
+    __m256i s0 = _mm256_or_si256(_mm256_shuffle_epi8(a, shuf_a02), hyphens02);
+    __m256i s1 = _mm256_or_si256(
+        _mm256_or_si256(_mm256_shuffle_epi8(a, shuf_a12),
+                        _mm256_shuffle_epi8(b, shuf_b12)),
+        hyphens12);
+    __m256i s2 = _mm256_srli_si256(b, 12);
+
+    char *out = &text_out[stride * i];
+    int32_t tail;
+    _mm_storeu_si128((__m128i *)out, _mm256_castsi256_si128(s0));
+    _mm_storeu_si128((__m128i *)(out + 16), _mm256_castsi256_si128(s1));
+    tail = _mm_cvtsi128_si32(_mm256_castsi256_si128(s2));
+    memcpy(out + 32, &tail, 4);
+
+    out += stride;
+    _mm_storeu_si128((__m128i *)out, _mm256_extracti128_si256(s0, 1));
+    _mm_storeu_si128((__m128i *)(out + 16), _mm256_extracti128_si256(s1, 1));
+    tail = _mm_cvtsi128_si32(_mm256_extracti128_si256(s2, 1));
+    memcpy(out + 32, &tail, 4);
+
+    if (separator >= 0) {
+      out[36 - stride] = (char)separator;
+      out[36] = (char)separator;
+    }
+  }
+#endif /* #if defined(__AVX2__) */
+
+  for (; i < n_uuids; i++) {
+    __m128i x = _mm_loadu_si128((const __m128i *)&uuids[16 * i]);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+    __m128i lo = _mm_and_si128(x, mask);
+    __m128i a = _mm_shuffle_epi8(digits, _mm_unpacklo_epi8(hi, lo));
+    __m128i b = _mm_shuffle_epi8(digits, _mm_unpackhi_epi8(hi, lo));
+
+    char *out = &text_out[stride * i];
+    _mm_storeu_si128((__m128i *)out,
+                     _mm_or_si128(_mm_shuffle_epi8(a, shuf_a0), hyphens0));
+    _mm_storeu_si128((__m128i *)(out + 16),
+                     _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, shuf_a1),
+                                               _mm_shuffle_epi8(b, shuf_b1)),
+                                  hyphens1));
+    int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(b, 12));
+    memcpy(out + 32, &tail, 4);
+    if (separator >= 0) {
+      out[36] = (char)separator;
+    }
+  }
+#elif !defined(UUIDV7_NO_SIMD) && defined(__SSE2__)
+  // without byte shuffles, convert nibbles to digits arithmetically and then
+  // copy the digit groups into place
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  const __m128i nine = _mm_set1_epi8(9);
+  const __m128i zero = _mm_set1_epi8('0');
+  const __m128i alpha = _mm_set1_epi8('a' - '0' - 10);
+  for (; i < n_uuids; i++) {
+    __m128i x = _mm_loadu_si128((const __m128i *)&uuids[16 * i]);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+    __m128i lo = _mm_and_si128(x, mask);
+    __m128i a = _mm_unpacklo_epi8(hi, lo);
+    __m128i b = _mm_unpackhi_epi8(hi, lo);
+    a = _mm_add_epi8(_mm_add_epi8(a, zero),
+                     _mm_and_si128(_mm_cmpgt_epi8(a, nine), alpha));
+    b = _mm_add_epi8(_mm_add_epi8(b, zero),
+                     _mm_and_si128(_mm_cmpgt_epi8(b, nine), alpha));
+
+    char hex[32];
+    _mm_storeu_si128((__m128i *)hex, a);
+    _mm_storeu_si128((__m128i *)(hex + 16), b);
+
+    char *out = &text_out[stride * i];
+    memcpy(out, hex, 8);
+    out[8] = '-';
+    memcpy(out + 9, hex + 8, 4);
+    out[13] = '-';
+    memcpy(out + 14, hex + 12, 4);
+    out[18] = '-';
+    memcpy(out + 19, hex + 16, 4);
+    out[23] = '-';
+    memcpy(out + 24, hex + 20, 12);
+    if (separator >= 0) {
+      out[36] = (char)separator;
+    }
+  }
+#endif
+
+  static const char DIGITS[] = "0123456789abcdef";
+  static const uint8_t POSITIONS[] = {0,  2,  4,  6,  9,  11, 14, 16,
+                                      19, 21, 24, 26, 28, 30, 32, 34};
+  for (; i < n_uuids; i++) {
+    const uint8_t *uuid = &uuids[16 * i];
+    char *out = &text_out[stride * i];
+    for (int j = 0; j < 16; j++) {
+      out[POSITIONS[j]] = DIGITS[uuid[j] >> 4];
+      out[POSITIONS[j] + 1] = DIGITS[uuid[j] & 15];
+    }
+    out[8] = out[13] = out[18] = out[23] = '-';
+    if (separator >= 0) {
+      out[36] = (char)separator;
+    }
+  }
+
+  return stride * n_uuids;
+}
+
+/**
+ * Decodes an array of UUIDs in the 8-4-4-4-12 hexadecimal string
+ * representation.
+ *
+ * This function reads the strings at a fixed stride, as written by
+ * `uuidv7_to_string_bulk()`, and validates each of them in the same manner as
+ * `uuidv7_from_string()`: each string must consist of 32 hexadecimal digits
+ * in either case and four hyphens at the fixed positions, followed by the
+ * separator. It uses SSSE3 instructions if the compiler targets them, unless
+ * `UUIDV7_NO_SIMD` is defined.
+ *
+ * @param text       Character array of `36 * n_uuids` characters without
+ *                   separators or `37 * n_uuids` characters with separators.
+ * @param n_uuids    Number of UUIDs to decode.
+ * @param separator  Character expected after each string, including the last
+ *                   one, such as `'\0'` or `'\n'`, or a negative value to
+ *                   expect no separator.
+ * @param uuids_out  Byte array of `16 * n_uuids` bytes where the decoded UUIDs
+ *                   are stored. The contents for invalid strings are
+ *                   unspecified.
+ * @param failed_out Byte array of `n_uuids` bytes where `1` is stored for each
+ *                   invalid string and `0` for each valid one. This may be
+ *                   NULL.
+ * @return           Number of invalid strings.
+ */
+static inline size_t uuidv7_from_string_bulk(const char *text, size_t n_uuids,
+                                             int separator, uint8_t *uuids_out,
+                                             uint8_t *failed_out) {
+  const size_t stride = separator < 0 ? 36 : 37;
+  size_t n_failed = 0;
+  size_t i = 0;
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSSE3__)
+  // gather the 32 digits into two vectors, validate and convert them to
+  // nibbles, and then combine pairs of nibbles into bytes
+  const __m128i shuf_a0 = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12,
+                                        14, 15, -1, -1);
+  const __m128i shuf_b0 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                        -1, -1, -1, -1, 0, 1);
+  const __m128i shuf_b1 = _mm_setr_epi8(3, 4, 5, 6, -1, -1, -1, -1, -1, -1, -1,
+                                        -1, -1, -1, -1, -1);
+  const __m128i shuf_c1 = _mm_setr_epi8(-1, -1, -1, -1, 4, 5, 6, 7, 8, 9, 10,
+                                        11, 12, 13, 14, 15);
+  const __m128i below_0 = _mm_set1_epi8('0' - 1);
+  const __m128i above_9 = _mm_set1_epi8('9' + 1);
+  const __m128i below_a = _mm_set1_epi8('a' - 1);
+  const __m128i above_f = _mm_set1_epi8('f' + 1);
+  const __m128i to_lower = _mm_set1_epi8(0x20);
+  const __m128i offset_0 = _mm_set1_epi8('0');
+  const __m128i offset_a = _mm_set1_epi8('a' - 10);
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  for (; i < n_uuids; i++) {
+    const char *in = &text[stride * i];
+    __m128i a = _mm_loadu_si128((const __m128i *)in);
+    __m128i b = _mm_loadu_si128((const __m128i *)(in + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(in + 20));
+    __m128i d0 = _mm_or_si128(_mm_shuffle_epi8(a, shuf_a0),
+                              _mm_shuffle_epi8(b, shuf_b0));
+    __m128i d1 = _mm_or_si128(_mm_shuffle_epi8(b, shuf_b1),
+                              _mm_shuffle_epi8(c, shuf_c1));
+
+    __m128i l0 = _mm_or_si128(d0, to_lower);
+    __m128i l1 = _mm_or_si128(d1, to_lower);
+    __m128i is_digit0 = _mm_and_si128(_mm_cmpgt_epi8(d0, below_0),
+                                      _mm_cmplt_epi8(d0, above_9));
+    __m128i is_digit1 = _mm_and_si128(_mm_cmpgt_epi8(d1, below_0),
+                                      _mm_cmplt_epi8(d1, above_9));
+    __m128i is_alpha0 = _mm_and_si128(_mm_cmpgt_epi8(l0, below_a),
+                                      _mm_cmplt_epi8(l0, above_f));
+    __m128i is_alpha1 = _mm_and_si128(_mm_cmpgt_epi8(l1, below_a),
+                                      _mm_cmplt_epi8(l1, above_f));
+    int valid = _mm_movemask_epi8(_mm_and_si128(
+                    _mm_or_si128(is_digit0, is_alpha0),
+                    _mm_or_si128(is_digit1, is_alpha1))) == 0xffff;
+    valid &= in[8] == '-' && in[13] == '-' && in[18] == '-' && in[23] == '-';
+    valid &= separator < 0 || in[36] == (char)separator;
+
+    __m128i n0 = _mm_or_si128(
+        _mm_and_si128(is_digit0, _mm_sub_epi8(d0, offset_0)),
+        _mm_andnot_si128(is_digit0, _mm_sub_epi8(l0, offset_a)));
+    __m128i n1 = _mm_or_si128(
+        _mm_and_si128(is_digit1, _mm_sub_epi8(d1, offset_0)),
+        _mm_andnot_si128(is_digit1, _mm_sub_epi8(l1, offset_a)));
+    _mm_storeu_si128(
+        (__m128i *)&uuids_out[16 * i],
+        _mm_packus_epi16(_mm_maddubs_epi16(n0, weights),
+                         _mm_maddubs_epi16(n1, weights)));
+
+    n_failed += !valid;
+    if (failed_out != NULL) {
+      failed_out[i] = !valid;
+    }
+  }
+#endif
+
+  for (; i < n_uuids; i++) {
+    // all 36 characters are readable, so decode them eight at a time
+    const char *in = &text[stride * i];
+    uuidv7_words_t words = {0, 0};
+    int valid = uuidv7_words_from_string(in, &words) == 0;
+    valid &= separator < 0 || in[36] == (char)separator;
+    uuidv7_words_to_bytes(&words, &uuids_out[16 * i]);
+
+    n_failed += !valid;
+    if (failed_out != NULL) {
+      failed_out[i] = !valid;
+    }
+  }
+
+  return n_failed;
+}
+
+/** @} */
+
+/**
+ * @name Field access
+ *
+ * @{
+ */
+
+/**
+ * Extracts the 48-bit `unix_ts_ms` field of a UUIDv7.
+ *
+ * @param uuid  16-byte byte array representing the UUID.
+ * @return      Unix timestamp in milliseconds.
+ */
+static inline uint64_t uuidv7_get_timestamp(const uint8_t *uuid) {
+  uint64_t timestamp = 0;
+  for (int i = 0; i < 6; i++) {
+    timestamp = (timestamp << 8) | uuid[i];
+  }
+  return timestamp;
+}
+
+/**
+ * Extracts the 42-bit `counter` field of a UUIDv7 generated by this library.
+ *
+ * @param uuid  16-byte byte array representing the UUID.
+ * @return      Counter value, without the `ver` and `var` bits.
+ */
+static inline uint64_t uuidv7_get_counter(const uint8_t *uuid) {
+  uint64_t counter = uuid[6] & 0x0f; // skip ver
+  counter = (counter << 8) | uuid[7];
+  counter = (counter << 6) | (uuid[8] & 0x3f); // skip var
+  counter = (counter << 8) | uuid[9];
+  counter = (counter << 8) | uuid[10];
+  counter = (counter << 8) | uuid[11];
+  return counter;
+}
+
+/**
+ * Stores the smallest UUIDv7 with the given timestamp, which is the inclusive
+ * lower bound of the UUIDv7s generated in that millisecond.
+ *
+ * Together with `uuidv7_max_for_timestamp()`, this gives the byte-order range
+ * `[min(t1), max(t2)]` of the UUIDv7s generated from `t1` to `t2` inclusive.
+ *
+ * @param unix_ts_ms  Unix timestamp in milliseconds (48 bits).
+ * @param uuid_out    16-byte byte array where the UUID is stored.
+ */
+static inline void uuidv7_min_for_timestamp(uint64_t unix_ts_ms,
+                                            uint8_t *uuid_out) {
+  for (int i = 0; i < 6; i++) {
+    uuid_out[i] = (uint8_t)(unix_ts_ms >> (40 - 8 * i));
+  }
+  memset(&uuid_out[6], 0, 10);
+  uuid_out[6] = 0x70;
+  uuid_out[8] = 0x80;
+}
+
+/**
+ * Stores the greatest UUIDv7 with the given timestamp, which is the inclusive
+ * upper bound of the UUIDv7s generated in that millisecond.
+ *
+ * @param unix_ts_ms  Unix timestamp in milliseconds (48 bits).
+ * @param uuid_out    16-byte byte array where the UUID is stored.
+ */
+static inline void uuidv7_max_for_timestamp(uint64_t unix_ts_ms,
+                                            uint8_t *uuid_out) {
+  for (int i = 0; i < 6; i++) {
+    uuid_out[i] = (uint8_t)(unix_ts_ms >> (40 - 8 * i));
+  }
+  memset(&uuid_out[6], 0xff, 10);
+  uuid_out[6] = 0x7f;
+  uuid_out[8] = 0xbf;
+}
+
+/** @} */
+
+/**
+ * @name Validation
+ *
+ * @{
+ */
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__AVX2__)
+/**
+ * Validates two UUIDs held in the 128-bit lanes of `w` as byte-swapped (hi, lo)
+ * word pairs against their predecessors in `p`.
+ *
+ * @return  Two-bit mask of the valid UUIDs.
+ */
+static inline unsigned uuidv7_validate_avx2(__m256i w, __m256i p,
+                                            __m256i min_ts, __m256i max_ts,
+                                            __m256i no_order) {
+  const __m256i ver_var_mask =
+      _mm256_setr_epi64x(0xf000, (int64_t)0xc000000000000000, 0xf000,
+                         (int64_t)0xc000000000000000);
+  const __m256i ver_var =
+      _mm256_setr_epi64x(0x7000, (int64_t)0x8000000000000000, 0x7000,
+                         (int64_t)0x8000000000000000);
+  const __m256i sign = _mm256_set1_epi64x((int64_t)0x8000000000000000);
+
+  __m256i ok =
+      _mm256_cmpeq_epi64(_mm256_and_si256(w, ver_var_mask), ver_var);
+  ok = _mm256_and_si256(ok, _mm256_bsrli_epi128(ok, 8));
+
+  __m256i ts = _mm256_srli_epi64(w, 16);
+  __m256i out_of_range = _mm256_or_si256(_mm256_cmpgt_epi64(min_ts, ts),
+                                         _mm256_cmpgt_epi64(ts, max_ts));
+  ok = _mm256_andnot_si256(out_of_range, ok);
+
+  // (hi, lo) > (prev_hi, prev_lo) as unsigned 128-bit integers
+  __m256i gt = _mm256_cmpgt_epi64(_mm256_xor_si256(w, sign),
+                                  _mm256_xor_si256(p, sign));
+  __m256i eq = _mm256_cmpeq_epi64(w, p);
+  __m256i gt_lo = _mm256_bsrli_epi128(gt, 8);
+  __m256i order = _mm256_or_si256(gt, _mm256_and_si256(eq, gt_lo));
+  ok = _mm256_and_si256(ok, _mm256_or_si256(order, no_order));
+
+  // take the hi word of each lane
+  unsigned bits = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(ok));
+  return (bits & 1) | ((bits >> 1) & 2);
+}
+#endif
+
+/**
+ * Validates an array of binary UUIDs as UUIDv7s and records the result in a
+ * bitmap.
+ *
+ * An entry is valid if it has the version `7` and the variant `0b10`, its
+ * timestamp falls within `[min_timestamp, max_timestamp]`, and, if `ascending`
+ * is non-zero, it is greater in byte order than the preceding entry, whether
+ * that entry is valid or not.
+ *
+ * This function checks four UUIDs at a time with AVX2 instructions if the
+ * compiler targets them (e.g. `-mavx2`), unless `UUIDV7_NO_SIMD` is defined.
+ * Otherwise, it falls back to portable code.
+ *
+ * @param uuids          Byte array of `16 * n_uuids` bytes representing the
+ *                       UUIDs to validate.
+ * @param n_uuids        Number of UUIDs to validate.
+ * @param min_timestamp  Smallest acceptable timestamp, or zero for no limit.
+ * @param max_timestamp  Greatest acceptable timestamp, or `UINT64_MAX` for no
+ *                       limit.
+ * @param ascending      Non-zero to require strictly ascending order.
+ * @param uuid_prev      16-byte byte array representing the entry preceding
+ *                       the array, e.g., the last one of the previous chunk, or
+ *                       NULL if there is none. This is used only if
+ *                       `ascending` is non-zero.
+ * @param bitmap_out     Byte array of `(n_uuids + 7) / 8` bytes where bit
+ *                       `i % 8` of byte `i / 8` is set if entry `i` is valid
+ *                       and cleared otherwise. Unused bits of the last byte
+ *                       are cleared.
+ * @return               Number of invalid entries.
+ */
+static inline size_t uuidv7_validate_bulk(const uint8_t *uuids, size_t n_uuids,
+                                          uint64_t min_timestamp,
+                                          uint64_t max_timestamp,
+                                          int ascending,
+                                          const uint8_t *uuid_prev,
+                                          uint8_t *bitmap_out) {
+  // no UUID precedes the Nil UUID, which itself is not a valid UUIDv7, so it
+  // stands in for a missing predecessor
+  static const uint8_t NIL[16] = {0};
+  const uint8_t *prev = uuid_prev != NULL ? uuid_prev : NIL;
+  size_t n_valid = 0;
+  size_t i = 0;
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__AVX2__)
+  // each 128-bit lane holds one UUID as two big-endian 64-bit words (hi, lo);
+  // timestamps fit in 48 bits, so clamped limits compare correctly as signed
+  const __m256i bswap = _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2,
+      1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  const __m256i min_ts = _mm256_set1_epi64x(
+      (int64_t)(min_timestamp < ((uint64_t)1 << 48) ? min_timestamp
+                                                     : (uint64_t)1 << 48));
+  const __m256i max_ts = _mm256_set1_epi64x(
+      (int64_t)(max_timestamp < ((uint64_t)1 << 48) ? max_timestamp
+                                                     : (uint64_t)1 << 48));
+  const __m256i no_order = _mm256_set1_epi64x(ascending ? 0 : -1);
+
+  // the predecessor of the first UUID sits in the upper lane
+  __m256i last = _mm256_shuffle_epi8(
+      _mm256_inserti128_si256(
+          _mm256_setzero_si256(),
+          _mm_loadu_si128((const __m128i *)prev), 1),
+      bswap);
+
+  for (; i + 8 <= n_uuids; i += 8) {
+    unsigned byte = 0;
+    for (int half = 0; half < 8; half += 4) {
+      const uint8_t *in = &uuids[16 * (i + half)];
+      __m256i w0 = _mm256_shuffle_epi8(
+          _mm256_loadu_si256((const __m256i *)in), bswap);
+      __m256i w1 = _mm256_shuffle_epi8(
+          _mm256_loadu_si256((const __m256i *)(in + 32)), bswap);
+      __m256i p0 = _mm256_permute2x128_si256(last, w0, 0x21);
+      __m256i p1 = _mm256_permute2x128_si256(w0, w1, 0x21);
+      last = w1;
+
+      byte |= uuidv7_validate_avx2(w0, p0, min_ts, max_ts, no_order) << half;
+      byte |= uuidv7_validate_avx2(w1, p1, min_ts, max_ts, no_order)
+              << (half + 2);
+    }
+
+    bitmap_out[i / 8] = (uint8_t)byte;
+    byte = byte - ((byte >> 1) & 0x55);
+    byte = (byte & 0x33) + ((byte >> 2) & 0x33);
+    n_valid += (byte + (byte >> 4)) & 0x0f;
+  }
+  if (i > 0) {
+    prev = &uuids[16 * (i - 1)];
+  }
+#endif
+
+  // compare big-endian words and fill one bitmap byte at a time without
+  // branches
+  uint64_t prev_hi = uuidv7_load_be64(prev);
+  uint64_t prev_lo = uuidv7_load_be64(&prev[8]);
+  for (; i < n_uuids; i += 8) {
+    size_t n = n_uuids - i < 8 ? n_uuids - i : 8;
+    unsigned byte = 0;
+    for (size_t k = 0; k < n; k++) {
+      uint64_t hi = uuidv7_load_be64(&uuids[16 * (i + k)]);
+      uint64_t lo = uuidv7_load_be64(&uuids[16 * (i + k) + 8]);
+      unsigned valid = ((hi & 0xf000) == 0x7000) & (lo >> 62 == 2) &
+                       (hi >> 16 >= min_timestamp) &
+                       (hi >> 16 <= max_timestamp) &
+                       (!ascending | (hi > prev_hi) |
+                        ((hi == prev_hi) & (lo > prev_lo)));
+      prev_hi = hi;
+      prev_lo = lo;
+      byte |= valid << k;
+      n_valid += valid;
+    }
+    bitmap_out[i / 8] = (uint8_t)byte;
+  }
+
+  return n_uuids - n_valid;
+}
+
+/**
+ * Decodes an array of UUIDs in the 8-4-4-4-12 hexadecimal string representation
+ * and validates them as UUIDv7s.
+ *
+ * This function combines `uuidv7_from_string_bulk()` and
+ * `uuidv7_validate_bulk()`: an entry is valid if the string is well-formed and
+ * the decoded UUID passes the checks of `uuidv7_validate_bulk()`. A malformed
+ * string is decoded as the Nil UUID, so the order check of the next entry
+ * compares it with zero.
+ *
+ * @param text           Character array of `36 * n_uuids` characters without
+ *                       separators or `37 * n_uuids` characters with
+ *                       separators.
+ * @param n_uuids        Number of UUIDs to decode.
+ * @param separator      Character expected after each string, or a negative
+ *                       value to expect no separator, as in
+ *                       `uuidv7_from_string_bulk()`.
+ * @param min_timestamp  Smallest acceptable timestamp, or zero for no limit.
+ * @param max_timestamp  Greatest acceptable timestamp, or `UINT64_MAX` for no
+ *                       limit.
+ * @param ascending      Non-zero to require strictly ascending order.
+ * @param uuid_prev      16-byte byte array representing the entry preceding
+ *                       the array, or NULL if there is none.
+ * @param uuids_out      Byte array of `16 * n_uuids` bytes where the decoded
+ *                       UUIDs are stored.
+ * @param bitmap_out     Byte array of `(n_uuids + 7) / 8` bytes where the
+ *                       validity of each entry is stored in the same manner as
+ *                       `uuidv7_validate_bulk()`.
+ * @return               Number of invalid entries.
+ */
+static inline size_t uuidv7_validate_string_bulk(
+    const char *text, size_t n_uuids, int separator, uint64_t min_timestamp,
+    uint64_t max_timestamp, int ascending, const uint8_t *uuid_prev,
+    uint8_t *uuids_out, uint8_t *bitmap_out) {
+  const size_t stride = separator < 0 ? 36 : 37;
+  size_t n_invalid = 0;
+
+  // decode and validate chunks small enough for the stack, each of which
+  // fills whole bitmap bytes
+  for (size_t i = 0; i < n_uuids; i += 64) {
+    size_t n = n_uuids - i < 64 ? n_uuids - i : 64;
+    uint8_t *uuids = &uuids_out[16 * i];
+    uint8_t failed[64];
+    if (uuidv7_from_string_bulk(&text[stride * i], n, separator, uuids,
+                                failed) > 0) {
+      for (size_t j = 0; j < n; j++) {
+        if (failed[j]) {
+          memset(&uuids[16 * j], 0, 16);
+        }
+      }
+    }
+
+    const uint8_t *prev = i > 0 ? &uuids_out[16 * (i - 1)] : uuid_prev;
+    n_invalid += uuidv7_validate_bulk(uuids, n, min_timestamp, max_timestamp,
+                                      ascending, prev, &bitmap_out[i / 8]);
+  }
+  return n_invalid;
+}
+
+/** @} */
+
+/**
+ * @name Stateful generator
+ *
+ * @{
+ */
+
+/**
+ * Generator state that keeps the previous timestamp and counter as integers.
+ *
+ * `uuidv7_gen_next()` produces the same UUIDs as `uuidv7_generate()` does when
+ * the previous output is passed as `uuid_prev`, but it does not need to decode
+ * the previous UUID from bytes on every call; bench/bench_core.c measures it at
+ * a half to a third of the time per UUID. The members may be read directly but
+ * should be modified only through the `uuidv7_gen_*()` functions.
+ */
+typedef struct {
+  /** Timestamp of the previous UUID. */
+  uint64_t timestamp;
+
+  /** Counter of the previous UUID. */
+  uint64_t counter;
+
+  /** Non-zero if `timestamp` and `counter` hold a previous UUID. */
+  int has_prev;
+
+  /** Cursor pointing to the next random byte to consume. */
+  const uint8_t *rand_bytes;
+
+  /** Number of random bytes remaining after the cursor. */
+  size_t n_rand_bytes;
+
+  /** Number of high counter bits reserved for the node ID, zero by default. */
+  int node_bits;
+
+  /** Node ID shifted to the reserved counter bits. */
+  uint64_t node_prefix;
+} uuidv7_gen_t;
+
+/**
+ * Initializes a generator.
+ *
+ * @param gen        Generator to initialize.
+ * @param uuid_prev  16-byte byte array representing the immediately preceding
+ *                   UUID, from which the previous timestamp and counter are
+ *                   extracted, or NULL if there is none.
+ */
+static inline void uuidv7_gen_init(uuidv7_gen_t *gen,
+                                   const uint8_t *uuid_prev) {
+  gen->timestamp = 0;
+  gen->counter = 0;
+  gen->has_prev = uuid_prev != NULL;
+  gen->rand_bytes = NULL;
+  gen->n_rand_bytes = 0;
+  gen->node_bits = 0;
+  gen->node_prefix = 0;
+  if (uuid_prev != NULL) {
+    gen->timestamp = uuidv7_get_timestamp(uuid_prev);
+    gen->counter = uuidv7_get_counter(uuid_prev);
+  }
+}
+
+/**
+ * Sets the buffer of random bytes from which a generator consumes.
+ *
+ * The generator reads the buffer directly, so the buffer must remain valid and
+ * unchanged until the generator consumes it up or another buffer is set.
+ *
+ * @param gen           Generator.
+ * @param rand_bytes    Byte array filled with random bytes.
+ * @param n_rand_bytes  Length of `rand_bytes`.
+ */
+static inline void uuidv7_gen_set_rand(uuidv7_gen_t *gen,
+                                       const uint8_t *rand_bytes,
+                                       size_t n_rand_bytes) {
+  gen->rand_bytes = rand_bytes;
+  gen->n_rand_bytes = n_rand_bytes;
+}
+
+/**
+ * Reserves the high bits of the counter of a generator for a node ID.
+ *
+ * Generators on different nodes, such as hosts or processes writing to the same
+ * table, never produce the same UUID if they have distinct node IDs of the same
+ * width, because the UUIDs differ in the reserved bits, with no coordination
+ * but the assignment of the IDs. The remaining `42 - node_bits` bits of the
+ * counter work in the same manner as the whole counter does by default: they
+ * are reset to random bits at each new timestamp and incremented within a
+ * millisecond, and their overflow increments the timestamp
+ * (`UUIDV7_STATUS_TIMESTAMP_INC`). A generator thus produces at least
+ * `2^(42 - node_bits - 1)` UUIDs per millisecond on average before it runs
+ * ahead of the clock. The random bytes consumed per UUID do not change.
+ *
+ * The UUIDs of each node are monotonically ordered, while those of different
+ * nodes interleave by timestamp and then by node ID within a millisecond. If
+ * the previous UUID of the generator carries another node ID, the next UUID
+ * within the same millisecond advances the timestamp as at a counter overflow,
+ * so that it is still greater than the previous one.
+ *
+ * @param gen        Generator.
+ * @param node_id    Node ID, which must be less than `2^node_bits`.
+ * @param node_bits  Number of counter bits for the node ID, from 0 to 41.
+ *                   Zero restores the default behavior.
+ * @return           Zero on success or non-zero integer if the arguments are
+ *                   out of range, in which case the generator is unchanged.
+ */
+static inline int uuidv7_gen_set_node(uuidv7_gen_t *gen, uint64_t node_id,
+                                      int node_bits) {
+  if (node_bits < 0 || node_bits > 41 || node_id >> node_bits != 0) {
+    return -1;
+  }
+  gen->node_bits = node_bits;
+  gen->node_prefix = node_bits > 0 ? node_id << (42 - node_bits) : 0;
+
+  uint64_t local_max = (((uint64_t)1 << 42) - 1) >> node_bits;
+  if (gen->has_prev && (gen->counter & ~local_max) != gen->node_prefix) {
+    gen->counter = gen->node_prefix | local_max; // force TIMESTAMP_INC
+  }
+  return 0;
+}
+
+/**
+ * Extracts the node ID from a UUIDv7 generated with `uuidv7_gen_set_node()`.
+ *
+ * @param uuid       16-byte byte array representing the UUIDv7.
+ * @param node_bits  Number of counter bits reserved for the node ID.
+ * @return           Node ID, or zero if `node_bits` is zero.
+ */
+static inline uint64_t uuidv7_get_node(const uint8_t *uuid, int node_bits) {
+  return node_bits > 0 ? uuidv7_get_counter(uuid) >> (42 - node_bits) : 0;
+}
+
+/**
+ * Generates a new UUIDv7 from the given Unix time, random bytes remaining in a
+ * generator, and previous state of the generator.
+ *
+ * @param gen         Generator, which is updated to hold the generated UUID as
+ *                    the previous one.
+ * @param unix_ts_ms  Current Unix time in milliseconds.
+ * @param uuid_out    16-byte byte array where the generated UUID is stored.
+ * @return            One of the `UUIDV7_STATUS_*` codes that
+ *                    `uuidv7_generate()` returns, or
+ *                    `UUIDV7_STATUS_ERR_RAND_SHORTAGE` if fewer random bytes
+ *                    remain than required. The generator is left
+ *                    unchanged on error. Keeping 10 or more bytes available
+ *                    before each call avoids the shortage.
+ */
+static inline int8_t uuidv7_gen_next(uuidv7_gen_t *gen, uint64_t unix_ts_ms,
+                                     uint8_t *uuid_out) {
+  static const uint64_t MAX_TIMESTAMP = ((uint64_t)1 << 48) - 1;
+
+  if (unix_ts_ms > MAX_TIMESTAMP) {
+    return UUIDV7_STATUS_ERR_TIMESTAMP;
+  }
+
+  // counter bits below the node ID, which are all of them by default
+  const uint64_t local_max = (((uint64_t)1 << 42) - 1) >> gen->node_bits;
+
+  int8_t status;
+  uint64_t timestamp = gen->timestamp, counter = gen->counter;
+  if (!gen->has_prev) {
+    status = UUIDV7_STATUS_UNPRECEDENTED;
+    timestamp = unix_ts_ms;
+  } else if (unix_ts_ms > timestamp) {
+    status = UUIDV7_STATUS_NEW_TIMESTAMP;
+    timestamp = unix_ts_ms;
+  } else if (unix_ts_ms + 10000 < timestamp) {
+    // ignore prev if clock moves back by more than ten seconds
+    status = UUIDV7_STATUS_CLOCK_ROLLBACK;
+    timestamp = unix_ts_ms;
+  } else if (counter < (gen->node_prefix | local_max)) {
+    status = UUIDV7_STATUS_COUNTER_INC;
+    counter++;
+  } else if (timestamp < MAX_TIMESTAMP) {
+    // increment prev timestamp at counter overflow
+    status = UUIDV7_STATUS_TIMESTAMP_INC;
+    timestamp++;
+  } else {
+    return UUIDV7_STATUS_ERR_TIMESTAMP_OVERFLOW;
+  }
+
+  const uint8_t *rand = gen->rand_bytes;
+  size_t n_rand = status == UUIDV7_STATUS_COUNTER_INC ? 4 : 10;
+  if (n_rand > gen->n_rand_bytes) {
+    return UUIDV7_STATUS_ERR_RAND_SHORTAGE;
+  }
+  gen->rand_bytes += n_rand;
+  gen->n_rand_bytes -= n_rand;
+
+  if (status != UUIDV7_STATUS_COUNTER_INC) {
+    // reset counter to the random bytes that fill its bit positions
+    counter = rand[0] & 0x0f; // skip ver
+    counter = (counter << 8) | rand[1];
+    counter = (counter << 6) | (rand[2] & 0x3f); // skip var
+    counter = (counter << 8) | rand[3];
+    counter = (counter << 8) | rand[4];
+    counter = (counter << 8) | rand[5];
+    counter = gen->node_prefix | (counter & local_max);
+    rand += 6;
+  }
+
+  gen->timestamp = timestamp;
+  gen->counter = counter;
+  gen->has_prev = 1;
+
+  // store whole words; GCC otherwise assembles the 16 byte stores in a vector
+  // register through the stack, which doubles the cost
+  const uint64_t tail = uuidv7_load_be32(rand);
+  uuidv7_store_be64(timestamp << 16 | 0x7000 | counter >> 30, uuid_out);
+  uuidv7_store_be64((uint64_t)0x8 << 60 | (counter & 0x3fffffff) << 32 | tail,
+                    &uuid_out[8]);
+  return status;
+}
+
+/**
+ * Generates an 8-4-4-4-12 hexadecimal string representation of new UUIDv7 with
+ * a generator.
+ *
+ * @param gen         Generator.
+ * @param unix_ts_ms  Current Unix time in milliseconds.
+ * @param string_out  Character array where the encoded string is stored. Its
+ *                    length must be 37 (36 digits + NUL) or longer. Nothing is
+ *                    stored on error.
+ * @return            Return value of `uuidv7_gen_next()`.
+ */
+static inline int8_t uuidv7_gen_next_string(uuidv7_gen_t *gen,
+                                            uint64_t unix_ts_ms,
+                                            char *string_out) {
+  uint8_t uuid[16];
+  int8_t status = uuidv7_gen_next(gen, unix_ts_ms, uuid);
+  if (status >= 0) {
+    uuidv7_to_string(uuid, string_out);
+  }
+  return status;
+}
+
+/** Summary of a batch generated by `uuidv7_generate_batch()`. */
+typedef struct {
+  /** Number of UUIDs stored in the output array. */
+  size_t n_generated;
+
+  /** Number of random bytes consumed from the input buffer. */
+  size_t n_rand_consumed;
+
+  /** Number of UUIDs generated with `UUIDV7_STATUS_TIMESTAMP_INC`. */
+  size_t n_timestamp_inc;
+
+  /** Number of UUIDs generated with `UUIDV7_STATUS_CLOCK_ROLLBACK`. */
+  size_t n_clock_rollback;
+} uuidv7_batch_t;
+
+/**
+ * Generates multiple UUIDv7s at once from the given Unix time, random bytes,
+ * and previous UUID.
+ *
+ * This function produces the same byte sequence as calling `uuidv7_generate()`
+ * in a loop that passes the same `unix_ts_ms` each time and feeds each output
+ * back as the next `uuid_prev`, but it decodes the previous timestamp and
+ * counter only once per batch by means of `uuidv7_gen_t`.
+ *
+ * @param uuids_out     Byte array of `16 * n_uuids` bytes where the generated
+ *                      UUIDs are stored one after another.
+ * @param n_uuids       Number of UUIDs to generate.
+ * @param unix_ts_ms    Current Unix time in milliseconds.
+ * @param rand_bytes    Byte array filled with random bytes. Each UUID consumes
+ *                      4 or 10 bytes in the same manner as `uuidv7_generate()`.
+ * @param n_rand_bytes  Length of `rand_bytes`. The batch stops early if the
+ *                      remaining bytes are insufficient for the next UUID.
+ *                      `10 * n_uuids` bytes are always sufficient.
+ * @param uuid_prev     16-byte byte array representing the UUID immediately
+ *                      preceding the batch, or NULL. This may point to any of
+ *                      the 16-byte slots in `uuids_out`; this function reads
+ *                      the value before writing.
+ * @param result_out    Pointer to a struct where the number of UUIDs generated
+ *                      and random bytes consumed are reported, along with the
+ *                      number of timestamp increments and clock rollbacks that
+ *                      took place in the batch. This may be NULL.
+ * @return              `UUIDV7_STATUS_*` code that `uuidv7_generate()` returns
+ *                      for the first UUID of the batch, or an error code if the
+ *                      batch stopped because of an error. On error, the UUIDs
+ *                      generated before the error are still valid. Running out
+ *                      of random bytes is not an error unless no UUID is
+ *                      generated, in which case this function returns
+ *                      `UUIDV7_STATUS_ERR_RAND_SHORTAGE`. An empty batch of
+ *                      zero UUIDs is not an error either and returns
+ *                      `UUIDV7_STATUS_UNPRECEDENTED`.
+ */
+static inline int8_t uuidv7_generate_batch(uint8_t *uuids_out, size_t n_uuids,
+                                           uint64_t unix_ts_ms,
+                                           const uint8_t *rand_bytes,
+                                           size_t n_rand_bytes,
+                                           const uint8_t *uuid_prev,
+                                           uuidv7_batch_t *result_out) {
+  uuidv7_batch_t result = {0, 0, 0, 0};
+  int8_t first_status = n_uuids > 0 ? UUIDV7_STATUS_ERR_RAND_SHORTAGE
+                                    : UUIDV7_STATUS_UNPRECEDENTED;
+
+  uuidv7_gen_t gen;
+  uuidv7_gen_init(&gen, uuid_prev);
+  uuidv7_gen_set_rand(&gen, rand_bytes, n_rand_bytes);
+  for (size_t i = 0; i < n_uuids; i++) {
+    int8_t status = uuidv7_gen_next(&gen, unix_ts_ms, &uuids_out[16 * i]);
+    if (status == UUIDV7_STATUS_ERR_RAND_SHORTAGE) {
+      break;
+    } else if (i == 0 || status < 0) {
+      first_status = status;
+      if (status < 0) {
+        break;
+      }
+    }
+
+    result.n_generated++;
+    if (status == UUIDV7_STATUS_TIMESTAMP_INC) {
+      result.n_timestamp_inc++;
+    } else if (status == UUIDV7_STATUS_CLOCK_ROLLBACK) {
+      result.n_clock_rollback++;
+    }
+  }
+  result.n_rand_consumed = n_rand_bytes - gen.n_rand_bytes;
+
+  if (result_out != NULL) {
+    *result_out = result;
+  }
+  return first_status;
+}
+
+/** @} */
+
 /**
  * @name High-level APIs that require platform integration
  *
@@ -0,0 +1,534 @@
+/**
+ * @file
+ *
+ * uuidv7.hpp - C++17 value type for uuidv7.h
+ *
+ * This optional header wraps the 16-byte representation of uuidv7.h in a
+ * trivially copyable `uuidv7::uuid` class that holds the UUID as two 64-bit
+ * words in big-endian order, so that comparisons are two integer comparisons
+ * and the natural order of objects equals the byte order of UUIDs. It also
+ * provides a constexpr string parser, `std::hash` and `std::formatter`
+ * specializations, stream output that does not allocate, and
+ * `basic_generator`, a generator whose field layout and policies are fixed at
+ * compile time.
+ *
+ * @copyright Licensed under the Apache License, Version 2.0
+ * @see       https://github.com/LiosK/uuidv7-h
+ */
+/*
+ * Copyright 2022 LiosK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UUIDV7_HPP_BAEDKYFQ
+#define UUIDV7_HPP_BAEDKYFQ
+
+#include "uuidv7.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+namespace uuidv7 {
+
+/** UUID stored as two 64-bit words in big-endian order. */
+class uuid {
+ public:
+  /** Creates the nil UUID. */
+  constexpr uuid() noexcept : hi_(0), lo_(0) {}
+
+  /**
+   * Creates a UUID from two 64-bit words.
+   *
+   * @param hi  Most significant 64 bits (bytes 0-7 in big-endian order).
+   * @param lo  Least significant 64 bits (bytes 8-15 in big-endian order).
+   */
+  constexpr uuid(std::uint64_t hi, std::uint64_t lo) noexcept
+      : hi_(hi), lo_(lo) {}
+
+  /**
+   * Creates a UUID from the 16-byte representation used by uuidv7.h.
+   *
+   * @param bytes  16-byte byte array representing a UUID.
+   */
+  static constexpr uuid from_bytes(const std::uint8_t *bytes) noexcept {
+    std::uint64_t hi = 0, lo = 0;
+    for (int i = 0; i < 8; i++) {
+      hi = (hi << 8) | bytes[i];
+      lo = (lo << 8) | bytes[8 + i];
+    }
+    return uuid(hi, lo);
+  }
+
+  /**
+   * Stores the 16-byte representation used by uuidv7.h.
+   *
+   * @param bytes_out  16-byte byte array where the UUID is stored.
+   */
+  constexpr void to_bytes(std::uint8_t *bytes_out) const noexcept {
+    for (int i = 0; i < 8; i++) {
+      bytes_out[i] = static_cast<std::uint8_t>(hi_ >> (56 - 8 * i));
+      bytes_out[8 + i] = static_cast<std::uint8_t>(lo_ >> (56 - 8 * i));
+    }
+  }
+
+  /**
+   * Parses the 8-4-4-4-12 hexadecimal string representation of a UUID.
+   *
+   * This function accepts the same strings as `uuidv7_from_string()` (except
+   * that `text` is not NUL-terminated) and can be evaluated at compile time.
+   *
+   * @param text  36-character string. Both upper and lower case are accepted.
+   * @return      Parsed UUID, or `std::nullopt` if `text` is invalid.
+   */
+  static constexpr std::optional<uuid> parse(std::string_view text) noexcept {
+    if (text.size() != 36) {
+      return std::nullopt;
+    }
+    std::uint64_t words[2] = {0, 0};
+    int n_digits = 0;
+    for (std::size_t i = 0; i < 36; i++) {
+      if (i == 8 || i == 13 || i == 18 || i == 23) {
+        if (text[i] != '-') {
+          return std::nullopt;
+        }
+        continue;
+      }
+      int v = decode_hex_digit(text[i]);
+      if (v < 0) {
+        return std::nullopt;
+      }
+      std::uint64_t &w = words[n_digits++ / 16];
+      w = (w << 4) | static_cast<std::uint64_t>(v);
+    }
+    return uuid(words[0], words[1]);
+  }
+
+  /** Returns the most significant 64 bits. */
+  constexpr std::uint64_t hi() const noexcept { return hi_; }
+
+  /** Returns the least significant 64 bits. */
+  constexpr std::uint64_t lo() const noexcept { return lo_; }
+
+  /** Returns the 48-bit `unix_ts_ms` field. */
+  constexpr std::uint64_t timestamp() const noexcept { return hi_ >> 16; }
+
+  /** Returns the 42-bit `counter` field. */
+  constexpr std::uint64_t counter() const noexcept {
+    return (hi_ & 0xfff) << 30 | (lo_ >> 32 & 0x3fffffff);
+  }
+
+  /** Returns the 32-bit `rand` field that follows the counter. */
+  constexpr std::uint32_t rand() const noexcept {
+    return static_cast<std::uint32_t>(lo_);
+  }
+
+  /** Returns the 4-bit `ver` field. */
+  constexpr unsigned version() const noexcept {
+    return static_cast<unsigned>(hi_ >> 12 & 0xf);
+  }
+
+  /** Returns the 2-bit `var` field. */
+  constexpr unsigned variant() const noexcept {
+    return static_cast<unsigned>(lo_ >> 62);
+  }
+
+  /**
+   * Writes the 8-4-4-4-12 hexadecimal string representation.
+   *
+   * @param out  Character array of 36 or more characters. No NUL is written.
+   * @return     Pointer to the character following the last one written.
+   */
+  char *to_chars(char *out) const noexcept {
+    std::uint8_t bytes[16];
+    to_bytes(bytes);
+    return out + uuidv7_to_string_bulk(bytes, 1, out, -1);
+  }
+
+  /** Returns the 8-4-4-4-12 hexadecimal string representation. */
+  std::string to_string() const {
+    char text[36];
+    return std::string(text, to_chars(text));
+  }
+
+  friend constexpr bool operator==(const uuid &a, const uuid &b) noexcept {
+    return a.hi_ == b.hi_ && a.lo_ == b.lo_;
+  }
+  friend constexpr bool operator!=(const uuid &a, const uuid &b) noexcept {
+    return !(a == b);
+  }
+  friend constexpr bool operator<(const uuid &a, const uuid &b) noexcept {
+    return a.hi_ < b.hi_ || (a.hi_ == b.hi_ && a.lo_ < b.lo_);
+  }
+  friend constexpr bool operator>(const uuid &a, const uuid &b) noexcept {
+    return b < a;
+  }
+  friend constexpr bool operator<=(const uuid &a, const uuid &b) noexcept {
+    return !(b < a);
+  }
+  friend constexpr bool operator>=(const uuid &a, const uuid &b) noexcept {
+    return !(a < b);
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const uuid &u) {
+    char text[36];
+    return os.write(text, u.to_chars(text) - text);
+  }
+
+ private:
+  static constexpr int decode_hex_digit(char c) noexcept {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  }
+
+  std::uint64_t hi_;
+  std::uint64_t lo_;
+};
+
+namespace literals {
+
+/**
+ * Parses a UUID literal such as `"017f22e2-79b0-7cc3-98c4-dc0c0c07398f"_uuid`.
+ *
+ * @throw std::invalid_argument if the string is invalid, which makes an
+ *        invalid literal a compile error in constant expressions.
+ */
+constexpr uuid operator""_uuid(const char *text, std::size_t len) {
+  std::optional<uuid> u = uuid::parse(std::string_view(text, len));
+  if (!u) {
+    throw std::invalid_argument("invalid UUID string");
+  }
+  return *u;
+}
+
+} // namespace literals
+
+/** Clock policy that reads `std::chrono::system_clock`. */
+struct system_clock {
+  /** Returns the current Unix time in milliseconds. */
+  std::uint64_t now_ms() const noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+  }
+};
+
+/**
+ * Randomness policy that consumes a caller-supplied buffer in the same manner
+ * as a loop over `uuidv7_generate()` does.
+ */
+class buffer_rand {
+ public:
+  /**
+   * @param bytes  Byte array filled with random bytes, which must remain valid
+   *               while the policy is used.
+   * @param len    Length of `bytes`.
+   */
+  buffer_rand(const std::uint8_t *bytes, std::size_t len) noexcept
+      : bytes_(bytes), len_(len) {}
+
+  /**
+   * Consumes random bytes.
+   *
+   * @param n  Number of bytes to consume.
+   * @return   Pointer to `n` random bytes, or NULL if fewer bytes remain.
+   */
+  const std::uint8_t *take(std::size_t n) noexcept {
+    if (n > len_) {
+      return nullptr;
+    }
+    const std::uint8_t *p = bytes_;
+    bytes_ += n;
+    len_ -= n;
+    return p;
+  }
+
+ private:
+  const std::uint8_t *bytes_;
+  std::size_t len_;
+};
+
+/**
+ * Randomness policy that buffers the output of `std::random_device`, which is
+ * a cryptographically secure source on the major platforms.
+ */
+class random_device_rand {
+ public:
+  random_device_rand() : pos_(sizeof(buffer_)) {}
+
+  /** @copydoc buffer_rand::take() */
+  const std::uint8_t *take(std::size_t n) {
+    if (n > sizeof(buffer_)) {
+      return nullptr;
+    }
+    if (n > sizeof(buffer_) - pos_) {
+      for (std::size_t i = 0; i < sizeof(buffer_); i += 4) {
+        std::uint32_t x = device_();
+        for (int j = 0; j < 4; j++) {
+          buffer_[i + j] = static_cast<std::uint8_t>(x >> (8 * j));
+        }
+      }
+      pos_ = 0;
+    }
+    pos_ += n;
+    return &buffer_[pos_ - n];
+  }
+
+ private:
+  std::random_device device_;
+  std::size_t pos_;
+  std::uint8_t buffer_[256];
+};
+
+/**
+ * UUIDv7 generator whose field layout and policies are fixed at compile time.
+ *
+ * The 74 bits that follow the timestamp, excluding the `ver` and `var` bits,
+ * hold a `CounterBits`-bit counter followed by random bits. A new timestamp
+ * resets the whole field from 10 random bytes, and a counter increment
+ * refreshes the random bits below the counter, which takes
+ * `(74 - CounterBits + 7) / 8` bytes. A clock that moves back by more than
+ * `RollbackWindowMs` resets the generator; smaller rollbacks are absorbed by
+ * incrementing the counter, and zero rejects every rollback.
+ *
+ * The default `CounterBits` and `RollbackWindowMs` reproduce
+ * `uuidv7_generate()`: given the same timestamps and random byte stream, both
+ * produce the same UUIDs and status codes and consume the same random bytes.
+ * Since all of these parameters are constants, the compiler removes the
+ * arithmetic for the unused layouts.
+ *
+ * @tparam Clock             Type with `std::uint64_t now_ms()` that returns
+ *                           the current Unix time in milliseconds.
+ * @tparam Rand              Type with `const std::uint8_t *take(std::size_t)`
+ *                           that consumes random bytes, as `buffer_rand`.
+ * @tparam CounterBits       Width of the counter, from 1 to 42.
+ * @tparam RollbackWindowMs  Greatest clock rollback absorbed by the counter.
+ */
+template <class Clock, class Rand, unsigned CounterBits = 42,
+          std::uint64_t RollbackWindowMs = 10000>
+class basic_generator {
+  static_assert(CounterBits >= 1 && CounterBits <= 42,
+                "counter must be 1 to 42 bits wide");
+
+  /** Number of random bits below the counter in the upper 42 bits. */
+  static constexpr unsigned HI_RAND_BITS = 42 - CounterBits;
+
+ public:
+  /** Greatest counter value before a timestamp increment. */
+  static constexpr std::uint64_t MAX_COUNTER =
+      (std::uint64_t{1} << CounterBits) - 1;
+
+  /** Number of random bytes a counter increment consumes. */
+  static constexpr std::size_t N_RAND_COUNTER_INC = (HI_RAND_BITS + 7) / 8 + 4;
+
+  basic_generator() : clock_(), rand_() {}
+
+  basic_generator(Clock clock, Rand rand)
+      : clock_(std::move(clock)), rand_(std::move(rand)) {}
+
+  /**
+   * Generates a new UUIDv7 from the given Unix time.
+   *
+   * @param unix_ts_ms  Current Unix time in milliseconds.
+   * @param uuid_out    16-byte byte array where the generated UUID is stored.
+   * @return            One of the `UUIDV7_STATUS_*` codes that
+   *                    `uuidv7_generate()` returns, or
+   *                    `UUIDV7_STATUS_ERR_RAND_SHORTAGE` if the randomness
+   *                    policy fails. The generator is left unchanged on error.
+   */
+  std::int8_t generate(std::uint64_t unix_ts_ms, std::uint8_t *uuid_out) {
+    constexpr std::uint64_t MAX_TIMESTAMP = (std::uint64_t{1} << 48) - 1;
+    if (unix_ts_ms > MAX_TIMESTAMP) {
+      return UUIDV7_STATUS_ERR_TIMESTAMP;
+    }
+
+    std::int8_t status;
+    std::uint64_t timestamp = timestamp_, counter = counter_;
+    if (!has_prev_) {
+      status = UUIDV7_STATUS_UNPRECEDENTED;
+      timestamp = unix_ts_ms;
+    } else if (unix_ts_ms > timestamp) {
+      status = UUIDV7_STATUS_NEW_TIMESTAMP;
+      timestamp = unix_ts_ms;
+    } else if (timestamp - unix_ts_ms > RollbackWindowMs) {
+      status = UUIDV7_STATUS_CLOCK_ROLLBACK;
+      timestamp = unix_ts_ms;
+    } else if (counter < MAX_COUNTER) {
+      status = UUIDV7_STATUS_COUNTER_INC;
+      counter++;
+    } else if (timestamp < MAX_TIMESTAMP) {
+      status = UUIDV7_STATUS_TIMESTAMP_INC;
+      timestamp++;
+    } else {
+      return UUIDV7_STATUS_ERR_TIMESTAMP_OVERFLOW;
+    }
+
+    // upper holds the counter and random bits in the bit positions of the
+    // 42-bit counter of uuidv7.h, and lower the 32 bits that follow
+    std::uint64_t upper;
+    const std::uint8_t *rand;
+    if (status == UUIDV7_STATUS_COUNTER_INC) {
+      rand = rand_.take(N_RAND_COUNTER_INC);
+      if (rand == nullptr) {
+        return UUIDV7_STATUS_ERR_RAND_SHORTAGE;
+      }
+      upper = counter << HI_RAND_BITS;
+      if constexpr (HI_RAND_BITS > 0) {
+        std::uint64_t bits = 0;
+        for (unsigned i = 0; i < (HI_RAND_BITS + 7) / 8; i++) {
+          bits = (bits << 8) | *rand++;
+        }
+        upper |= bits & ((std::uint64_t{1} << HI_RAND_BITS) - 1);
+      }
+    } else {
+      rand = rand_.take(10);
+      if (rand == nullptr) {
+        return UUIDV7_STATUS_ERR_RAND_SHORTAGE;
+      }
+      upper = rand[0] & 0x0f; // skip ver
+      upper = (upper << 8) | rand[1];
+      upper = (upper << 6) | (rand[2] & 0x3f); // skip var
+      upper = (upper << 8) | rand[3];
+      upper = (upper << 8) | rand[4];
+      upper = (upper << 8) | rand[5];
+      counter = upper >> HI_RAND_BITS;
+      rand += 6;
+    }
+
+    timestamp_ = timestamp;
+    counter_ = counter;
+    has_prev_ = true;
+
+    const std::uint64_t tail = uuidv7_load_be32(rand);
+    // store whole words; GCC otherwise assembles the 16 byte stores in a
+    // vector register through the stack, which doubles the cost
+    uuidv7_store_be64(timestamp << 16 | 0x7000 | upper >> 30, uuid_out);
+    uuidv7_store_be64(
+        std::uint64_t{0x8} << 60 | (upper & 0x3fffffff) << 32 | tail,
+        uuid_out + 8);
+    return status;
+  }
+
+  /**
+   * Generates a new UUIDv7 from the time of the clock policy.
+   *
+   * @copydetails generate(std::uint64_t, std::uint8_t *)
+   */
+  std::int8_t generate(std::uint8_t *uuid_out) {
+    return generate(clock_.now_ms(), uuid_out);
+  }
+
+  /**
+   * Generates a new UUIDv7 from the time of the clock policy.
+   *
+   * @throw std::runtime_error if the generation fails.
+   */
+  uuid operator()() {
+    std::uint8_t bytes[16];
+    if (generate(bytes) < 0) {
+      throw std::runtime_error("failed to generate UUIDv7");
+    }
+    return uuid::from_bytes(bytes);
+  }
+
+  /** Returns the clock policy. */
+  Clock &clock() noexcept { return clock_; }
+
+  /** Returns the randomness policy. */
+  Rand &rand() noexcept { return rand_; }
+
+ private:
+  Clock clock_;
+  Rand rand_;
+  std::uint64_t timestamp_ = 0;
+  std::uint64_t counter_ = 0;
+  bool has_prev_ = false;
+};
+
+/** Generator with the default layout and policies. */
+using generator = basic_generator<system_clock, random_device_rand>;
+
+} // namespace uuidv7
+
+namespace std {
+
+/**
+ * Hashes a UUID mainly by the counter and random bits, which differ between
+ * UUIDs generated at the same timestamp, rather than by the timestamp prefix.
+ */
+template <>
+struct hash<uuidv7::uuid> {
+  size_t operator()(const uuidv7::uuid &u) const noexcept {
+    uint64_t x = u.lo() ^ (u.hi() << 32 | u.hi() >> 32);
+    x *= 0x9e3779b97f4a7c15;
+    return static_cast<size_t>(x ^ x >> 32);
+  }
+};
+
+} // namespace std
+
+#ifdef __cpp_lib_format
+namespace std {
+
+/** Formats a UUID in the 8-4-4-4-12 representation; takes no format spec. */
+template <>
+struct formatter<uuidv7::uuid, char> {
+  constexpr auto parse(format_parse_context &ctx) {
+    auto it = ctx.begin();
+    if (it != ctx.end() && *it != '}') {
+      throw format_error("invalid format spec for uuidv7::uuid");
+    }
+    return it;
+  }
+
+  template <class FormatContext>
+  auto format(const uuidv7::uuid &u, FormatContext &ctx) const {
+    char text[36];
+    const char *end = u.to_chars(text);
+    auto out = ctx.out();
+    for (const char *p = text; p != end; ++p) {
+      *out++ = *p;
+    }
+    return out;
+  }
+};
+
+} // namespace std
+#endif /* #ifdef __cpp_lib_format */
+
+#endif /* #ifndef UUIDV7_HPP_BAEDKYFQ */
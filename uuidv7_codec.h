@@ -0,0 +1,488 @@
+/**
+ * @file
+ *
+ * uuidv7_codec.h - Compact block encoding of UUIDv7 sequences for uuidv7.h
+ *
+ * This optional header encodes sequences of UUIDv7s, typically in generation
+ * order, into fixed-size blocks that exploit the structure of consecutive
+ * UUIDs: the timestamp is delta-coded, a counter incremented by a small amount
+ * under the same timestamp costs a single token byte, and only the 32-bit
+ * random tail is stored verbatim. A run of `UUIDV7_STATUS_COUNTER_INC` UUIDs
+ * takes 5 bytes per UUID instead of 16.
+ *
+ * Any sequence of 16-byte values round-trips exactly. Timestamps may go back,
+ * as with `UUIDV7_STATUS_CLOCK_ROLLBACK`, or jump with the counter reset, as
+ * with `UUIDV7_STATUS_TIMESTAMP_INC`, and values that lack the UUIDv7 version
+ * and variant bits are stored verbatim.
+ *
+ * Every block is `UUIDV7_CODEC_BLOCK_SIZE` bytes long and starts with a header
+ * that holds the first UUID of the block and the greatest timestamp in it, so
+ * that a reader can locate a block by its offset and find the block covering a
+ * time with a binary search over the headers (see `uuidv7_codec_seek()`).
+ *
+ * Block layout (multi-byte integers are big-endian):
+ *
+ * | Offset | Size | Field                                                |
+ * | ------ | ---- | ---------------------------------------------------- |
+ * | 0      | 4    | Magic `"U7C"` and format version 1                   |
+ * | 4      | 1    | Base-2 logarithm of the block size                   |
+ * | 5      | 1    | Reserved (zero)                                      |
+ * | 6      | 2    | Number of UUIDs in the block                         |
+ * | 8      | 2    | Number of bytes used, including the header           |
+ * | 10     | 6    | Greatest timestamp in the block                      |
+ * | 16     | 16   | First UUID of the block                              |
+ * | 32     | ...  | Records of the following UUIDs, then zero padding    |
+ *
+ * Each record starts with a token byte:
+ *
+ * - `0x00`-`0xef`: same timestamp as the previous UUID, counter incremented by
+ *   the token value plus one, followed by the 4-byte random tail.
+ * - `0xf0`: a zigzag-encoded LEB128 timestamp delta and an LEB128 counter,
+ *   followed by the 4-byte random tail.
+ * - `0xff`: the 16-byte UUID verbatim.
+ *
+ * @copyright Licensed under the Apache License, Version 2.0
+ * @see       https://github.com/LiosK/uuidv7-h
+ */
+/*
+ * Copyright 2022 LiosK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UUIDV7_CODEC_H_BAEDKYFQ
+#define UUIDV7_CODEC_H_BAEDKYFQ
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef UUIDV7_CODEC_BLOCK_SIZE_LOG2
+/**
+ * Base-2 logarithm of the block size, from 6 (64 bytes) to 15 (32 KiB). Writers
+ * and readers must agree on it; readers reject blocks of other sizes.
+ */
+#define UUIDV7_CODEC_BLOCK_SIZE_LOG2 (12)
+#endif
+
+#if UUIDV7_CODEC_BLOCK_SIZE_LOG2 < 6 || UUIDV7_CODEC_BLOCK_SIZE_LOG2 > 15
+#error "UUIDV7_CODEC_BLOCK_SIZE_LOG2 must be between 6 and 15"
+#endif
+
+/** Size of each encoded block in bytes. */
+#define UUIDV7_CODEC_BLOCK_SIZE ((size_t)1 << UUIDV7_CODEC_BLOCK_SIZE_LOG2)
+
+/** Size of the block header in bytes. */
+#define UUIDV7_CODEC_HEADER_SIZE (32)
+
+/** Maximum number of UUIDs in a block, where each record takes 5 bytes. */
+#define UUIDV7_CODEC_MAX_PER_BLOCK                                             \
+  ((UUIDV7_CODEC_BLOCK_SIZE - UUIDV7_CODEC_HEADER_SIZE) / 5 + 1)
+
+/**
+ * Minimum number of UUIDs in a full block, where each record takes the largest
+ * size of 18 bytes: a `0xf0` token, a 7-byte timestamp delta, a 6-byte counter,
+ * and the 4-byte random tail.
+ */
+#define UUIDV7_CODEC_MIN_PER_BLOCK                                             \
+  ((UUIDV7_CODEC_BLOCK_SIZE - UUIDV7_CODEC_HEADER_SIZE) / 18 + 1)
+
+/** Maximum number of blocks that `uuidv7_encode()` produces from `n` UUIDs. */
+#define UUIDV7_CODEC_MAX_BLOCKS(n)                                             \
+  (((n) + UUIDV7_CODEC_MIN_PER_BLOCK - 1) / UUIDV7_CODEC_MIN_PER_BLOCK)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name Field access
+ *
+ * @{
+ */
+
+/**
+ * Splits a UUID into the fields of the UUIDv7 layout.
+ *
+ * @return  Non-zero if the UUID has the version 7 and variant `10` bits, in
+ *          which case the fields represent the whole UUID.
+ */
+static inline int uuidv7_codec_split(const uint8_t *uuid, uint64_t *timestamp,
+                                     uint64_t *counter, uint32_t *rand_tail) {
+  uint64_t t = 0;
+  for (int i = 0; i < 6; i++) {
+    t = (t << 8) | uuid[i];
+  }
+  uint64_t c = uuid[6] & 0x0f; // skip ver
+  c = (c << 8) | uuid[7];
+  c = (c << 6) | (uuid[8] & 0x3f); // skip var
+  c = (c << 8) | uuid[9];
+  c = (c << 8) | uuid[10];
+  c = (c << 8) | uuid[11];
+  *timestamp = t;
+  *counter = c;
+  *rand_tail = (uint32_t)uuid[12] << 24 | (uint32_t)uuid[13] << 16 |
+               (uint32_t)uuid[14] << 8 | uuid[15];
+  return (uuid[6] & 0xf0) == 0x70 && (uuid[8] & 0xc0) == 0x80;
+}
+
+/** Assembles a UUIDv7 from its fields. */
+static inline void uuidv7_codec_join(uint8_t *uuid_out, uint64_t timestamp,
+                                     uint64_t counter, uint32_t rand_tail) {
+  for (int i = 0; i < 6; i++) {
+    uuid_out[i] = (uint8_t)(timestamp >> (40 - 8 * i));
+  }
+  uuid_out[6] = (uint8_t)(0x70 | ((counter >> 38) & 0x0f));
+  uuid_out[7] = (uint8_t)(counter >> 30);
+  uuid_out[8] = (uint8_t)(0x80 | ((counter >> 24) & 0x3f));
+  uuid_out[9] = (uint8_t)(counter >> 16);
+  uuid_out[10] = (uint8_t)(counter >> 8);
+  uuid_out[11] = (uint8_t)counter;
+  for (int i = 0; i < 4; i++) {
+    uuid_out[12 + i] = (uint8_t)(rand_tail >> (24 - 8 * i));
+  }
+}
+
+/** @} */
+
+/**
+ * @name Encoder
+ *
+ * @{
+ */
+
+/** Encoder state for the block being filled. */
+typedef struct {
+  /** Block being filled, of `UUIDV7_CODEC_BLOCK_SIZE` bytes. */
+  uint8_t *block;
+
+  /** Number of bytes used in the block, including the header. */
+  size_t n_bytes;
+
+  /** Number of UUIDs in the block. */
+  size_t n_uuids;
+
+  /** Fields of the previous UUID. */
+  uint64_t timestamp, counter;
+
+  /** Greatest timestamp in the block. */
+  uint64_t max_timestamp;
+} uuidv7_encoder_t;
+
+/**
+ * Starts filling a block.
+ *
+ * @param enc    Encoder.
+ * @param block  Byte array of `UUIDV7_CODEC_BLOCK_SIZE` bytes where the block
+ *               is built.
+ */
+static inline void uuidv7_encoder_begin(uuidv7_encoder_t *enc,
+                                        uint8_t *block) {
+  enc->block = block;
+  enc->n_bytes = UUIDV7_CODEC_HEADER_SIZE;
+  enc->n_uuids = 0;
+  enc->timestamp = 0;
+  enc->counter = 0;
+  enc->max_timestamp = 0;
+}
+
+static inline size_t uuidv7_codec_put_varint(uint8_t *out, uint64_t x) {
+  size_t n = 0;
+  while (x >= 0x80) {
+    out[n++] = (uint8_t)(x | 0x80);
+    x >>= 7;
+  }
+  out[n++] = (uint8_t)x;
+  return n;
+}
+
+/**
+ * Appends a UUID to the block.
+ *
+ * @param enc   Encoder.
+ * @param uuid  16-byte UUID to append.
+ * @return      Zero on success or -1 if the block has no room for the UUID, in
+ *              which case the caller completes the block with
+ *              `uuidv7_encoder_end()` and appends the UUID to a new block.
+ */
+static inline int uuidv7_encoder_put(uuidv7_encoder_t *enc,
+                                     const uint8_t *uuid) {
+  uint64_t timestamp, counter;
+  uint32_t rand_tail;
+  int is_v7 = uuidv7_codec_split(uuid, &timestamp, &counter, &rand_tail);
+
+  if (enc->n_uuids == 0) {
+    memcpy(&enc->block[16], uuid, 16);
+  } else {
+    uint8_t record[1 + 10 + 10 + 4];
+    size_t n = 0;
+    if (!is_v7) {
+      record[n++] = 0xff;
+      memcpy(&record[n], uuid, 16);
+      n += 16;
+    } else {
+      if (timestamp == enc->timestamp && counter > enc->counter &&
+          counter - enc->counter <= 0xf0) {
+        record[n++] = (uint8_t)(counter - enc->counter - 1);
+      } else {
+        uint64_t delta = timestamp - enc->timestamp;
+        uint64_t zigzag = (delta << 1) ^ (0 - (delta >> 63));
+        record[n++] = 0xf0;
+        n += uuidv7_codec_put_varint(&record[n], zigzag);
+        n += uuidv7_codec_put_varint(&record[n], counter);
+      }
+      for (int i = 0; i < 4; i++) {
+        record[n++] = uuid[12 + i];
+      }
+    }
+
+    if (enc->n_bytes + n > UUIDV7_CODEC_BLOCK_SIZE) {
+      return -1;
+    }
+    memcpy(&enc->block[enc->n_bytes], record, n);
+    enc->n_bytes += n;
+  }
+
+  enc->n_uuids++;
+  enc->timestamp = timestamp;
+  enc->counter = counter;
+  if (enc->max_timestamp < timestamp) {
+    enc->max_timestamp = timestamp;
+  }
+  return 0;
+}
+
+/**
+ * Completes the block by writing the header and zero-filling the rest. The
+ * block must contain at least one UUID.
+ *
+ * @param enc  Encoder.
+ */
+static inline void uuidv7_encoder_end(uuidv7_encoder_t *enc) {
+  uint8_t *h = enc->block;
+  h[0] = 'U';
+  h[1] = '7';
+  h[2] = 'C';
+  h[3] = 1;
+  h[4] = UUIDV7_CODEC_BLOCK_SIZE_LOG2;
+  h[5] = 0;
+  h[6] = (uint8_t)(enc->n_uuids >> 8);
+  h[7] = (uint8_t)enc->n_uuids;
+  h[8] = (uint8_t)(enc->n_bytes >> 8);
+  h[9] = (uint8_t)enc->n_bytes;
+  for (int i = 0; i < 6; i++) {
+    h[10 + i] = (uint8_t)(enc->max_timestamp >> (40 - 8 * i));
+  }
+  memset(&enc->block[enc->n_bytes], 0,
+         UUIDV7_CODEC_BLOCK_SIZE - enc->n_bytes);
+}
+
+/**
+ * Encodes an array of UUIDs into consecutive blocks.
+ *
+ * @param uuids       Array of `n_uuids` 16-byte UUIDs.
+ * @param n_uuids     Number of UUIDs.
+ * @param blocks_out  Byte array of `UUIDV7_CODEC_MAX_BLOCKS(n_uuids)` blocks
+ *                    where the encoded blocks are stored.
+ * @return            Number of blocks written.
+ */
+static inline size_t uuidv7_encode(const uint8_t *uuids, size_t n_uuids,
+                                   uint8_t *blocks_out) {
+  if (n_uuids == 0) {
+    return 0;
+  }
+  size_t n_blocks = 0;
+  uuidv7_encoder_t enc;
+  uuidv7_encoder_begin(&enc, blocks_out);
+  for (size_t i = 0; i < n_uuids; i++) {
+    if (uuidv7_encoder_put(&enc, &uuids[16 * i]) != 0) {
+      uuidv7_encoder_end(&enc);
+      n_blocks++;
+      uuidv7_encoder_begin(&enc,
+                           &blocks_out[UUIDV7_CODEC_BLOCK_SIZE * n_blocks]);
+      uuidv7_encoder_put(&enc, &uuids[16 * i]);
+    }
+  }
+  uuidv7_encoder_end(&enc);
+  n_blocks++;
+  return n_blocks;
+}
+
+/** @} */
+
+/**
+ * @name Decoder
+ *
+ * @{
+ */
+
+/** Header fields of a block. */
+typedef struct {
+  /** Number of UUIDs in the block. */
+  size_t n_uuids;
+
+  /** Number of bytes used, including the header. */
+  size_t n_bytes;
+
+  /** Timestamp of the first UUID in the block. */
+  uint64_t first_timestamp;
+
+  /** Greatest timestamp in the block. */
+  uint64_t max_timestamp;
+} uuidv7_codec_header_t;
+
+/**
+ * Reads the header of a block.
+ *
+ * @param block       Block of `UUIDV7_CODEC_BLOCK_SIZE` bytes.
+ * @param header_out  Location where the header fields are stored.
+ * @return            Zero on success or -1 if the header is invalid.
+ */
+static inline int uuidv7_codec_read_header(const uint8_t *block,
+                                           uuidv7_codec_header_t *header_out) {
+  if (block[0] != 'U' || block[1] != '7' || block[2] != 'C' || block[3] != 1 ||
+      block[4] != UUIDV7_CODEC_BLOCK_SIZE_LOG2 || block[5] != 0) {
+    return -1;
+  }
+  header_out->n_uuids = (size_t)block[6] << 8 | block[7];
+  header_out->n_bytes = (size_t)block[8] << 8 | block[9];
+  uint64_t first = 0, max = 0;
+  for (int i = 0; i < 6; i++) {
+    first = (first << 8) | block[16 + i];
+    max = (max << 8) | block[10 + i];
+  }
+  header_out->first_timestamp = first;
+  header_out->max_timestamp = max;
+  if (header_out->n_uuids == 0 ||
+      header_out->n_uuids > UUIDV7_CODEC_MAX_PER_BLOCK ||
+      header_out->n_bytes < UUIDV7_CODEC_HEADER_SIZE ||
+      header_out->n_bytes > UUIDV7_CODEC_BLOCK_SIZE) {
+    return -1;
+  }
+  return 0;
+}
+
+static inline int uuidv7_codec_get_varint(const uint8_t *in, size_t *pos,
+                                          size_t end, uint64_t *x_out) {
+  uint64_t x = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*pos >= end) {
+      return -1;
+    }
+    uint8_t byte = in[(*pos)++];
+    x |= (uint64_t)(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      *x_out = x;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Decodes a block.
+ *
+ * @param block      Block of `UUIDV7_CODEC_BLOCK_SIZE` bytes.
+ * @param uuids_out  Array of `UUIDV7_CODEC_MAX_PER_BLOCK` 16-byte UUIDs where
+ *                   the decoded UUIDs are stored.
+ * @return           Number of UUIDs decoded or -1 if the block is malformed.
+ */
+static inline long uuidv7_decode_block(const uint8_t *block,
+                                       uint8_t *uuids_out) {
+  uuidv7_codec_header_t header;
+  if (uuidv7_codec_read_header(block, &header) != 0) {
+    return -1;
+  }
+
+  uint64_t timestamp, counter;
+  uint32_t rand_tail;
+  memcpy(uuids_out, &block[16], 16);
+  uuidv7_codec_split(uuids_out, &timestamp, &counter, &rand_tail);
+
+  size_t pos = UUIDV7_CODEC_HEADER_SIZE, end = header.n_bytes;
+  for (size_t i = 1; i < header.n_uuids; i++) {
+    uint8_t *out = &uuids_out[16 * i];
+    if (pos >= end) {
+      return -1;
+    }
+    uint8_t token = block[pos++];
+    if (token == 0xff) {
+      if (end - pos < 16) {
+        return -1;
+      }
+      memcpy(out, &block[pos], 16);
+      pos += 16;
+      uuidv7_codec_split(out, &timestamp, &counter, &rand_tail);
+      continue;
+    }
+
+    if (token < 0xf0) {
+      counter += (uint64_t)token + 1;
+    } else if (token == 0xf0) {
+      uint64_t zigzag;
+      if (uuidv7_codec_get_varint(block, &pos, end, &zigzag) != 0 ||
+          uuidv7_codec_get_varint(block, &pos, end, &counter) != 0) {
+        return -1;
+      }
+      timestamp += (zigzag >> 1) ^ (0 - (zigzag & 1));
+    } else {
+      return -1;
+    }
+    if (end - pos < 4 || timestamp >> 48 != 0 || counter >> 42 != 0) {
+      return -1;
+    }
+    rand_tail = (uint32_t)block[pos] << 24 | (uint32_t)block[pos + 1] << 16 |
+                (uint32_t)block[pos + 2] << 8 | block[pos + 3];
+    pos += 4;
+    uuidv7_codec_join(out, timestamp, counter, rand_tail);
+  }
+  return pos == end ? (long)header.n_uuids : -1;
+}
+
+/**
+ * Finds the first block that may contain a UUID with the given timestamp or
+ * later by binary search over the block headers. The result is exact if the
+ * greatest timestamps of the blocks do not decrease, which holds for sequences
+ * without `UUIDV7_STATUS_CLOCK_ROLLBACK`.
+ *
+ * @param blocks      Array of `n_blocks` encoded blocks.
+ * @param n_blocks    Number of blocks.
+ * @param unix_ts_ms  Timestamp to look for.
+ * @return            Index of the first block whose greatest timestamp is
+ *                    equal to or greater than `unix_ts_ms`, or `n_blocks` if
+ *                    there is none. Blocks with invalid headers are treated as
+ *                    preceding any timestamp.
+ */
+static inline size_t uuidv7_codec_seek(const uint8_t *blocks, size_t n_blocks,
+                                       uint64_t unix_ts_ms) {
+  size_t lo = 0, hi = n_blocks;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    uuidv7_codec_header_t header;
+    if (uuidv7_codec_read_header(&blocks[UUIDV7_CODEC_BLOCK_SIZE * mid],
+                                 &header) != 0 ||
+        header.max_timestamp < unix_ts_ms) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/** @} */
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* #ifndef UUIDV7_CODEC_H_BAEDKYFQ */
@@ -0,0 +1,221 @@
+/**
+ * @file
+ *
+ * uuidv7_index.h - Time-range lookup over sorted UUIDv7 arrays for uuidv7.h
+ *
+ * This optional header answers "all UUIDs from time `t1` to `t2`" over an
+ * array of 16-byte UUIDs sorted in byte order, such as a memory-mapped file of
+ * binary records, without touching more than a few cache lines of the array.
+ *
+ * The index is a sparse directory that holds the timestamp of every
+ * `UUIDV7_INDEX_STRIDE`-th UUID, laid out in Eytzinger (breadth-first) order:
+ * the first levels of the implicit search tree share a handful of cache lines,
+ * and the eight descendants of each node three levels down share a cache line,
+ * so the search descends without branches while prefetching them. The search
+ * over the directory narrows the range to a single stride of the array, which
+ * is fetched at once and searched without branches as well; a lookup thus costs
+ * about as many cache misses as the directory has uncached levels plus one,
+ * compared with one per level of a binary search over the whole array. The
+ * directory takes 8 bytes per stride, i.e., 1/128 of the array with the default
+ * stride of 64.
+ *
+ * @copyright Licensed under the Apache License, Version 2.0
+ * @see       https://github.com/LiosK/uuidv7-h
+ */
+/*
+ * Copyright 2022 LiosK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UUIDV7_INDEX_H_BAEDKYFQ
+#define UUIDV7_INDEX_H_BAEDKYFQ
+
+#include "uuidv7.h"
+
+#ifndef UUIDV7_INDEX_STRIDE
+/** Number of UUIDs covered by each directory entry. */
+#define UUIDV7_INDEX_STRIDE (64)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Index over a sorted array of UUIDs. */
+typedef struct {
+  /** Indexed array of UUIDs sorted in byte order. */
+  const uint8_t *uuids;
+
+  /** Number of UUIDs in the array. */
+  size_t n_uuids;
+
+  /**
+   * Directory in Eytzinger order, 1-based; `keys[k]` holds the first timestamp
+   * of a stride, or `UINT64_MAX` for padding that completes the tree.
+   */
+  uint64_t *keys;
+
+  /** Number of levels of the tree, which has `2^height - 1` nodes. */
+  int height;
+} uuidv7_index_t;
+
+/**
+ * Determines the size of the directory for an array.
+ *
+ * @param n_uuids  Number of UUIDs in the array.
+ * @return         Number of `uint64_t` elements to allocate for the directory.
+ */
+static inline size_t uuidv7_index_n_keys(size_t n_uuids) {
+  size_t n_strides = (n_uuids + UUIDV7_INDEX_STRIDE - 1) / UUIDV7_INDEX_STRIDE;
+  size_t n_nodes = 1;
+  while (n_nodes - 1 < n_strides) {
+    n_nodes <<= 1;
+  }
+  return n_nodes; // nodes 1 to n_nodes - 1 plus unused element 0
+}
+
+/** Determines the sorted position of Eytzinger node `k` at depth `depth`. */
+static inline size_t uuidv7_index_rank(size_t k, int depth, int height) {
+  return (((k - ((size_t)1 << depth)) * 2 + 1) << (height - 1 - depth)) - 1;
+}
+
+/**
+ * Builds an index over a sorted array.
+ *
+ * @param index    Index to build.
+ * @param uuids    Array of `n_uuids` 16-byte UUIDs sorted in byte order, which
+ *                 must remain valid and unchanged while the index is used.
+ * @param n_uuids  Number of UUIDs.
+ * @param keys     Directory of `uuidv7_index_n_keys(n_uuids)` elements, which
+ *                 must remain valid while the index is used; preferably
+ *                 aligned to 64 bytes so that prefetches cover whole lines.
+ */
+static inline void uuidv7_index_build(uuidv7_index_t *index,
+                                      const uint8_t *uuids, size_t n_uuids,
+                                      uint64_t *keys) {
+  size_t n_strides = (n_uuids + UUIDV7_INDEX_STRIDE - 1) / UUIDV7_INDEX_STRIDE;
+  size_t n_nodes = uuidv7_index_n_keys(n_uuids);
+  int height = 0;
+  while (((size_t)1 << height) < n_nodes) {
+    height++;
+  }
+
+  index->uuids = uuids;
+  index->n_uuids = n_uuids;
+  index->keys = keys;
+  index->height = height;
+
+  keys[0] = 0;
+  int depth = 0;
+  for (size_t k = 1; k < n_nodes; k++) {
+    if (k == ((size_t)2 << depth)) {
+      depth++;
+    }
+    size_t rank = uuidv7_index_rank(k, depth, height);
+    keys[k] = UINT64_MAX;
+    if (rank < n_strides) {
+      keys[k] = uuidv7_get_timestamp(&uuids[16 * UUIDV7_INDEX_STRIDE * rank]);
+    }
+  }
+}
+
+/**
+ * Finds the first UUID whose timestamp is equal to or greater than the given
+ * one.
+ *
+ * @param index       Index.
+ * @param unix_ts_ms  Timestamp to look for.
+ * @return            Position of the first UUID whose timestamp is equal to or
+ *                    greater than `unix_ts_ms`, or `n_uuids` if there is none.
+ */
+static inline size_t uuidv7_index_lower_bound(const uuidv7_index_t *index,
+                                              uint64_t unix_ts_ms) {
+  // descend to the first stride whose first timestamp is not less than the
+  // target; k then encodes the path, whose trailing right turns are undone
+  const uint64_t *keys = index->keys;
+  size_t n_nodes = (size_t)1 << index->height;
+  size_t k = 1;
+  while (k < n_nodes) {
+#if defined(__GNUC__)
+    __builtin_prefetch(&keys[8 * k]);
+#endif
+    k = 2 * k + (keys[k] < unix_ts_ms);
+  }
+  int depth = index->height;
+  while (k & 1) {
+    k >>= 1;
+    depth--;
+  }
+  k >>= 1;
+  depth--;
+
+  // the UUID lies in the stride before the one found or at the start of it
+  size_t stride = k == 0 ? (index->n_uuids + UUIDV7_INDEX_STRIDE - 1) /
+                               UUIDV7_INDEX_STRIDE
+                         : uuidv7_index_rank(k, depth, index->height);
+  if (stride == 0) {
+    return 0;
+  }
+  const uint8_t *base = &index->uuids[16 * (stride - 1) * UUIDV7_INDEX_STRIDE];
+  size_t n = index->n_uuids - (stride - 1) * UUIDV7_INDEX_STRIDE;
+  if (n > UUIDV7_INDEX_STRIDE) {
+    n = UUIDV7_INDEX_STRIDE;
+  }
+
+  // fetch the whole stride at once and search it without branches so that the
+  // cache misses overlap instead of following one another
+#if defined(__GNUC__)
+  for (size_t i = 0; i < n; i += 4) {
+    __builtin_prefetch(&base[16 * i]);
+  }
+#endif
+  size_t lo = 0;
+  while (n > 1) {
+    size_t half = n / 2;
+    lo += (uuidv7_get_timestamp(&base[16 * (lo + half)]) < unix_ts_ms) * half;
+    n -= half;
+  }
+  lo += uuidv7_get_timestamp(&base[16 * lo]) < unix_ts_ms;
+  return (stride - 1) * UUIDV7_INDEX_STRIDE + lo;
+}
+
+/**
+ * Finds the UUIDs whose timestamps fall in an inclusive range.
+ *
+ * @param index      Index.
+ * @param ts_from    First timestamp of the range.
+ * @param ts_to      Last timestamp of the range.
+ * @param begin_out  Location where the position of the first UUID in the range
+ *                   is stored.
+ * @return           Number of UUIDs in the range, which follow one another from
+ *                   `*begin_out`.
+ */
+static inline size_t uuidv7_index_range(const uuidv7_index_t *index,
+                                        uint64_t ts_from, uint64_t ts_to,
+                                        size_t *begin_out) {
+  size_t begin = uuidv7_index_lower_bound(index, ts_from);
+  size_t end = index->n_uuids;
+  if (ts_to < ts_from) {
+    end = begin;
+  } else if (ts_to < UINT64_MAX) {
+    end = uuidv7_index_lower_bound(index, ts_to + 1);
+  }
+  *begin_out = begin;
+  return end - begin;
+}
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* #ifndef UUIDV7_INDEX_H_BAEDKYFQ */
@@ -0,0 +1,364 @@
+/**
+ * @file
+ *
+ * uuidv7_partition.h - Time-bucket partitioning of UUIDv7 arrays for uuidv7.h
+ *
+ * This optional header groups an array of 16-byte UUIDs by the time bucket of
+ * their timestamps, such as the hour or day that selects a time-partitioned
+ * table, before the groups are bulk-loaded. It is a stable counting sort by
+ * bucket number: one pass counts the UUIDs per bucket, a prefix sum over the
+ * counts turns them into the first output position of each bucket, and a
+ * second pass copies every UUID to the next position of its bucket. The output
+ * holds each bucket as a contiguous range that keeps the input order, so
+ * UUIDs that arrive nearly sorted stay nearly sorted within their buckets.
+ *
+ * The two passes work on any number of chunks of the input with a histogram
+ * per chunk, which `uuidv7_partition_offsets()` merges into per-chunk write
+ * positions, so callers can run the passes on their own threads. When
+ * `UUIDV7_PARTITION_PTHREAD` is defined before this header is included,
+ * `uuidv7_partition_parallel()` does so with POSIX threads.
+ *
+ * @copyright Licensed under the Apache License, Version 2.0
+ * @see       https://github.com/LiosK/uuidv7-h
+ */
+/*
+ * Copyright 2022 LiosK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UUIDV7_PARTITION_H_BAEDKYFQ
+#define UUIDV7_PARTITION_H_BAEDKYFQ
+
+#include "uuidv7.h"
+
+#ifdef UUIDV7_PARTITION_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifndef UUIDV7_PARTITION_MAX_THREADS
+/** Maximum number of threads `uuidv7_partition_parallel()` uses. */
+#define UUIDV7_PARTITION_MAX_THREADS (64)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Layout of the time buckets.
+ *
+ * Bucket `b` covers the timestamps from `base_ms + b * width_ms` inclusive to
+ * `base_ms + (b + 1) * width_ms` exclusive. Timestamps outside all of them fall
+ * into an extra bucket numbered `n_buckets`, so the histograms and offsets of
+ * the functions below have `n_buckets + 1` entries.
+ */
+typedef struct {
+  /** First timestamp of bucket zero. */
+  uint64_t base_ms;
+
+  /** Width of each bucket in milliseconds. */
+  uint64_t width_ms;
+
+  /** Number of buckets, not counting the one for out-of-range timestamps. */
+  size_t n_buckets;
+
+  /** Width of all buckets, i.e., `n_buckets * width_ms`. */
+  uint64_t span_ms;
+} uuidv7_partition_t;
+
+/**
+ * Initializes a bucket layout.
+ *
+ * @param p          Layout to initialize.
+ * @param base_ms    First timestamp of bucket zero.
+ * @param width_ms   Width of each bucket in milliseconds, e.g., 3600000 for
+ *                   hourly buckets.
+ * @param n_buckets  Number of buckets.
+ * @return           Zero on success or non-zero integer if `width_ms` or
+ *                   `n_buckets` is zero or the buckets extend beyond the
+ *                   largest 48-bit timestamp.
+ */
+static inline int uuidv7_partition_init(uuidv7_partition_t *p,
+                                        uint64_t base_ms, uint64_t width_ms,
+                                        size_t n_buckets) {
+  static const uint64_t MAX_SPAN = (uint64_t)1 << 48;
+  if (width_ms == 0 || n_buckets == 0 || width_ms > MAX_SPAN ||
+      n_buckets > MAX_SPAN / width_ms || base_ms > MAX_SPAN ||
+      (uint64_t)n_buckets * width_ms > MAX_SPAN - base_ms) {
+    return -1;
+  }
+  p->base_ms = base_ms;
+  p->width_ms = width_ms;
+  p->n_buckets = n_buckets;
+  p->span_ms = (uint64_t)n_buckets * width_ms;
+  return 0;
+}
+
+/**
+ * Initializes a bucket layout that covers all UUIDs of an array with buckets
+ * aligned to multiples of the width since the Unix epoch.
+ *
+ * @param p         Layout to initialize.
+ * @param uuids     Array of `n_uuids` 16-byte UUIDs.
+ * @param n_uuids   Number of UUIDs, which may be zero for one empty bucket.
+ * @param width_ms  Width of each bucket in milliseconds.
+ * @return          Zero on success or non-zero integer if `width_ms` is zero
+ *                  or the number of buckets does not fit in `size_t`. Callers
+ *                  should check `p->n_buckets` before they allocate arrays of
+ *                  that size for arbitrary input.
+ */
+static inline int uuidv7_partition_init_range(uuidv7_partition_t *p,
+                                              const uint8_t *uuids,
+                                              size_t n_uuids,
+                                              uint64_t width_ms) {
+  if (width_ms == 0) {
+    return -1;
+  }
+  uint64_t min = UINT64_MAX, max = 0;
+  for (size_t i = 0; i < n_uuids; i++) {
+    uint64_t ts = uuidv7_load_be64(&uuids[16 * i]) >> 16;
+    min = ts < min ? ts : min;
+    max = ts > max ? ts : max;
+  }
+  if (n_uuids == 0) {
+    min = max = 0;
+  }
+  uint64_t base_ms = min - min % width_ms;
+  uint64_t n_buckets = (max - base_ms) / width_ms + 1;
+  if (n_buckets > (size_t)-1) {
+    return -1;
+  }
+  return uuidv7_partition_init(p, base_ms, width_ms, (size_t)n_buckets);
+}
+
+/**
+ * Determines the bucket of a UUID.
+ *
+ * @param p     Bucket layout.
+ * @param uuid  16-byte byte array representing the UUID.
+ * @return      Bucket number, or `p->n_buckets` if the timestamp is outside all
+ *              buckets.
+ */
+static inline size_t uuidv7_partition_bucket(const uuidv7_partition_t *p,
+                                             const uint8_t *uuid) {
+  uint64_t delta = (uuidv7_load_be64(uuid) >> 16) - p->base_ms;
+  if (delta >= p->span_ms) {
+    return p->n_buckets; // also catches timestamps before base_ms
+  }
+  return (size_t)(delta / p->width_ms);
+}
+
+/**
+ * Adds the number of UUIDs in each bucket to a histogram.
+ *
+ * @param p        Bucket layout.
+ * @param uuids    Array of `n_uuids` 16-byte UUIDs.
+ * @param n_uuids  Number of UUIDs.
+ * @param counts   Histogram of `p->n_buckets + 1` elements, which the caller
+ *                 initializes, usually to zeros.
+ */
+static inline void uuidv7_partition_count(const uuidv7_partition_t *p,
+                                          const uint8_t *uuids, size_t n_uuids,
+                                          size_t *counts) {
+  const uuidv7_partition_t layout = *p; // not reloaded after each increment
+  for (size_t i = 0; i < n_uuids; i++) {
+    counts[uuidv7_partition_bucket(&layout, &uuids[16 * i])]++;
+  }
+}
+
+/**
+ * Converts the histograms of consecutive chunks of an array into the output
+ * positions where each chunk writes each bucket.
+ *
+ * After this call, `counts[c * (p->n_buckets + 1) + b]` holds the position of
+ * the first UUID of bucket `b` in chunk `c`, which follows all UUIDs of the
+ * preceding buckets and those of bucket `b` in the preceding chunks.
+ *
+ * @param p              Bucket layout.
+ * @param counts         Histograms of `n_chunks` chunks, `p->n_buckets + 1`
+ *                       elements each, converted in place.
+ * @param n_chunks       Number of chunks.
+ * @param bucket_starts  Array of `p->n_buckets + 2` elements where the first
+ *                       output position of each bucket and the total number of
+ *                       UUIDs are stored, or NULL.
+ */
+static inline void uuidv7_partition_offsets(const uuidv7_partition_t *p,
+                                            size_t *counts, size_t n_chunks,
+                                            size_t *bucket_starts) {
+  const size_t stride = p->n_buckets + 1;
+  size_t sum = 0;
+  for (size_t b = 0; b < stride; b++) {
+    if (bucket_starts != NULL) {
+      bucket_starts[b] = sum;
+    }
+    for (size_t c = 0; c < n_chunks; c++) {
+      size_t count = counts[c * stride + b];
+      counts[c * stride + b] = sum;
+      sum += count;
+    }
+  }
+  if (bucket_starts != NULL) {
+    bucket_starts[stride] = sum;
+  }
+}
+
+/**
+ * Copies each UUID of a chunk to the next output position of its bucket.
+ *
+ * @param p          Bucket layout.
+ * @param uuids      Array of `n_uuids` 16-byte UUIDs.
+ * @param n_uuids    Number of UUIDs.
+ * @param offsets    Output positions of the chunk of `p->n_buckets + 1`
+ *                   elements, which advance past the UUIDs copied.
+ * @param uuids_out  Output array of 16-byte UUIDs, which must not overlap the
+ *                   input.
+ */
+static inline void uuidv7_partition_scatter(const uuidv7_partition_t *p,
+                                            const uint8_t *uuids,
+                                            size_t n_uuids, size_t *offsets,
+                                            uint8_t *uuids_out) {
+  const uuidv7_partition_t layout = *p;
+  for (size_t i = 0; i < n_uuids; i++) {
+    size_t b = uuidv7_partition_bucket(&layout, &uuids[16 * i]);
+    memcpy(&uuids_out[16 * offsets[b]++], &uuids[16 * i], 16);
+  }
+}
+
+/**
+ * Partitions an array of UUIDs by time bucket, keeping the input order within
+ * each bucket.
+ *
+ * @param p              Bucket layout.
+ * @param uuids          Array of `n_uuids` 16-byte UUIDs.
+ * @param n_uuids        Number of UUIDs.
+ * @param bucket_starts  Array of `p->n_buckets + 2` elements where the first
+ *                       output position of each bucket and the total number of
+ *                       UUIDs are stored; bucket `b` occupies positions from
+ *                       `bucket_starts[b]` to `bucket_starts[b + 1]`.
+ * @param uuids_out      Output array of `n_uuids` 16-byte UUIDs, which must
+ *                       not overlap the input.
+ */
+static inline void uuidv7_partition(const uuidv7_partition_t *p,
+                                    const uint8_t *uuids, size_t n_uuids,
+                                    size_t *bucket_starts, uint8_t *uuids_out) {
+  // count into bucket_starts[1..], turn the counts into starts, and let the
+  // scatter advance each start to the end of its bucket, which is the start of
+  // the next one
+  memset(bucket_starts, 0, sizeof(size_t) * (p->n_buckets + 2));
+  uuidv7_partition_count(p, uuids, n_uuids, &bucket_starts[1]);
+  uuidv7_partition_offsets(p, &bucket_starts[1], 1, NULL);
+  uuidv7_partition_scatter(p, uuids, n_uuids, &bucket_starts[1], uuids_out);
+}
+
+#ifdef UUIDV7_PARTITION_PTHREAD
+/** Work of a thread in `uuidv7_partition_parallel()`. */
+typedef struct {
+  const uuidv7_partition_t *p;
+  const uint8_t *uuids;
+  size_t n_uuids;
+  size_t *counts;
+  uint8_t *uuids_out; // NULL to count, or the output to scatter
+} uuidv7_partition_task_t;
+
+static inline void *uuidv7_partition_run_task(void *arg) {
+  uuidv7_partition_task_t *t = (uuidv7_partition_task_t *)arg;
+  if (t->uuids_out == NULL) {
+    uuidv7_partition_count(t->p, t->uuids, t->n_uuids, t->counts);
+  } else {
+    uuidv7_partition_scatter(t->p, t->uuids, t->n_uuids, t->counts,
+                             t->uuids_out);
+  }
+  return NULL;
+}
+
+/** Runs tasks on threads, or on the calling thread where creation fails. */
+static inline void uuidv7_partition_run_tasks(uuidv7_partition_task_t *tasks,
+                                              size_t n_tasks) {
+  pthread_t threads[UUIDV7_PARTITION_MAX_THREADS];
+  int started[UUIDV7_PARTITION_MAX_THREADS];
+  for (size_t i = 1; i < n_tasks; i++) {
+    started[i] = pthread_create(&threads[i], NULL, uuidv7_partition_run_task,
+                                &tasks[i]) == 0;
+  }
+  uuidv7_partition_run_task(&tasks[0]);
+  for (size_t i = 1; i < n_tasks; i++) {
+    if (started[i]) {
+      pthread_join(threads[i], NULL);
+    } else {
+      uuidv7_partition_run_task(&tasks[i]);
+    }
+  }
+}
+
+/**
+ * Partitions an array of UUIDs by time bucket on multiple threads, producing
+ * the same output as `uuidv7_partition()` does.
+ *
+ * The array is split into `n_threads` chunks, which are counted in parallel,
+ * and then scattered in parallel to the positions that
+ * `uuidv7_partition_offsets()` computes from their histograms. The calling
+ * thread works on the first chunk.
+ *
+ * @param p              Bucket layout.
+ * @param uuids          Array of `n_uuids` 16-byte UUIDs.
+ * @param n_uuids        Number of UUIDs.
+ * @param n_threads      Number of threads, from 1 to
+ *                       `UUIDV7_PARTITION_MAX_THREADS`; larger values are
+ *                       capped.
+ * @param counts         Working array of `n_threads * (p->n_buckets + 1)`
+ *                       elements.
+ * @param bucket_starts  Array of `p->n_buckets + 2` elements where the first
+ *                       output position of each bucket and the total number of
+ *                       UUIDs are stored.
+ * @param uuids_out      Output array of `n_uuids` 16-byte UUIDs, which must
+ *                       not overlap the input.
+ */
+static inline void uuidv7_partition_parallel(const uuidv7_partition_t *p,
+                                             const uint8_t *uuids,
+                                             size_t n_uuids, size_t n_threads,
+                                             size_t *counts,
+                                             size_t *bucket_starts,
+                                             uint8_t *uuids_out) {
+  uuidv7_partition_task_t tasks[UUIDV7_PARTITION_MAX_THREADS];
+  if (n_threads > UUIDV7_PARTITION_MAX_THREADS) {
+    n_threads = UUIDV7_PARTITION_MAX_THREADS;
+  } else if (n_threads == 0) {
+    n_threads = 1;
+  }
+
+  const size_t stride = p->n_buckets + 1;
+  const size_t chunk = n_uuids / n_threads, rem = n_uuids % n_threads;
+  memset(counts, 0, sizeof(size_t) * n_threads * stride);
+  for (size_t i = 0, begin = 0; i < n_threads; i++) {
+    tasks[i].p = p;
+    tasks[i].uuids = &uuids[16 * begin];
+    tasks[i].n_uuids = chunk + (i < rem);
+    begin += tasks[i].n_uuids;
+    tasks[i].counts = &counts[i * stride];
+    tasks[i].uuids_out = NULL;
+  }
+  uuidv7_partition_run_tasks(tasks, n_threads);
+
+  uuidv7_partition_offsets(p, counts, n_threads, bucket_starts);
+  for (size_t i = 0; i < n_threads; i++) {
+    tasks[i].uuids_out = uuids_out;
+  }
+  uuidv7_partition_run_tasks(tasks, n_threads);
+}
+#endif /* #ifdef UUIDV7_PARTITION_PTHREAD */
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* #ifndef UUIDV7_PARTITION_H_BAEDKYFQ */
@@ -0,0 +1,481 @@
+/**
+ * @file
+ *
+ * uuidv7_set.h - Open-addressing hash set and map of UUIDv7s for uuidv7.h
+ *
+ * This optional header deduplicates large streams of binary UUIDs, as an
+ * ingestion pipeline does, in a flat table that holds the 16-byte keys in place
+ * rather than behind pointers.
+ *
+ * The table is split into groups of 16 slots, each of which has a control byte
+ * that is either empty or a 7-bit tag taken from the hash of the key in the
+ * slot. A probe loads the 16 control bytes of a group at once, compares them
+ * with the tag of the key by SSE2 instructions (or a portable loop), and
+ * compares the keys of the matching slots only, which are one in most probes;
+ * it moves on to the next group only if the group is full. The control bytes
+ * take 1 byte per slot, so those of 64 slots share a cache line.
+ *
+ * The hash is a single multiplication: the two 64-bit halves of a UUIDv7
+ * already differ in the 32-bit random tail and the counter, which
+ * `uuidv7_generate()` fills with random bits, so no further mixing is needed.
+ *
+ * The bulk functions work on batches of UUIDs: they hash a batch, prefetch the
+ * control bytes of all of it (and, for lookups, then the candidate keys), and
+ * only then probe, so that the cache misses of a batch overlap instead of
+ * following one another.
+ * `uuidv7_set_evict_before()` removes the UUIDs older than a timestamp, which
+ * bounds the memory of a sliding deduplication window because old UUIDs have
+ * smaller timestamps; the table has a fixed capacity of 7/8 of the slots and is
+ * rebuilt in place on eviction so that removals leave no tombstones behind.
+ *
+ * @copyright Licensed under the Apache License, Version 2.0
+ * @see       https://github.com/LiosK/uuidv7-h
+ */
+/*
+ * Copyright 2022 LiosK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UUIDV7_SET_H_BAEDKYFQ
+#define UUIDV7_SET_H_BAEDKYFQ
+
+#include "uuidv7.h"
+
+#ifndef UUIDV7_SET_BATCH_SIZE
+/** Number of UUIDs the bulk functions prefetch at a time. */
+#define UUIDV7_SET_BATCH_SIZE (32)
+#endif
+
+/** Slot position returned for a UUID that is not in the set. */
+#define UUIDV7_SET_NOT_FOUND ((size_t)-1)
+
+/** Control byte of an empty slot; full slots hold 7-bit tags. */
+#define UUIDV7_SET_EMPTY (0x80)
+
+/** Control byte of a slot waiting to be placed during a rebuild. */
+#define UUIDV7_SET_PENDING (0xfe)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Hash set of UUIDs, or a map if it holds a value per slot. */
+typedef struct {
+  /** Control bytes of `n_slots` slots. */
+  uint8_t *ctrl;
+
+  /** Keys of `n_slots` slots, 16 bytes each. */
+  uint8_t *keys;
+
+  /** Values of `n_slots` slots, or NULL for a set. */
+  uint64_t *values;
+
+  /** Number of slots, which is a power of two and at least 16. */
+  size_t n_slots;
+
+  /** Number of UUIDs in the set. */
+  size_t size;
+
+  /** Shift that extracts the group from a hash. */
+  int shift;
+} uuidv7_set_t;
+
+/**
+ * Determines the number of slots for a capacity.
+ *
+ * @param capacity  Maximum number of UUIDs to hold at a time.
+ * @return          Number of slots to pass to `uuidv7_set_memory_size()` and
+ *                  `uuidv7_set_init()`.
+ */
+static inline size_t uuidv7_set_n_slots(size_t capacity) {
+  size_t n_slots = 16;
+  while (n_slots - n_slots / 8 < capacity) {
+    n_slots <<= 1;
+  }
+  return n_slots;
+}
+
+/** Determines the maximum number of UUIDs a set can hold. */
+static inline size_t uuidv7_set_capacity(const uuidv7_set_t *set) {
+  return set->n_slots - set->n_slots / 8;
+}
+
+/**
+ * Determines the size of the memory block for a set.
+ *
+ * @param n_slots      Number of slots returned by `uuidv7_set_n_slots()`.
+ * @param with_values  Non-zero to hold a `uint64_t` value per UUID (map).
+ * @return             Number of bytes to allocate.
+ */
+static inline size_t uuidv7_set_memory_size(size_t n_slots, int with_values) {
+  size_t ctrl_size = (n_slots + 63) & ~(size_t)63;
+  return ctrl_size + 16 * n_slots + (with_values ? 8 * n_slots : 0);
+}
+
+/** Removes all UUIDs from a set. */
+static inline void uuidv7_set_clear(uuidv7_set_t *set) {
+  memset(set->ctrl, UUIDV7_SET_EMPTY, set->n_slots);
+  set->size = 0;
+}
+
+/**
+ * Initializes an empty set.
+ *
+ * @param set          Set to initialize.
+ * @param n_slots      Number of slots returned by `uuidv7_set_n_slots()`.
+ * @param memory       Memory block of `uuidv7_set_memory_size(n_slots,
+ *                     with_values)` bytes, which must remain valid while the
+ *                     set is used; preferably aligned to 64 bytes so that each
+ *                     key lies in a single cache line.
+ * @param with_values  Non-zero to hold a `uint64_t` value per UUID (map).
+ */
+static inline void uuidv7_set_init(uuidv7_set_t *set, size_t n_slots,
+                                   void *memory, int with_values) {
+  size_t ctrl_size = (n_slots + 63) & ~(size_t)63;
+  int log2_groups = 0;
+  while (((size_t)16 << log2_groups) < n_slots) {
+    log2_groups++;
+  }
+  set->ctrl = (uint8_t *)memory;
+  set->keys = set->ctrl + ctrl_size;
+  set->values = with_values ? (uint64_t *)(set->keys + 16 * n_slots) : NULL;
+  set->n_slots = n_slots;
+  set->shift = 57 - log2_groups;
+  uuidv7_set_clear(set);
+}
+
+/** Computes the hash of a UUID, whose top 7 bits are the tag. */
+static inline uint64_t uuidv7_set_hash(const uint8_t *uuid) {
+  return (uuidv7_load_be64(uuid) ^ uuidv7_load_be64(uuid + 8)) *
+         0x9e3779b97f4a7c15;
+}
+
+/** Determines the first group to probe for a hash. */
+static inline size_t uuidv7_set_home(const uuidv7_set_t *set, uint64_t hash) {
+  return (size_t)(hash >> set->shift) & ((set->n_slots >> 4) - 1);
+}
+
+/**
+ * Compares the control bytes of a group with a byte.
+ *
+ * @return  Bit mask of the slots whose control bytes equal `c`.
+ */
+static inline unsigned uuidv7_set_match(const uint8_t *group, uint8_t c) {
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSE2__)
+  __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+  return (unsigned)_mm_movemask_epi8(
+      _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)c)));
+#else
+  unsigned mask = 0;
+  for (int i = 0; i < 16; i++) {
+    mask |= (unsigned)(group[i] == c) << i;
+  }
+  return mask;
+#endif
+}
+
+/** Returns the position of the lowest set bit of a non-zero mask. */
+static inline int uuidv7_set_lowest_bit(unsigned mask) {
+#if defined(__GNUC__)
+  return __builtin_ctz(mask);
+#else
+  int i = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    i++;
+  }
+  return i;
+#endif
+}
+
+/**
+ * Looks up a UUID with a precomputed hash.
+ *
+ * @return  Slot of the UUID, or `UUIDV7_SET_NOT_FOUND`. `*empty_out` receives
+ *          the first empty slot of the probe sequence if the UUID is not
+ *          found, which is `UUIDV7_SET_NOT_FOUND` if the set has none.
+ */
+static inline size_t uuidv7_set_probe(const uuidv7_set_t *set,
+                                      const uint8_t *uuid, uint64_t hash,
+                                      size_t *empty_out) {
+  const uint8_t tag = (uint8_t)(hash >> 57);
+  const size_t group_mask = (set->n_slots >> 4) - 1;
+  size_t group = uuidv7_set_home(set, hash);
+  for (size_t n = 0; n <= group_mask; n++) {
+    const uint8_t *ctrl = &set->ctrl[16 * group];
+    unsigned mask = uuidv7_set_match(ctrl, tag);
+    while (mask != 0) {
+      size_t slot = 16 * group + uuidv7_set_lowest_bit(mask);
+      if (memcmp(&set->keys[16 * slot], uuid, 16) == 0) {
+        return slot;
+      }
+      mask &= mask - 1;
+    }
+    unsigned empty = uuidv7_set_match(ctrl, UUIDV7_SET_EMPTY);
+    if (empty != 0) {
+      *empty_out = 16 * group + uuidv7_set_lowest_bit(empty);
+      return UUIDV7_SET_NOT_FOUND;
+    }
+    group = (group + 1) & group_mask;
+  }
+  *empty_out = UUIDV7_SET_NOT_FOUND;
+  return UUIDV7_SET_NOT_FOUND;
+}
+
+/**
+ * Looks up a UUID.
+ *
+ * @param set   Set.
+ * @param uuid  16-byte byte array representing the UUID to look up.
+ * @return      Slot of the UUID, which indexes `set->values` in a map, or
+ *              `UUIDV7_SET_NOT_FOUND` if the set does not contain the UUID.
+ */
+static inline size_t uuidv7_set_find(const uuidv7_set_t *set,
+                                     const uint8_t *uuid) {
+  size_t empty;
+  return uuidv7_set_probe(set, uuid, uuidv7_set_hash(uuid), &empty);
+}
+
+/** Inserts a UUID with a precomputed hash; see `uuidv7_set_insert()`. */
+static inline int uuidv7_set_insert_hashed(uuidv7_set_t *set,
+                                           const uint8_t *uuid, uint64_t hash,
+                                           size_t *slot_out) {
+  size_t empty;
+  size_t slot = uuidv7_set_probe(set, uuid, hash, &empty);
+  if (slot != UUIDV7_SET_NOT_FOUND) {
+    *slot_out = slot;
+    return 0;
+  } else if (set->size >= uuidv7_set_capacity(set)) {
+    *slot_out = UUIDV7_SET_NOT_FOUND;
+    return -1;
+  }
+  set->ctrl[empty] = (uint8_t)(hash >> 57);
+  memcpy(&set->keys[16 * empty], uuid, 16);
+  set->size++;
+  *slot_out = empty;
+  return 1;
+}
+
+/**
+ * Inserts a UUID unless the set already contains it.
+ *
+ * @param set       Set.
+ * @param uuid      16-byte byte array representing the UUID to insert.
+ * @param slot_out  Location where the slot of the UUID is stored, which
+ *                  indexes `set->values` in a map, or `UUIDV7_SET_NOT_FOUND`
+ *                  if the set is full. This may be NULL.
+ * @return          1 if the UUID is inserted, 0 if the set already contains
+ *                  it, or -1 if the set is full.
+ */
+static inline int uuidv7_set_insert(uuidv7_set_t *set, const uint8_t *uuid,
+                                    size_t *slot_out) {
+  size_t slot;
+  uint64_t hash = uuidv7_set_hash(uuid);
+  int status = uuidv7_set_insert_hashed(set, uuid, hash, &slot);
+  if (slot_out != NULL) {
+    *slot_out = slot;
+  }
+  return status;
+}
+
+/**
+ * Hashes a batch of UUIDs and prefetches their control bytes and, if
+ * `prefetch_keys` is non-zero, then the keys of the first matching slots, so
+ * that the cache misses of the batch overlap.
+ */
+static inline void uuidv7_set_prefetch(const uuidv7_set_t *set,
+                                       const uint8_t *uuids, size_t n,
+                                       int prefetch_keys,
+                                       uint64_t *hashes_out) {
+  for (size_t k = 0; k < n; k++) {
+    hashes_out[k] = uuidv7_set_hash(&uuids[16 * k]);
+#if defined(__GNUC__)
+    __builtin_prefetch(&set->ctrl[16 * uuidv7_set_home(set, hashes_out[k])]);
+#endif
+  }
+#if defined(__GNUC__)
+  for (size_t k = 0; prefetch_keys && k < n; k++) {
+    size_t group = uuidv7_set_home(set, hashes_out[k]);
+    unsigned mask = uuidv7_set_match(&set->ctrl[16 * group],
+                                     (uint8_t)(hashes_out[k] >> 57));
+    if (mask != 0) {
+      __builtin_prefetch(
+          &set->keys[16 * (16 * group + uuidv7_set_lowest_bit(mask))]);
+    }
+  }
+#else
+  (void)prefetch_keys;
+#endif
+}
+
+/**
+ * Looks up an array of UUIDs.
+ *
+ * @param set        Set.
+ * @param uuids      Byte array of `16 * n_uuids` bytes representing the UUIDs
+ *                   to look up.
+ * @param n_uuids    Number of UUIDs.
+ * @param slots_out  Array of `n_uuids` elements where the slot of each UUID or
+ *                   `UUIDV7_SET_NOT_FOUND` is stored. This may be NULL.
+ * @return           Number of UUIDs found.
+ */
+static inline size_t uuidv7_set_find_bulk(const uuidv7_set_t *set,
+                                          const uint8_t *uuids, size_t n_uuids,
+                                          size_t *slots_out) {
+  size_t n_found = 0;
+  uint64_t hashes[UUIDV7_SET_BATCH_SIZE];
+  for (size_t i = 0; i < n_uuids; i += UUIDV7_SET_BATCH_SIZE) {
+    size_t n = n_uuids - i;
+    n = n < UUIDV7_SET_BATCH_SIZE ? n : UUIDV7_SET_BATCH_SIZE;
+    uuidv7_set_prefetch(set, &uuids[16 * i], n, 1, hashes);
+    for (size_t k = 0; k < n; k++) {
+      size_t empty;
+      size_t slot = uuidv7_set_probe(set, &uuids[16 * (i + k)], hashes[k],
+                                     &empty);
+      n_found += slot != UUIDV7_SET_NOT_FOUND;
+      if (slots_out != NULL) {
+        slots_out[i + k] = slot;
+      }
+    }
+  }
+  return n_found;
+}
+
+/**
+ * Inserts an array of UUIDs, skipping those the set already contains.
+ *
+ * Duplicates within the array are detected as well: the first occurrence is
+ * inserted and the others are reported as already contained.
+ *
+ * @param set         Set.
+ * @param uuids       Byte array of `16 * n_uuids` bytes representing the UUIDs
+ *                    to insert.
+ * @param n_uuids     Number of UUIDs.
+ * @param status_out  Array of `n_uuids` elements where the return value of
+ *                    `uuidv7_set_insert()` for each UUID is stored. This may be
+ *                    NULL.
+ * @param slots_out   Array of `n_uuids` elements where the slot of each UUID
+ *                    is stored. This may be NULL.
+ * @return            Number of UUIDs inserted. It is less than the number of
+ *                    distinct new UUIDs if the set becomes full, in which case
+ *                    the remaining new UUIDs get -1 in `status_out`.
+ */
+static inline size_t uuidv7_set_insert_bulk(uuidv7_set_t *set,
+                                            const uint8_t *uuids,
+                                            size_t n_uuids, int8_t *status_out,
+                                            size_t *slots_out) {
+  size_t n_inserted = 0;
+  uint64_t hashes[UUIDV7_SET_BATCH_SIZE];
+  for (size_t i = 0; i < n_uuids; i += UUIDV7_SET_BATCH_SIZE) {
+    size_t n = n_uuids - i;
+    n = n < UUIDV7_SET_BATCH_SIZE ? n : UUIDV7_SET_BATCH_SIZE;
+    // new UUIDs have no key to fetch, and duplicates in a stream tend to be
+    // recent and thus cached
+    uuidv7_set_prefetch(set, &uuids[16 * i], n, 0, hashes);
+    for (size_t k = 0; k < n; k++) {
+      size_t slot;
+      int status = uuidv7_set_insert_hashed(set, &uuids[16 * (i + k)],
+                                            hashes[k], &slot);
+      n_inserted += status > 0;
+      if (status_out != NULL) {
+        status_out[i + k] = (int8_t)status;
+      }
+      if (slots_out != NULL) {
+        slots_out[i + k] = slot;
+      }
+    }
+  }
+  return n_inserted;
+}
+
+/**
+ * Removes the UUIDs whose timestamps are less than a given one.
+ *
+ * This function scans the whole table and then moves the remaining UUIDs that
+ * overflowed their home groups, and their values in a map, to the first free
+ * slots of their probe sequences, so that the probes stay as short as after
+ * fresh inserts. Call it once per window step rather than per UUID. The slots
+ * of the remaining UUIDs may change.
+ *
+ * @param set         Set.
+ * @param unix_ts_ms  Timestamp of the oldest UUIDs to keep. UUIDs that are not
+ *                    UUIDv7s are removed or kept by the first 48 bits likewise.
+ * @return            Number of UUIDs removed.
+ */
+static inline size_t uuidv7_set_evict_before(uuidv7_set_t *set,
+                                             uint64_t unix_ts_ms) {
+  const size_t n_slots = set->n_slots;
+  size_t n_removed = 0;
+  for (size_t i = 0; i < n_slots; i++) {
+    if (set->ctrl[i] != UUIDV7_SET_EMPTY) {
+      const uint8_t *key = &set->keys[16 * i];
+      if (uuidv7_get_timestamp(key) < unix_ts_ms) {
+        set->ctrl[i] = UUIDV7_SET_EMPTY;
+        n_removed++;
+      } else if (uuidv7_set_home(set, uuidv7_set_hash(key)) != i / 16) {
+        set->ctrl[i] = UUIDV7_SET_PENDING; // may move closer to its home
+      }
+    }
+  }
+  set->size -= n_removed;
+
+  // place each pending UUID at the first free (empty or pending) slot of its
+  // probe sequence, swapping with a pending UUID found there if any; UUIDs in
+  // their home groups stay where they are
+  const size_t group_mask = (n_slots >> 4) - 1;
+  for (size_t i = 0; i < n_slots; i++) {
+    while (set->ctrl[i] == UUIDV7_SET_PENDING) {
+      uint64_t hash = uuidv7_set_hash(&set->keys[16 * i]);
+      size_t home = uuidv7_set_home(set, hash);
+      size_t group = home;
+      unsigned free_mask;
+      while ((free_mask = uuidv7_set_match(&set->ctrl[16 * group],
+                                           UUIDV7_SET_EMPTY) |
+                          uuidv7_set_match(&set->ctrl[16 * group],
+                                           UUIDV7_SET_PENDING)) == 0) {
+        group = (group + 1) & group_mask;
+      }
+      size_t target = 16 * group + uuidv7_set_lowest_bit(free_mask);
+      const uint8_t tag = (uint8_t)(hash >> 57);
+      if (((target / 16 - home) & group_mask) ==
+          ((i / 16 - home) & group_mask)) {
+        set->ctrl[i] = tag; // already in the first free group
+      } else if (set->ctrl[target] == UUIDV7_SET_EMPTY) {
+        set->ctrl[target] = tag;
+        set->ctrl[i] = UUIDV7_SET_EMPTY;
+        memcpy(&set->keys[16 * target], &set->keys[16 * i], 16);
+        if (set->values != NULL) {
+          set->values[target] = set->values[i];
+        }
+      } else {
+        uint8_t tmp[16];
+        memcpy(tmp, &set->keys[16 * target], 16);
+        memcpy(&set->keys[16 * target], &set->keys[16 * i], 16);
+        memcpy(&set->keys[16 * i], tmp, 16);
+        if (set->values != NULL) {
+          uint64_t value = set->values[target];
+          set->values[target] = set->values[i];
+          set->values[i] = value;
+        }
+        set->ctrl[target] = tag;
+      }
+    }
+  }
+  return n_removed;
+}
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* #ifndef UUIDV7_SET_H_BAEDKYFQ */
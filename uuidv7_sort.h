@@ -0,0 +1,409 @@
+/**
+ * @file
+ *
+ * uuidv7_sort.h - Sorting and merging of UUID arrays for uuidv7.h
+ *
+ * This optional header sorts arrays of 16-byte binary UUIDs in byte order,
+ * which is the generation order of UUIDv7s, and merges sorted runs of UUIDs.
+ *
+ * `uuidv7_sort()` first scans the input for ascending runs. Sorted input is
+ * left as is, and input that consists of a few runs, such as the concatenated
+ * outputs of several generators, is merged run by run. Other input is sorted by
+ * `uuidv7_sort_radix()`, a most-significant-digit radix sort that skips the
+ * bytes shared by all UUIDs in a bucket, such as the upper bytes of timestamps
+ * from the same period, and finishes small buckets with insertion sort.
+ *
+ * `uuidv7_merger_next()` merges sorted runs that arrive incrementally, e.g.,
+ * from several generators, into a single sorted stream.
+ *
+ * @copyright Licensed under the Apache License, Version 2.0
+ * @see       https://github.com/LiosK/uuidv7-h
+ */
+/*
+ * Copyright 2022 LiosK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UUIDV7_SORT_H_BAEDKYFQ
+#define UUIDV7_SORT_H_BAEDKYFQ
+
+#include "uuidv7.h"
+
+#ifndef UUIDV7_SORT_MAX_RUNS
+/**
+ * Maximum number of ascending runs that `uuidv7_sort()` merges instead of
+ * radix sorting. Each pairwise merge pass costs about half as much as the radix
+ * sort on shuffled UUIDs, so merging pays off for up to two passes.
+ */
+#define UUIDV7_SORT_MAX_RUNS (4)
+#endif
+
+#ifndef UUIDV7_SORT_INSERTION_THRESHOLD
+/** Bucket size at or below which the radix sort switches to insertion sort. */
+#define UUIDV7_SORT_INSERTION_THRESHOLD (32)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name Sorting
+ *
+ * @{
+ */
+
+/** Returns non-zero if the UUID `a` precedes `b` in byte order. */
+static inline int uuidv7_sort_less(const uint8_t *a, const uint8_t *b) {
+  uint64_t a_hi = uuidv7_load_be64(a), b_hi = uuidv7_load_be64(b);
+  if (a_hi != b_hi) {
+    return a_hi < b_hi;
+  }
+  return uuidv7_load_be64(&a[8]) < uuidv7_load_be64(&b[8]);
+}
+
+/** Sorts a small array of UUIDs in place by insertion. */
+static inline void uuidv7_sort_insertion(uint8_t *uuids, size_t n_uuids) {
+  for (size_t i = 1; i < n_uuids; i++) {
+    uint8_t x[16];
+    memcpy(x, &uuids[16 * i], 16);
+    size_t j = i;
+    while (j > 0 && uuidv7_sort_less(x, &uuids[16 * (j - 1)])) {
+      j--;
+    }
+    if (j < i) {
+      memmove(&uuids[16 * (j + 1)], &uuids[16 * j], 16 * (i - j));
+      memcpy(&uuids[16 * j], x, 16);
+    }
+  }
+}
+
+/**
+ * Sorts `uuids` by the bytes from `byte` onward, alternating between `uuids`
+ * and `other` as the source and destination of each digit pass.
+ *
+ * @param result_in_other  Non-zero to leave the sorted UUIDs in `other` rather
+ *                         than `uuids`.
+ */
+static inline void uuidv7_sort_msd(uint8_t *uuids, uint8_t *other,
+                                   size_t n_uuids, int byte,
+                                   int result_in_other) {
+  if (n_uuids <= UUIDV7_SORT_INSERTION_THRESHOLD) {
+    uuidv7_sort_insertion(uuids, n_uuids);
+    if (result_in_other) {
+      memcpy(other, uuids, 16 * n_uuids);
+    }
+    return;
+  }
+
+  // skip the bytes common to all UUIDs in the bucket
+  size_t counts[256];
+  for (;; byte++) {
+    if (byte == 16) {
+      if (result_in_other) {
+        memcpy(other, uuids, 16 * n_uuids);
+      }
+      return; // all equal
+    }
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < n_uuids; i++) {
+      counts[uuids[16 * i + byte]]++;
+    }
+    if (counts[uuids[byte]] < n_uuids) {
+      break;
+    }
+  }
+
+  size_t offsets[256];
+  size_t sum = 0;
+  for (int d = 0; d < 256; d++) {
+    offsets[d] = sum;
+    sum += counts[d];
+  }
+  for (size_t i = 0; i < n_uuids; i++) {
+    memcpy(&other[16 * offsets[uuids[16 * i + byte]]++], &uuids[16 * i], 16);
+  }
+
+  // the UUIDs are now in `other`, so the roles swap for each bucket
+  size_t start = 0;
+  for (int d = 0; d < 256; d++) {
+    if (counts[d] > 0) {
+      uuidv7_sort_msd(&other[16 * start], &uuids[16 * start], counts[d],
+                      byte + 1, !result_in_other);
+      start += counts[d];
+    }
+  }
+}
+
+/**
+ * Sorts an array of UUIDs in byte order by radix sort.
+ *
+ * @param uuids    Array of `n_uuids` 16-byte UUIDs to sort in place.
+ * @param n_uuids  Number of UUIDs.
+ * @param scratch  Working area of `16 * n_uuids` bytes, which must not overlap
+ *                 `uuids`. Its contents are overwritten.
+ */
+static inline void uuidv7_sort_radix(uint8_t *uuids, size_t n_uuids,
+                                     uint8_t *scratch) {
+  uuidv7_sort_msd(uuids, scratch, n_uuids, 0, 0);
+}
+
+/** Merges two adjacent sorted ranges of `src` into `dst`. */
+static inline void uuidv7_sort_merge2(const uint8_t *src, size_t begin,
+                                      size_t middle, size_t end, uint8_t *dst) {
+  size_t i = begin, j = middle, k = begin;
+  while (i < middle && j < end) {
+    // take from the left on ties so that equal UUIDs keep their order
+    if (uuidv7_sort_less(&src[16 * j], &src[16 * i])) {
+      memcpy(&dst[16 * k++], &src[16 * j++], 16);
+    } else {
+      memcpy(&dst[16 * k++], &src[16 * i++], 16);
+    }
+  }
+  memcpy(&dst[16 * k], &src[16 * i], 16 * (middle - i));
+  k += middle - i;
+  memcpy(&dst[16 * k], &src[16 * j], 16 * (end - j));
+}
+
+/**
+ * Sorts an array of UUIDs in byte order, taking advantage of ascending runs in
+ * the input.
+ *
+ * An already sorted array is detected in a single pass. An array that consists
+ * of at most `UUIDV7_SORT_MAX_RUNS` ascending runs is merged pairwise, and any
+ * other array is sorted by `uuidv7_sort_radix()`.
+ *
+ * @param uuids    Array of `n_uuids` 16-byte UUIDs to sort in place.
+ * @param n_uuids  Number of UUIDs.
+ * @param scratch  Working area of `16 * n_uuids` bytes, which must not overlap
+ *                 `uuids`. Its contents are overwritten.
+ */
+static inline void uuidv7_sort(uint8_t *uuids, size_t n_uuids,
+                               uint8_t *scratch) {
+  // bounds[0..n_runs] delimit the runs
+  size_t bounds[UUIDV7_SORT_MAX_RUNS + 1];
+  size_t n_runs = 1;
+  bounds[0] = 0;
+  for (size_t i = 1; i < n_uuids; i++) {
+    if (uuidv7_sort_less(&uuids[16 * i], &uuids[16 * (i - 1)])) {
+      if (n_runs == UUIDV7_SORT_MAX_RUNS) {
+        uuidv7_sort_radix(uuids, n_uuids, scratch);
+        return;
+      }
+      bounds[n_runs++] = i;
+    }
+  }
+  bounds[n_runs] = n_uuids;
+
+  uint8_t *src = uuids, *dst = scratch;
+  while (n_runs > 1) {
+    size_t n_merged = 0;
+    for (size_t r = 0; r < n_runs; r += 2) {
+      if (r + 1 < n_runs) {
+        uuidv7_sort_merge2(src, bounds[r], bounds[r + 1], bounds[r + 2], dst);
+      } else {
+        memcpy(&dst[16 * bounds[r]], &src[16 * bounds[r]],
+               16 * (bounds[r + 1] - bounds[r]));
+      }
+      bounds[n_merged++] = bounds[r];
+    }
+    bounds[n_merged] = n_uuids;
+    n_runs = n_merged;
+
+    uint8_t *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  if (src != uuids) {
+    memcpy(uuids, src, 16 * n_uuids);
+  }
+}
+
+/** @} */
+
+/**
+ * @name Streaming k-way merge
+ *
+ * @{
+ */
+
+/**
+ * Sorted run of UUIDs that feeds a merger.
+ *
+ * The merger consumes UUIDs from the front of the run by advancing `uuids` and
+ * decrementing `n_uuids`. The caller may replace both to supply the next chunk
+ * of the run once it has been consumed, and sets `finished` when no more UUIDs
+ * will follow. Each chunk must continue the ascending order of the run.
+ */
+typedef struct {
+  /** Next UUID of the run. */
+  const uint8_t *uuids;
+
+  /** Number of UUIDs remaining in the current chunk. */
+  size_t n_uuids;
+
+  /** Non-zero if no more chunks will be supplied. */
+  int finished;
+} uuidv7_merge_run_t;
+
+/**
+ * Merger state, which holds a binary min-heap of the runs that have UUIDs
+ * available.
+ */
+typedef struct {
+  /** Runs to merge. */
+  uuidv7_merge_run_t *runs;
+
+  /** Number of runs. */
+  size_t n_runs;
+
+  /** Indexes of the runs in the heap, ordered by their next UUID. */
+  size_t *heap;
+
+  /** Number of runs in the heap. */
+  size_t n_heap;
+
+  /** Number of runs, from the first, that have been admitted to the heap. */
+  size_t n_admitted;
+
+  /**
+   * Index of the run whose chunk has been consumed up while more UUIDs may
+   * follow, or -1 if none. The merge cannot proceed until the run is supplied.
+   */
+  long starved;
+} uuidv7_merger_t;
+
+/** Returns non-zero if heap entry `i` should come before entry `j`. */
+static inline int uuidv7_merger_before(const uuidv7_merger_t *m, size_t i,
+                                       size_t j) {
+  size_t a = m->heap[i], b = m->heap[j];
+  const uint8_t *x = m->runs[a].uuids, *y = m->runs[b].uuids;
+  // break ties by run index so that the merge is stable across runs
+  return uuidv7_sort_less(x, y) || (!uuidv7_sort_less(y, x) && a < b);
+}
+
+static inline void uuidv7_merger_sift_down(uuidv7_merger_t *m, size_t i) {
+  for (;;) {
+    size_t min = i, left = 2 * i + 1, right = 2 * i + 2;
+    if (left < m->n_heap && uuidv7_merger_before(m, left, min)) {
+      min = left;
+    }
+    if (right < m->n_heap && uuidv7_merger_before(m, right, min)) {
+      min = right;
+    }
+    if (min == i) {
+      return;
+    }
+    size_t tmp = m->heap[i];
+    m->heap[i] = m->heap[min];
+    m->heap[min] = tmp;
+    i = min;
+  }
+}
+
+static inline void uuidv7_merger_push(uuidv7_merger_t *m, size_t run) {
+  size_t i = m->n_heap++;
+  m->heap[i] = run;
+  while (i > 0 && uuidv7_merger_before(m, i, (i - 1) / 2)) {
+    size_t parent = (i - 1) / 2, tmp = m->heap[i];
+    m->heap[i] = m->heap[parent];
+    m->heap[parent] = tmp;
+    i = parent;
+  }
+}
+
+/**
+ * Initializes a merger.
+ *
+ * @param m       Merger to initialize.
+ * @param runs    Array of `n_runs` runs, which must remain valid while the
+ *                merger is used.
+ * @param n_runs  Number of runs.
+ * @param heap    Working area of `n_runs` elements, which must remain valid
+ *                while the merger is used.
+ */
+static inline void uuidv7_merger_init(uuidv7_merger_t *m,
+                                      uuidv7_merge_run_t *runs, size_t n_runs,
+                                      size_t *heap) {
+  m->runs = runs;
+  m->n_runs = n_runs;
+  m->heap = heap;
+  m->n_heap = 0;
+  m->n_admitted = 0;
+  m->starved = -1;
+}
+
+/**
+ * Writes the next UUIDs of the merged sequence.
+ *
+ * The merge cannot proceed past a run whose chunk has been consumed up unless
+ * the run is finished, since the next chunk may hold smaller UUIDs. In that
+ * case, this function stops and stores the index of the run in `m->starved`,
+ * and the caller supplies the next chunk of the run (or marks it finished)
+ * before calling this function again. The same applies to runs whose first
+ * chunk is empty.
+ *
+ * @param m          Merger.
+ * @param uuids_out  Array where at most `max_uuids` 16-byte UUIDs are stored.
+ * @param max_uuids  Capacity of `uuids_out`.
+ * @return           Number of UUIDs written. A value smaller than `max_uuids`
+ *                   means that a run is starved (`m->starved >= 0`) or all
+ *                   runs have been merged (`m->starved < 0`).
+ */
+static inline size_t uuidv7_merger_next(uuidv7_merger_t *m, uint8_t *uuids_out,
+                                        size_t max_uuids) {
+  // (re)admit the starved run and then any runs not yet admitted
+  for (;;) {
+    if (m->starved >= 0) {
+      uuidv7_merge_run_t *run = &m->runs[m->starved];
+      if (run->n_uuids > 0) {
+        uuidv7_merger_push(m, (size_t)m->starved);
+      } else if (!run->finished) {
+        return 0;
+      }
+      m->starved = -1;
+    }
+    if (m->n_admitted == m->n_runs) {
+      break;
+    }
+    m->starved = (long)m->n_admitted++;
+  }
+
+  size_t n = 0;
+  while (n < max_uuids && m->n_heap > 0) {
+    size_t top = m->heap[0];
+    uuidv7_merge_run_t *run = &m->runs[top];
+    memcpy(&uuids_out[16 * n++], run->uuids, 16);
+    run->uuids += 16;
+    if (--run->n_uuids > 0) {
+      uuidv7_merger_sift_down(m, 0);
+      continue;
+    }
+
+    m->heap[0] = m->heap[--m->n_heap];
+    uuidv7_merger_sift_down(m, 0);
+    if (!run->finished) {
+      m->starved = (long)top;
+      return n;
+    }
+  }
+  return n;
+}
+
+/** @} */
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* #ifndef UUIDV7_SORT_H_BAEDKYFQ */
@@ -0,0 +1,709 @@
+/**
+ * @file
+ *
+ * uuidv7_text.h - Compact text encodings of UUIDs for uuidv7.h
+ *
+ * This optional header encodes UUIDs in two representations shorter than the
+ * 36-character 8-4-4-4-12 hexadecimal string:
+ *
+ * - Crockford's Base32 in 26 characters, i.e., the 128 bits preceded by two
+ *   zero bits in digits of `0123456789ABCDEFGHJKMNPQRSTVWXYZ`. The alphabet is
+ *   in ASCII order, so the strings of UUIDv7s sort in the same order as their
+ *   binary representations, as ULIDs do.
+ * - Base64url (RFC 4648, Section 5) in 22 characters without padding, i.e.,
+ *   the 128 bits followed by four zero bits. This is the shortest URL-safe
+ *   form but does not preserve the order.
+ *
+ * Encoders write upper case Base32. Decoders accept exactly the strings the
+ * encoders could produce, except that Base32 letters may be in either case, in
+ * the same manner as `uuidv7_from_string()` accepts hexadecimal digits: they
+ * reject Crockford's optional aliases (`I`, `L`, `O`) and check digits, hyphens
+ * or separators, and the padding bits, so that each UUID has exactly one
+ * representation up to case.
+ *
+ * The bulk functions use SSSE3 instructions if the compiler targets them (e.g.
+ * `-mssse3`), unless `UUIDV7_NO_SIMD` is defined.
+ *
+ * @copyright Licensed under the Apache License, Version 2.0
+ * @see       https://github.com/LiosK/uuidv7-h
+ */
+/*
+ * Copyright 2022 LiosK
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UUIDV7_TEXT_H_BAEDKYFQ
+#define UUIDV7_TEXT_H_BAEDKYFQ
+
+#include "uuidv7.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name Crockford's Base32
+ *
+ * @{
+ */
+
+/**
+ * Decodes a Crockford's Base32 digit.
+ *
+ * @param c  Character to decode. Both upper and lower case are accepted.
+ * @return   Value of the digit (0-31), or `0xff` if `c` is not a digit.
+ */
+static inline uint8_t uuidv7_decode_base32_digit(char c) {
+  // clang-format off
+  static const uint8_t VALUES[128] = {
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+         0,    1,    2,    3,    4,    5,    6,    7,
+         8,    9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff,   10,   11,   12,   13,   14,   15,   16,
+        17, 0xff,   18,   19, 0xff,   20,   21, 0xff,
+        22,   23,   24,   25,   26, 0xff,   27,   28,
+        29,   30,   31, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff,   10,   11,   12,   13,   14,   15,   16,
+        17, 0xff,   18,   19, 0xff,   20,   21, 0xff,
+        22,   23,   24,   25,   26, 0xff,   27,   28,
+        29,   30,   31, 0xff, 0xff, 0xff, 0xff, 0xff,
+  };
+  // clang-format on
+  uint8_t u = (uint8_t)c;
+  return u < 128 ? VALUES[u] : 0xff;
+}
+
+/** Encodes a UUID in words as 26 Base32 digits without a terminator. */
+static inline void uuidv7_words_to_base32(const uuidv7_words_t *words,
+                                          char *out) {
+  static const char DIGITS[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+  // digits 0-12 hold two zero bits and hi >> 1, and digits 13-25 the last bit
+  // of hi and lo
+  uint64_t a = words->hi >> 1, b = words->lo;
+  for (int i = 0; i < 13; i++) {
+    out[i] = DIGITS[(a >> (60 - 5 * i)) & 31];
+  }
+  out[13] = DIGITS[(words->hi & 1) << 4 | b >> 60];
+  for (int i = 0; i < 12; i++) {
+    out[14 + i] = DIGITS[(b >> (55 - 5 * i)) & 31];
+  }
+}
+
+/**
+ * Decodes 26 Base32 digits to a UUID in words.
+ *
+ * @return  Zero on success or non-zero integer if a character is not a digit
+ *          or the value exceeds 128 bits.
+ */
+static inline int uuidv7_words_from_base32(const char *text,
+                                           uuidv7_words_t *words_out) {
+  uint64_t a = 0, b = 0;
+  uint8_t error = 0;
+  for (int i = 0; i < 13; i++) {
+    uint8_t e = uuidv7_decode_base32_digit(text[i]);
+    error |= e;
+    a = (a << 5) | (e & 31);
+  }
+  for (int i = 13; i < 26; i++) {
+    uint8_t e = uuidv7_decode_base32_digit(text[i]);
+    error |= e;
+    b = (b << 5) | (e & 31);
+  }
+  // a and b have 65 bits each, of which the top one has been shifted out; the
+  // first digit must not exceed 7 so that the value fits in 128 bits
+  if ((error & 0xe0) != 0 || uuidv7_decode_base32_digit(text[0]) > 7) {
+    return -1;
+  }
+  words_out->hi = a << 1 | uuidv7_decode_base32_digit(text[13]) >> 4;
+  words_out->lo = b;
+  return 0;
+}
+
+/**
+ * Encodes a UUID in the 26-character Crockford's Base32 representation.
+ *
+ * @param uuid        16-byte byte array representing the UUID to encode.
+ * @param string_out  Character array where the encoded string is stored. Its
+ *                    length must be 27 (26 digits + NUL) or longer.
+ */
+static inline void uuidv7_to_base32(const uint8_t *uuid, char *string_out) {
+  uuidv7_words_t words;
+  uuidv7_words_from_bytes(uuid, &words);
+  uuidv7_words_to_base32(&words, string_out);
+  string_out[26] = '\0';
+}
+
+/**
+ * Decodes the 26-character Crockford's Base32 representation of a UUID.
+ *
+ * @param string    27-byte (26 digits + NUL) character array. Both upper and
+ *                  lower case are accepted.
+ * @param uuid_out  16-byte byte array where the decoded UUID is stored.
+ * @return          Zero on success or non-zero integer on failure.
+ */
+static inline int uuidv7_from_base32(const char *string, uint8_t *uuid_out) {
+  // a holds digits 0-12, i.e., hi >> 1, and b digits 13-25, whose first bit
+  // is shifted out of lo
+  uint64_t a = 0, b = 0;
+  for (int i = 0; i < 26; i++) {
+    // check each digit before reading the next so as not to read past NUL
+    uint8_t e = uuidv7_decode_base32_digit(string[i]);
+    if (e == 0xff || (i == 0 && e > 7)) {
+      return -1; // invalid digit or value exceeding 128 bits
+    }
+    if (i < 13) {
+      a = (a << 5) | e;
+    } else {
+      b = (b << 5) | e;
+    }
+  }
+  if (string[26] != '\0') {
+    return -1; // invalid length
+  }
+  uuidv7_words_t words;
+  words.hi = a << 1 | uuidv7_decode_base32_digit(string[13]) >> 4;
+  words.lo = b;
+  uuidv7_words_to_bytes(&words, uuid_out);
+  return 0;
+}
+
+/**
+ * Encodes an array of UUIDs in the Crockford's Base32 representation.
+ *
+ * @param uuids      Byte array of `16 * n_uuids` bytes representing the UUIDs
+ *                   to encode.
+ * @param n_uuids    Number of UUIDs to encode.
+ * @param text_out   Character array where the encoded strings are stored. Its
+ *                   length must be `26 * n_uuids` or longer without separators
+ *                   or `27 * n_uuids` or longer with separators.
+ * @param separator  Character written after each string, such as `'\0'` or
+ *                   `'\n'`, or a negative value to write no separator.
+ * @return           Number of characters written to `text_out`.
+ */
+static inline size_t uuidv7_to_base32_bulk(const uint8_t *uuids,
+                                           size_t n_uuids, char *text_out,
+                                           int separator) {
+  const size_t stride = separator < 0 ? 26 : 27;
+  size_t i = 0;
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSSE3__)
+  // each 16-bit lane takes the two bytes that hold the five bits of a digit,
+  // moves the digit to the top bits by multiplication, and shifts it down
+  const __m128i shuf0 =
+      _mm_setr_epi8(0, -1, 1, 0, 2, 1, 2, 1, 3, 2, 3, 2, 4, 3, 5, 4);
+  const __m128i shuf1 =
+      _mm_setr_epi8(5, 4, 6, 5, 7, 6, 7, 6, 8, 7, 8, 7, 9, 8, 10, 9);
+  const __m128i shuf2 =
+      _mm_setr_epi8(10, 9, 11, 10, 12, 11, 12, 11, 13, 12, 13, 12, 14, 13, 15,
+                    14);
+  const __m128i shuf3 = _mm_setr_epi8(15, 14, -1, 15, -1, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, -1, -1, -1);
+  const __m128i shifts = _mm_setr_epi16(64, 8, 1, 32, 4, 128, 16, 2);
+  const __m128i digits_lo = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6',
+                                          '7', '8', '9', 'A', 'B', 'C', 'D',
+                                          'E', 'F');
+  const __m128i digits_hi = _mm_setr_epi8('G', 'H', 'J', 'K', 'M', 'N', 'P',
+                                          'Q', 'R', 'S', 'T', 'V', 'W', 'X',
+                                          'Y', 'Z');
+  const __m128i fifteen = _mm_set1_epi8(15);
+  for (; i < n_uuids; i++) {
+    __m128i x = _mm_loadu_si128((const __m128i *)&uuids[16 * i]);
+    __m128i d0 = _mm_srli_epi16(
+        _mm_mullo_epi16(_mm_shuffle_epi8(x, shuf0), shifts), 11);
+    __m128i d1 = _mm_srli_epi16(
+        _mm_mullo_epi16(_mm_shuffle_epi8(x, shuf1), shifts), 11);
+    __m128i d2 = _mm_srli_epi16(
+        _mm_mullo_epi16(_mm_shuffle_epi8(x, shuf2), shifts), 11);
+    __m128i d3 = _mm_srli_epi16(
+        _mm_mullo_epi16(_mm_shuffle_epi8(x, shuf3), shifts), 11);
+    __m128i a = _mm_packus_epi16(d0, d1); // digits 0-15
+    __m128i b = _mm_packus_epi16(d2, d3); // digits 16-25
+    __m128i a_hi = _mm_cmpgt_epi8(a, fifteen);
+    __m128i b_hi = _mm_cmpgt_epi8(b, fifteen);
+    a = _mm_or_si128(_mm_andnot_si128(a_hi, _mm_shuffle_epi8(digits_lo, a)),
+                     _mm_and_si128(a_hi, _mm_shuffle_epi8(digits_hi, a)));
+    b = _mm_or_si128(_mm_andnot_si128(b_hi, _mm_shuffle_epi8(digits_lo, b)),
+                     _mm_and_si128(b_hi, _mm_shuffle_epi8(digits_hi, b)));
+
+    char *out = &text_out[stride * i];
+    int16_t tail = (int16_t)_mm_extract_epi16(b, 4);
+    _mm_storeu_si128((__m128i *)out, a);
+    _mm_storel_epi64((__m128i *)(out + 16), b);
+    memcpy(out + 24, &tail, 2);
+    if (separator >= 0) {
+      out[26] = (char)separator;
+    }
+  }
+#endif
+
+  for (; i < n_uuids; i++) {
+    uuidv7_words_t words;
+    uuidv7_words_from_bytes(&uuids[16 * i], &words);
+    uuidv7_words_to_base32(&words, &text_out[stride * i]);
+    if (separator >= 0) {
+      text_out[stride * i + 26] = (char)separator;
+    }
+  }
+
+  return stride * n_uuids;
+}
+
+/**
+ * Decodes an array of UUIDs in the Crockford's Base32 representation.
+ *
+ * This function reads the strings at a fixed stride, as written by
+ * `uuidv7_to_base32_bulk()`, and validates each of them in the same manner as
+ * `uuidv7_from_base32()`, followed by the separator.
+ *
+ * @param text       Character array of `26 * n_uuids` characters without
+ *                   separators or `27 * n_uuids` characters with separators.
+ * @param n_uuids    Number of UUIDs to decode.
+ * @param separator  Character expected after each string, including the last
+ *                   one, or a negative value to expect no separator.
+ * @param uuids_out  Byte array of `16 * n_uuids` bytes where the decoded UUIDs
+ *                   are stored. The contents for invalid strings are
+ *                   unspecified.
+ * @param failed_out Byte array of `n_uuids` bytes where `1` is stored for each
+ *                   invalid string and `0` for each valid one. This may be
+ *                   NULL.
+ * @return           Number of invalid strings.
+ */
+static inline size_t uuidv7_from_base32_bulk(const char *text, size_t n_uuids,
+                                             int separator, uint8_t *uuids_out,
+                                             uint8_t *failed_out) {
+  const size_t stride = separator < 0 ? 26 : 27;
+  size_t n_failed = 0;
+  size_t i = 0;
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSSE3__)
+  // digits 0-15 and 10-25 are decoded from two overlapping loads; the first
+  // load is then shifted so that each 64-bit lane holds 8 digits (40 bits)
+  // aligned with whole bytes: two zero bits and byte 0, bytes 1-5, 6-10, and
+  // 11-15
+  const __m128i ascii_0 = _mm_set1_epi8('0' - 1);
+  const __m128i ascii_9 = _mm_set1_epi8('9' + 1);
+  const __m128i ascii_a = _mm_set1_epi8('a' - 1);
+  const __m128i ascii_z = _mm_set1_epi8('z' + 1);
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  const __m128i letters_lo = _mm_setr_epi8(10, 11, 12, 13, 14, 15, 16, 17, -1,
+                                           18, 19, -1, 20, 21, -1, 22);
+  const __m128i letters_hi = _mm_setr_epi8(23, 24, 25, 26, -1, 27, 28, 29, 30,
+                                           31, -1, -1, -1, -1, -1, -1);
+  const __m128i fifteen = _mm_set1_epi8(15);
+  const __m128i shift_a = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 0, 1, 2, 3, 4,
+                                        5, 6, 7, 8, 9);
+  const __m128i pairs = _mm_set1_epi16(0x0120); // v0 * 32 + v1
+  const __m128i quads = _mm_set1_epi32(0x00010400); // p0 * 1024 + p1
+  const __m128i bytes_a = _mm_setr_epi8(0, 12, 11, 10, 9, 8, -1, -1, -1, -1,
+                                        -1, -1, -1, -1, -1, -1);
+  const __m128i bytes_b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 4, 3, 2, 1, 0,
+                                        12, 11, 10, 9, 8);
+  for (; i < n_uuids; i++) {
+    const char *in = &text[stride * i];
+    __m128i v[2];
+    int valid = 1;
+    for (int k = 0; k < 2; k++) {
+      __m128i c = _mm_loadu_si128((const __m128i *)(in + 10 * k));
+      __m128i l = _mm_or_si128(c, case_bit);
+      __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(c, ascii_0),
+                                       _mm_cmplt_epi8(c, ascii_9));
+      __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(l, ascii_a),
+                                        _mm_cmplt_epi8(l, ascii_z));
+      __m128i index = _mm_sub_epi8(l, _mm_set1_epi8('a'));
+      __m128i is_hi = _mm_cmpgt_epi8(index, fifteen);
+      __m128i letter = _mm_or_si128(
+          _mm_andnot_si128(is_hi, _mm_shuffle_epi8(letters_lo, index)),
+          _mm_and_si128(is_hi, _mm_shuffle_epi8(letters_hi, index)));
+      // excluded letters map to 0xff, which fails the signed comparison
+      is_letter = _mm_and_si128(
+          is_letter, _mm_cmpgt_epi8(letter, _mm_set1_epi8(-1)));
+      valid &= _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) == 0xffff;
+      v[k] = _mm_or_si128(
+          _mm_and_si128(is_digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+          _mm_and_si128(is_letter, letter));
+    }
+    valid &= (uint8_t)(in[0] - '0') < 8; // at most 128 bits
+    valid &= separator < 0 || in[26] == (char)separator;
+
+    __m128i a = _mm_shuffle_epi8(v[0], shift_a);
+    a = _mm_madd_epi16(_mm_maddubs_epi16(a, pairs), quads);
+    a = _mm_or_si128(_mm_slli_epi64(a, 20), _mm_srli_epi64(a, 32));
+    __m128i b = _mm_madd_epi16(_mm_maddubs_epi16(v[1], pairs), quads);
+    b = _mm_or_si128(_mm_slli_epi64(b, 20), _mm_srli_epi64(b, 32));
+    _mm_storeu_si128((__m128i *)&uuids_out[16 * i],
+                     _mm_or_si128(_mm_shuffle_epi8(a, bytes_a),
+                                  _mm_shuffle_epi8(b, bytes_b)));
+
+    n_failed += !valid;
+    if (failed_out != NULL) {
+      failed_out[i] = !valid;
+    }
+  }
+#endif
+
+  for (; i < n_uuids; i++) {
+    // all 26 characters are readable, so decode them without early exits
+    const char *in = &text[stride * i];
+    uuidv7_words_t words = {0, 0};
+    int valid = uuidv7_words_from_base32(in, &words) == 0;
+    valid &= separator < 0 || in[26] == (char)separator;
+    uuidv7_words_to_bytes(&words, &uuids_out[16 * i]);
+
+    n_failed += !valid;
+    if (failed_out != NULL) {
+      failed_out[i] = !valid;
+    }
+  }
+
+  return n_failed;
+}
+
+/** @} */
+
+/**
+ * @name Base64url
+ *
+ * @{
+ */
+
+/**
+ * Decodes a Base64url digit.
+ *
+ * @param c  Character to decode.
+ * @return   Value of the digit (0-63), or `0xff` if `c` is not a digit.
+ */
+static inline uint8_t uuidv7_decode_base64url_digit(char c) {
+  // clang-format off
+  static const uint8_t VALUES[128] = {
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff,   62, 0xff, 0xff,
+        52,   53,   54,   55,   56,   57,   58,   59,
+        60,   61, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff,    0,    1,    2,    3,    4,    5,    6,
+         7,    8,    9,   10,   11,   12,   13,   14,
+        15,   16,   17,   18,   19,   20,   21,   22,
+        23,   24,   25, 0xff, 0xff, 0xff, 0xff,   63,
+      0xff,   26,   27,   28,   29,   30,   31,   32,
+        33,   34,   35,   36,   37,   38,   39,   40,
+        41,   42,   43,   44,   45,   46,   47,   48,
+        49,   50,   51, 0xff, 0xff, 0xff, 0xff, 0xff,
+  };
+  // clang-format on
+  uint8_t u = (uint8_t)c;
+  return u < 128 ? VALUES[u] : 0xff;
+}
+
+/** Encodes a UUID in words as 22 Base64url digits without a terminator. */
+static inline void uuidv7_words_to_base64url(const uuidv7_words_t *words,
+                                             char *out) {
+  static const char DIGITS[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  // digits 0-9 hold the top 60 bits of hi, digit 10 straddles the words, and
+  // digits 11-21 hold lo followed by four zero bits
+  uint64_t hi = words->hi, lo = words->lo;
+  for (int i = 0; i < 10; i++) {
+    out[i] = DIGITS[(hi >> (58 - 6 * i)) & 63];
+  }
+  out[10] = DIGITS[(hi & 15) << 2 | lo >> 62];
+  for (int i = 0; i < 10; i++) {
+    out[11 + i] = DIGITS[(lo >> (56 - 6 * i)) & 63];
+  }
+  out[21] = DIGITS[(lo & 3) << 4];
+}
+
+/**
+ * Decodes 22 Base64url digits to a UUID in words.
+ *
+ * @return  Zero on success or non-zero integer if a character is not a digit
+ *          or the four padding bits are not zero.
+ */
+static inline int uuidv7_words_from_base64url(const char *text,
+                                              uuidv7_words_t *words_out) {
+  uint64_t hi = 0, lo = 0;
+  uint8_t error = 0;
+  for (int i = 0; i < 10; i++) {
+    uint8_t e = uuidv7_decode_base64url_digit(text[i]);
+    error |= e;
+    hi = (hi << 6) | (e & 63);
+  }
+  uint8_t mid = uuidv7_decode_base64url_digit(text[10]);
+  for (int i = 11; i < 21; i++) {
+    uint8_t e = uuidv7_decode_base64url_digit(text[i]);
+    error |= e;
+    lo = (lo << 6) | (e & 63);
+  }
+  uint8_t last = uuidv7_decode_base64url_digit(text[21]);
+  error |= mid | last;
+  if ((error & 0xc0) != 0 || (last & 15) != 0) {
+    return -1;
+  }
+  words_out->hi = hi << 4 | mid >> 2;
+  words_out->lo = (uint64_t)(mid & 3) << 62 | lo << 2 | last >> 4;
+  return 0;
+}
+
+/**
+ * Encodes a UUID in the 22-character Base64url representation.
+ *
+ * @param uuid        16-byte byte array representing the UUID to encode.
+ * @param string_out  Character array where the encoded string is stored. Its
+ *                    length must be 23 (22 digits + NUL) or longer.
+ */
+static inline void uuidv7_to_base64url(const uint8_t *uuid,
+                                       char *string_out) {
+  uuidv7_words_t words;
+  uuidv7_words_from_bytes(uuid, &words);
+  uuidv7_words_to_base64url(&words, string_out);
+  string_out[22] = '\0';
+}
+
+/**
+ * Decodes the 22-character Base64url representation of a UUID.
+ *
+ * @param string    23-byte (22 digits + NUL) character array.
+ * @param uuid_out  16-byte byte array where the decoded UUID is stored.
+ * @return          Zero on success or non-zero integer on failure.
+ */
+static inline int uuidv7_from_base64url(const char *string,
+                                        uint8_t *uuid_out) {
+  // hi holds digits 0-9 and lo digits 11-20, while digit 10 straddles them
+  uint64_t hi = 0, lo = 0;
+  uint8_t mid = 0;
+  for (int i = 0; i < 21; i++) {
+    // check each digit before reading the next so as not to read past NUL
+    uint8_t e = uuidv7_decode_base64url_digit(string[i]);
+    if (e == 0xff) {
+      return -1; // invalid digit
+    }
+    if (i < 10) {
+      hi = (hi << 6) | e;
+    } else if (i == 10) {
+      mid = e;
+    } else {
+      lo = (lo << 6) | e;
+    }
+  }
+  uint8_t last = uuidv7_decode_base64url_digit(string[21]);
+  if (last == 0xff || (last & 15) != 0) {
+    return -1; // invalid digit or non-zero padding bits
+  }
+  if (string[22] != '\0') {
+    return -1; // invalid length
+  }
+  uuidv7_words_t words;
+  words.hi = hi << 4 | mid >> 2;
+  words.lo = (uint64_t)(mid & 3) << 62 | lo << 2 | last >> 4;
+  uuidv7_words_to_bytes(&words, uuid_out);
+  return 0;
+}
+
+/**
+ * Encodes an array of UUIDs in the Base64url representation.
+ *
+ * @param uuids      Byte array of `16 * n_uuids` bytes representing the UUIDs
+ *                   to encode.
+ * @param n_uuids    Number of UUIDs to encode.
+ * @param text_out   Character array where the encoded strings are stored. Its
+ *                   length must be `22 * n_uuids` or longer without separators
+ *                   or `23 * n_uuids` or longer with separators.
+ * @param separator  Character written after each string, such as `'\0'` or
+ *                   `'\n'`, or a negative value to write no separator.
+ * @return           Number of characters written to `text_out`.
+ */
+static inline size_t uuidv7_to_base64url_bulk(const uint8_t *uuids,
+                                              size_t n_uuids, char *text_out,
+                                              int separator) {
+  const size_t stride = separator < 0 ? 22 : 23;
+  size_t i = 0;
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSSE3__)
+  // bytes 0-11 and 12-15 are split into 6-bit digits with multiplications
+  // (W. Muła's method) and then mapped to ASCII by the offset of each range
+  const __m128i shuf_a = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10,
+                                       9, 11, 10);
+  const __m128i shuf_b = _mm_setr_epi8(13, 12, 14, 13, -1, 15, -1, -1, -1, -1,
+                                       -1, -1, -1, -1, -1, -1);
+  const __m128i mask_hi = _mm_set1_epi32(0x0fc0fc00);
+  const __m128i mul_hi = _mm_set1_epi32(0x04000040);
+  const __m128i mask_lo = _mm_set1_epi32(0x003f03f0);
+  const __m128i mul_lo = _mm_set1_epi32(0x01000010);
+  const __m128i fifty_one = _mm_set1_epi8(51);
+  const __m128i twenty_six = _mm_set1_epi8(26);
+  const __m128i thirteen = _mm_set1_epi8(13);
+  // offsets of 'a' - 26, '0' - 52 (x 10), '-' - 62, '_' - 63, and 'A'
+  const __m128i offsets = _mm_setr_epi8(71, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+                                        -4, -17, 32, 65, 0, 0);
+  for (; i < n_uuids; i++) {
+    __m128i x = _mm_loadu_si128((const __m128i *)&uuids[16 * i]);
+    __m128i d[2];
+    d[0] = _mm_shuffle_epi8(x, shuf_a);
+    d[1] = _mm_shuffle_epi8(x, shuf_b);
+    for (int k = 0; k < 2; k++) {
+      __m128i t = _mm_or_si128(
+          _mm_mulhi_epu16(_mm_and_si128(d[k], mask_hi), mul_hi),
+          _mm_mullo_epi16(_mm_and_si128(d[k], mask_lo), mul_lo));
+      __m128i range = _mm_or_si128(
+          _mm_subs_epu8(t, fifty_one),
+          _mm_and_si128(_mm_cmpgt_epi8(twenty_six, t), thirteen));
+      d[k] = _mm_add_epi8(t, _mm_shuffle_epi8(offsets, range));
+    }
+
+    char *out = &text_out[stride * i];
+    int32_t tail = _mm_cvtsi128_si32(d[1]);
+    int16_t tail2 = (int16_t)_mm_extract_epi16(d[1], 2);
+    _mm_storeu_si128((__m128i *)out, d[0]);
+    memcpy(out + 16, &tail, 4);
+    memcpy(out + 20, &tail2, 2);
+    if (separator >= 0) {
+      out[22] = (char)separator;
+    }
+  }
+#endif
+
+  for (; i < n_uuids; i++) {
+    uuidv7_words_t words;
+    uuidv7_words_from_bytes(&uuids[16 * i], &words);
+    uuidv7_words_to_base64url(&words, &text_out[stride * i]);
+    if (separator >= 0) {
+      text_out[stride * i + 22] = (char)separator;
+    }
+  }
+
+  return stride * n_uuids;
+}
+
+/**
+ * Decodes an array of UUIDs in the Base64url representation.
+ *
+ * This function reads the strings at a fixed stride, as written by
+ * `uuidv7_to_base64url_bulk()`, and validates each of them in the same manner
+ * as `uuidv7_from_base64url()`, followed by the separator.
+ *
+ * @param text       Character array of `22 * n_uuids` characters without
+ *                   separators or `23 * n_uuids` characters with separators.
+ * @param n_uuids    Number of UUIDs to decode.
+ * @param separator  Character expected after each string, including the last
+ *                   one, or a negative value to expect no separator.
+ * @param uuids_out  Byte array of `16 * n_uuids` bytes where the decoded UUIDs
+ *                   are stored. The contents for invalid strings are
+ *                   unspecified.
+ * @param failed_out Byte array of `n_uuids` bytes where `1` is stored for each
+ *                   invalid string and `0` for each valid one. This may be
+ *                   NULL.
+ * @return           Number of invalid strings.
+ */
+static inline size_t uuidv7_from_base64url_bulk(const char *text,
+                                                size_t n_uuids, int separator,
+                                                uint8_t *uuids_out,
+                                                uint8_t *failed_out) {
+  const size_t stride = separator < 0 ? 22 : 23;
+  size_t n_failed = 0;
+  size_t i = 0;
+
+#if !defined(UUIDV7_NO_SIMD) && defined(__SSSE3__)
+  // digits 0-15 and 6-21 are decoded from two overlapping loads; the second
+  // load is shifted so that digits 16-21 start a group of four, and each group
+  // of four 6-bit digits is packed into three bytes by multiply-adds
+  const __m128i ascii_0 = _mm_set1_epi8('0' - 1);
+  const __m128i ascii_9 = _mm_set1_epi8('9' + 1);
+  const __m128i ascii_upper_a = _mm_set1_epi8('A' - 1);
+  const __m128i ascii_upper_z = _mm_set1_epi8('Z' + 1);
+  const __m128i ascii_a = _mm_set1_epi8('a' - 1);
+  const __m128i ascii_z = _mm_set1_epi8('z' + 1);
+  const __m128i hyphen = _mm_set1_epi8('-');
+  const __m128i underscore = _mm_set1_epi8('_');
+  const __m128i pairs = _mm_set1_epi32(0x01400140); // v0 * 64 + v1
+  const __m128i quads = _mm_set1_epi32(0x00011000); // p0 * 4096 + p1
+  const __m128i shift_b = _mm_setr_epi8(10, 11, 12, 13, 14, 15, -1, -1, -1, -1,
+                                        -1, -1, -1, -1, -1, -1);
+  const __m128i bytes_a = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                        -1, -1, -1, -1);
+  const __m128i bytes_b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                        -1, -1, 2, 1, 0, 6);
+  for (; i < n_uuids; i++) {
+    const char *in = &text[stride * i];
+    __m128i v[2];
+    int valid = 1;
+    for (int k = 0; k < 2; k++) {
+      __m128i c = _mm_loadu_si128((const __m128i *)(in + 6 * k));
+      __m128i is_upper = _mm_and_si128(_mm_cmpgt_epi8(c, ascii_upper_a),
+                                       _mm_cmplt_epi8(c, ascii_upper_z));
+      __m128i is_lower = _mm_and_si128(_mm_cmpgt_epi8(c, ascii_a),
+                                       _mm_cmplt_epi8(c, ascii_z));
+      __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(c, ascii_0),
+                                       _mm_cmplt_epi8(c, ascii_9));
+      __m128i is_hyphen = _mm_cmpeq_epi8(c, hyphen);
+      __m128i is_underscore = _mm_cmpeq_epi8(c, underscore);
+      valid &= _mm_movemask_epi8(_mm_or_si128(
+                   _mm_or_si128(_mm_or_si128(is_upper, is_lower), is_digit),
+                   _mm_or_si128(is_hyphen, is_underscore))) == 0xffff;
+      __m128i offset = _mm_or_si128(
+          _mm_or_si128(_mm_and_si128(is_upper, _mm_set1_epi8(-65)),
+                       _mm_and_si128(is_lower, _mm_set1_epi8(-71))),
+          _mm_or_si128(_mm_and_si128(is_digit, _mm_set1_epi8(4)),
+                       _mm_or_si128(_mm_and_si128(is_hyphen, _mm_set1_epi8(17)),
+                                    _mm_and_si128(is_underscore,
+                                                  _mm_set1_epi8(-32)))));
+      v[k] = _mm_add_epi8(c, offset);
+    }
+    // the last digit holds two bits followed by four zero bits
+    valid &= (uuidv7_decode_base64url_digit(in[21]) & 15) == 0;
+    valid &= separator < 0 || in[22] == (char)separator;
+
+    __m128i a = _mm_madd_epi16(_mm_maddubs_epi16(v[0], pairs), quads);
+    __m128i b = _mm_shuffle_epi8(v[1], shift_b);
+    b = _mm_madd_epi16(_mm_maddubs_epi16(b, pairs), quads);
+    _mm_storeu_si128((__m128i *)&uuids_out[16 * i],
+                     _mm_or_si128(_mm_shuffle_epi8(a, bytes_a),
+                                  _mm_shuffle_epi8(b, bytes_b)));
+
+    n_failed += !valid;
+    if (failed_out != NULL) {
+      failed_out[i] = !valid;
+    }
+  }
+#endif
+
+  for (; i < n_uuids; i++) {
+    // all 22 characters are readable, so decode them without early exits
+    const char *in = &text[stride * i];
+    uuidv7_words_t words = {0, 0};
+    int valid = uuidv7_words_from_base64url(in, &words) == 0;
+    valid &= separator < 0 || in[22] == (char)separator;
+    uuidv7_words_to_bytes(&words, &uuids_out[16 * i]);
+
+    n_failed += !valid;
+    if (failed_out != NULL) {
+      failed_out[i] = !valid;
+    }
+  }
+
+  return n_failed;
+}
+
+/** @} */
+
+#ifdef __cplusplus
+} /* extern "C" { */
+#endif
+
+#endif /* #ifndef UUIDV7_TEXT_H_BAEDKYFQ */